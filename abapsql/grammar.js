@@ -0,0 +1,35 @@
+/**
+ * @file ABAP SQL grammar for tree-sitter, parses the `sql_body` of a SELECT
+ * statement in an ABAP parser generated with TREE_SITTER_ABAP_COARSE_SQL.
+ * @license MIT
+ */
+
+// The rules are those of the full grammar, which must not be coarse itself.
+delete process.env.TREE_SITTER_ABAP_COARSE_SQL;
+const abap = require("../grammar.js");
+
+// Not reachable from a SELECT, so not part of this parser.
+const STATEMENT_SUPERTYPES = ["simple_statement", "reserved_statement"];
+
+/// <reference types="tree-sitter-cli/dsl" />
+// @ts-nocheck
+module.exports = grammar(abap, {
+  name: "abapsql",
+
+  supertypes: ($, original) =>
+    original.filter(rule => !STATEMENT_SUPERTYPES.includes(rule.name)),
+
+  rules: {
+    // What follows the SELECT keyword up to the period, the same as in
+    // `__select_statement_prefix` of grammar/abapsql/select_statement.js.
+    source: $ => {
+      // Required for aliasing rules in the generators.
+      gen.state.grammarProxy = $;
+
+      return seq(
+        $.__mainquery_clause,
+        choice($.select_into_spec, $.select_appending_spec),
+      );
+    },
+  },
+});
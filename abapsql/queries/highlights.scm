@@ -0,0 +1,50 @@
+(string_literal) @string
+(string_template) @string
+(number) @number
+
+; Keywords are aliased to anonymous snake_cased literal representations.
+; This alone would not allow us to query them. For that reason, they are
+; tagged with a keyword field. That gives us more control, as some keywords 
+; can overlap with other tokens. See the table_type capture for instance.
+; Bonus points for not having to maintain a huge alternation of literals :)
+(_ keyword:  _ @keyword)
+
+; This is purely for better partial highlighting efforts during invalid
+; state of the code and not to be seen semantically correct.
+(ERROR _ @keyword
+  (#match? @keyword "^[a-zA-Z_][a-zA-Z0-9_]*$"))
+(ERROR (identifier) @variable)
+
+[
+   (inline_comment)
+   (line_comment)
+   (multi_line_comment)
+] @comment
+
+[
+   (pragma)
+   (pseudo_comment)
+] @keyword.directive
+
+
+; ABAP SQL, the same as in queries/highlights.scm
+(from_database_source_spec (identifier) @type )
+(sql_function_call name: (identifier) @function.call)
+(sql_cast_type name: (identifier) @type.builtin)
+(sql_column_spec/identifier) @variable.member
+(qualified_field
+  source: (identifier) @type
+  target: (identifier)? @variable.member
+)
+(sql_path_element
+  source: (identifier)? @type
+  component: (identifier) @variable.member)
+(sql_path_association
+  "\\" @operator
+  association: (identifier) @type)
+(sql_source_alias_spec alias: (identifier) @type)
+(sql_field_alias_spec alias: (identifier) @variable.member)
+(view_argument name: (identifier) @variable.parameter)
+(sql_host_variable "@" @punctuation.special)
+(sql_host_expression "@" @punctuation.special)
+(sql_operand_list (identifier) @variable.member)
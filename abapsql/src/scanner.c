@@ -0,0 +1,21 @@
+// The scanner of the ABAP grammar, the abapsql grammar shares its externals.
+#define tree_sitter_abap_external_scanner_create                              \
+    tree_sitter_abapsql_external_scanner_create
+#define tree_sitter_abap_external_scanner_destroy                             \
+    tree_sitter_abapsql_external_scanner_destroy
+#define tree_sitter_abap_external_scanner_scan                                \
+    tree_sitter_abapsql_external_scanner_scan
+#define tree_sitter_abap_external_scanner_serialize                           \
+    tree_sitter_abapsql_external_scanner_serialize
+#define tree_sitter_abap_external_scanner_deserialize                         \
+    tree_sitter_abapsql_external_scanner_deserialize
+
+// Only with TREE_SITTER_ABAP_SCANNER_STATS, the counters are its own.
+#define tree_sitter_abap_scanner_stats tree_sitter_abapsql_scanner_stats
+#define tree_sitter_abap_scanner_stats_reset                                  \
+    tree_sitter_abapsql_scanner_stats_reset
+#define tree_sitter_abap_scanner_stats_add tree_sitter_abapsql_scanner_stats_add
+#define tree_sitter_abap_scanner_stats_write_json                             \
+    tree_sitter_abapsql_scanner_stats_write_json
+
+#include "../../src/scanner.c"
@@ -0,0 +1,239 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap-bulk.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * Bulk parse scaling benchmark.
+ *
+ * Runs `tree_sitter_abap_bulk_parse` over the same files with a growing
+ * number of threads and reports the wall time, the throughput and the
+ * speedup and efficiency against one thread for each, the scaling curve of
+ * the bulk parser.
+ *
+ * Without paths a temporary directory of generated files is used. Their
+ * sizes vary from a quarter to twice the requested size, so that the
+ * work stealing has imbalance to even out as it has in real repositories.
+ */
+
+typedef Array(uint32_t) ThreadList;
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-bulk [options] [path...]\n"
+            "\n"
+            "Parses the given directories, or generated files, with 1, 2, "
+            "4, ...\n"
+            "threads up to the number of cpus and prints the scaling as "
+            "JSON.\n"
+            "\n"
+            "  --threads LIST      comma separated thread counts\n"
+            "  --files N           generated files (default 2000)\n"
+            "  --file-size SPEC    average generated size (default 16k)\n"
+            "  --kind KIND         synthetic kind of the files (default "
+            "report)\n"
+            "  --repeat N          runs per thread count, the fastest counts\n"
+            "                      (default 3)\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static void parse_threads(ThreadList* threads, const char* list)
+{
+    const char* c = list;
+    while (*c) {
+        char* end;
+        unsigned long value = strtoul(c, &end, 10);
+        if (end == c) {
+            break;
+        }
+        if (value > 0) {
+            array_push(threads, (uint32_t)value);
+        }
+        c = *end == ',' ? end + 1 : end;
+    }
+}
+
+static void default_threads(ThreadList* threads)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max = cpus > 0 ? (uint32_t)cpus : 1;
+    for (uint32_t count = 1; count < max; count *= 2) {
+        array_push(threads, count);
+    }
+    array_push(threads, max);
+}
+
+/** Writes the generated files, returns the directory or NULL. */
+static char* generate_files(uint32_t files, const char* size, const char* kind)
+{
+    const char* tmp = getenv("TMPDIR");
+    BenchBuffer path = array_new();
+    bench_buffer_appendf(&path, "%s/tree-sitter-abap-bulk.XXXXXX",
+                         tmp ? tmp : "/tmp");
+    array_push(&path, '\0');
+    if (!mkdtemp(path.contents)) {
+        array_delete(&path);
+        return NULL;
+    }
+
+    char* amount = NULL;
+    unsigned long long base = strtoull(size, &amount, 10);
+    BenchBuffer source = array_new();
+    BenchBuffer spec = array_new();
+    for (uint32_t i = 0; i < files; i++) {
+        // a quarter to twice the base size, spread over the file list
+        array_clear(&spec);
+        bench_buffer_appendf(&spec, "%llu%s", base * (1 + (i * 7919u) % 8) / 4,
+                             amount);
+        array_push(&spec, '\0');
+        array_clear(&source);
+        if (!bench_synthesize(kind, spec.contents, &source)) {
+            fprintf(stderr, "unknown synthetic kind: %s\n", kind);
+            break;
+        }
+
+        BenchBuffer file = array_new();
+        bench_buffer_appendf(&file, "%s/z_bulk_%05u.prog.abap", path.contents,
+                             i);
+        array_push(&file, '\0');
+        FILE* out = fopen(file.contents, "wb");
+        if (out) {
+            fwrite(source.contents, 1, source.size, out);
+            fclose(out);
+        }
+        array_delete(&file);
+    }
+    array_delete(&source);
+    array_delete(&spec);
+    return path.contents;
+}
+
+static void remove_files(const char* directory, uint32_t files)
+{
+    BenchBuffer file = array_new();
+    for (uint32_t i = 0; i < files; i++) {
+        array_clear(&file);
+        bench_buffer_appendf(&file, "%s/z_bulk_%05u.prog.abap", directory, i);
+        array_push(&file, '\0');
+        unlink(file.contents);
+    }
+    array_delete(&file);
+    rmdir(directory);
+}
+
+int main(int argc, char** argv)
+{
+    ThreadList threads = array_new();
+    uint32_t files = 2000;
+    const char* file_size = "16k";
+    const char* kind = "report";
+    uint32_t repeat = 3;
+    const char* output_path = NULL;
+    const char** paths = calloc((size_t)argc, sizeof(char*));
+    uint32_t path_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            parse_threads(&threads, argv[++i]);
+        } else if (strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            files = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--file-size") == 0 && i + 1 < argc) {
+            file_size = argv[++i];
+        } else if (strcmp(argv[i], "--kind") == 0 && i + 1 < argc) {
+            kind = argv[++i];
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            paths[path_count++] = argv[i];
+        }
+    }
+    if (threads.size == 0) {
+        default_threads(&threads);
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    char* generated = NULL;
+    if (path_count == 0) {
+        generated = generate_files(files, file_size, kind);
+        if (!generated) {
+            fprintf(stderr, "failed to create a temporary directory\n");
+            return 1;
+        }
+        paths[path_count++] = generated;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    // One untimed run with the most threads reads the files into the page
+    // cache, so the first timed thread count does not pay for the disk.
+    TSAbapBulkOptions options = {.threads = *array_back(&threads)};
+    TSAbapBulkSummary summary;
+    bool ok = tree_sitter_abap_bulk_parse(paths, path_count, &options,
+                                          &summary);
+
+    fprintf(out, "{\n  \"files\": %u,\n", summary.files);
+    fprintf(out, "  \"bytes\": %llu,\n", (unsigned long long)summary.bytes);
+    fprintf(out, "  \"cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(out, "  \"runs\": [");
+
+    uint64_t single_ns = 0;
+    for (uint32_t t = 0; ok && t < threads.size; t++) {
+        options.threads = threads.contents[t];
+        uint64_t best_ns = UINT64_MAX;
+        uint32_t stolen = 0;
+        for (uint32_t run = 0; run < repeat && ok; run++) {
+            ok = tree_sitter_abap_bulk_parse(paths, path_count, &options,
+                                             &summary);
+            if (summary.wall_ns < best_ns) {
+                best_ns = summary.wall_ns;
+                stolen = summary.stolen;
+            }
+        }
+        if (t == 0) {
+            single_ns = best_ns * threads.contents[0];
+        }
+
+        double speedup = best_ns ? (double)single_ns / best_ns : 0.0;
+        fprintf(out,
+                "%s\n    {\"threads\": %u, \"wall_ns\": %llu, "
+                "\"mb_per_s\": %.3f, \"speedup\": %.3f, "
+                "\"efficiency\": %.3f, \"stolen\": %u}",
+                t ? "," : "", options.threads, (unsigned long long)best_ns,
+                best_ns ? summary.bytes / (1024.0 * 1024.0) / (best_ns / 1e9)
+                        : 0.0,
+                speedup, speedup / options.threads, stolen);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    if (generated) {
+        remove_files(generated, files);
+        free(generated);
+    }
+    array_delete(&threads);
+    free(paths);
+    return ok ? 0 : 1;
+}
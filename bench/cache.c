@@ -0,0 +1,352 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap-bulk.h"
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Parse result cache benchmark.
+ *
+ * Replays two snapshots of a corpus, e.g. two nightly checkouts, through
+ * `tree_sitter_abap_bulk_parse`: the old one with an empty cache, which
+ * parses and stores every file, then the new one with the cache that run
+ * left behind. Both are compared against runs without a cache, the speedup
+ * is that of the new snapshot.
+ *
+ * Without paths two temporary directories of generated files are used, the
+ * second a copy of the first with a fraction of the files changed.
+ */
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-cache [options] [OLD NEW]\n"
+            "\n"
+            "Parses the snapshot OLD into an empty cache and then NEW with "
+            "that\n"
+            "cache, or two generated snapshots, and prints JSON.\n"
+            "\n"
+            "  --files N           generated files (default 2000)\n"
+            "  --file-size SPEC    average generated size (default 16k)\n"
+            "  --kind KIND         synthetic kind of the files (default "
+            "report)\n"
+            "  --changed FRACTION  generated files changed in NEW (default "
+            "0.05)\n"
+            "  --threads N         worker threads (default: one per cpu)\n"
+            "  --query FILE        also cache the captures of the query\n"
+            "  --cache-size BYTES  size limit of the cache (default: none)\n"
+            "  --repeat N          runs of each, the fastest counts "
+            "(default 3)\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static char* make_temporary_directory(const char* name)
+{
+    const char* tmp = getenv("TMPDIR");
+    BenchBuffer path = array_new();
+    bench_buffer_appendf(&path, "%s/tree-sitter-abap-%s.XXXXXX",
+                         tmp ? tmp : "/tmp", name);
+    array_push(&path, '\0');
+    if (!mkdtemp(path.contents)) {
+        array_delete(&path);
+        return NULL;
+    }
+    return path.contents;
+}
+
+static void remove_tree(const char* path, bool keep_root)
+{
+    DIR* directory = opendir(path);
+    struct dirent* entry;
+    BenchBuffer child = array_new();
+    while (directory && (entry = readdir(directory)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 ||
+            strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        array_clear(&child);
+        bench_buffer_appendf(&child, "%s/%s", path, entry->d_name);
+        array_push(&child, '\0');
+        struct stat info;
+        if (lstat(child.contents, &info) == 0 && S_ISDIR(info.st_mode)) {
+            remove_tree(child.contents, false);
+        } else {
+            unlink(child.contents);
+        }
+    }
+    if (directory) {
+        closedir(directory);
+    }
+    array_delete(&child);
+    if (!keep_root) {
+        rmdir(path);
+    }
+}
+
+static uint64_t tree_size(const char* path)
+{
+    DIR* directory = opendir(path);
+    struct dirent* entry;
+    BenchBuffer child = array_new();
+    uint64_t size = 0;
+    while (directory && (entry = readdir(directory)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 ||
+            strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        array_clear(&child);
+        bench_buffer_appendf(&child, "%s/%s", path, entry->d_name);
+        array_push(&child, '\0');
+        struct stat info;
+        if (lstat(child.contents, &info) != 0) {
+            continue;
+        }
+        size += S_ISDIR(info.st_mode) ? tree_size(child.contents)
+                                      : (uint64_t)info.st_size;
+    }
+    if (directory) {
+        closedir(directory);
+    }
+    array_delete(&child);
+    return size;
+}
+
+/**
+ * Writes both generated snapshots. A changed file has a comment line added
+ * in front, which is enough for its key to change.
+ */
+static bool generate_snapshots(const char* old_directory,
+                               const char* new_directory, uint32_t files,
+                               const char* size, const char* kind,
+                               double changed, uint32_t* changed_files)
+{
+    char* amount = NULL;
+    unsigned long long base = strtoull(size, &amount, 10);
+    BenchBuffer source = array_new();
+    BenchBuffer spec = array_new();
+    BenchBuffer file = array_new();
+    bool ok = true;
+    *changed_files = 0;
+
+    for (uint32_t i = 0; ok && i < files; i++) {
+        // a quarter to twice the base size, spread over the file list
+        array_clear(&spec);
+        bench_buffer_appendf(&spec, "%llu%s", base * (1 + (i * 7919u) % 8) / 4,
+                             amount);
+        array_push(&spec, '\0');
+        array_clear(&source);
+        bench_buffer_append(&source, "* changed in the new snapshot\n");
+        uint32_t prefix = source.size;
+        if (!bench_synthesize(kind, spec.contents, &source)) {
+            fprintf(stderr, "unknown synthetic kind: %s\n", kind);
+            ok = false;
+            break;
+        }
+        // spread the changed files evenly rather than at the front
+        bool is_changed = (i * 2654435761u) % 10000 < changed * 10000;
+        *changed_files += is_changed;
+
+        for (int snapshot = 0; snapshot < 2; snapshot++) {
+            bool with_prefix = snapshot == 1 && is_changed;
+            array_clear(&file);
+            bench_buffer_appendf(&file, "%s/z_cache_%05u.prog.abap",
+                                 snapshot ? new_directory : old_directory, i);
+            array_push(&file, '\0');
+            FILE* out = fopen(file.contents, "wb");
+            if (!out) {
+                ok = false;
+                break;
+            }
+            const char* data = source.contents + (with_prefix ? 0 : prefix);
+            size_t length = source.size - (with_prefix ? 0 : prefix);
+            fwrite(data, 1, length, out);
+            fclose(out);
+        }
+    }
+    array_delete(&source);
+    array_delete(&spec);
+    array_delete(&file);
+    return ok;
+}
+
+/** The fastest of the runs, the summary is that of the last one. */
+static uint64_t best_run(const char* path, TSAbapBulkOptions* options,
+                         uint32_t repeat, const char* clear_cache,
+                         TSAbapBulkSummary* summary, bool* ok)
+{
+    uint64_t best_ns = UINT64_MAX;
+    for (uint32_t run = 0; run < repeat && *ok; run++) {
+        if (clear_cache) {
+            remove_tree(clear_cache, true);
+        }
+        *ok = tree_sitter_abap_bulk_parse(&path, 1, options, summary);
+        if (summary->wall_ns < best_ns) {
+            best_ns = summary->wall_ns;
+        }
+    }
+    return best_ns;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t files = 2000;
+    const char* file_size = "16k";
+    const char* kind = "report";
+    double changed = 0.05;
+    const char* query_path = NULL;
+    uint32_t repeat = 3;
+    const char* output_path = NULL;
+    TSAbapBulkOptions options = {0};
+    const char* paths[2];
+    uint32_t path_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            files = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--file-size") == 0 && i + 1 < argc) {
+            file_size = argv[++i];
+        } else if (strcmp(argv[i], "--kind") == 0 && i + 1 < argc) {
+            kind = argv[++i];
+        } else if (strcmp(argv[i], "--changed") == 0 && i + 1 < argc) {
+            changed = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            query_path = argv[++i];
+        } else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            options.cache_max_bytes = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-' || path_count == 2) {
+            usage(stderr);
+            return 1;
+        } else {
+            paths[path_count++] = argv[i];
+        }
+    }
+    if (path_count == 1) {
+        usage(stderr);
+        return 1;
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    char* query = NULL;
+    if (query_path) {
+        if (!bench_read_file(query_path, &query, &options.query_length)) {
+            fprintf(stderr, "failed to read %s\n", query_path);
+            return 1;
+        }
+        options.query = query;
+    }
+
+    char* generated[2] = {NULL, NULL};
+    uint32_t changed_files = 0;
+    bool ok = true;
+    if (path_count == 0) {
+        generated[0] = make_temporary_directory("cache-old");
+        generated[1] = make_temporary_directory("cache-new");
+        ok = generated[0] && generated[1] &&
+             generate_snapshots(generated[0], generated[1], files, file_size,
+                                kind, changed, &changed_files);
+        paths[0] = generated[0];
+        paths[1] = generated[1];
+    }
+    char* cache = make_temporary_directory("cache");
+    if (!ok || !cache) {
+        fprintf(stderr, "failed to create the temporary directories\n");
+        return 1;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    // One untimed run reads the files into the page cache, so that the
+    // first timed run does not pay for the disk.
+    TSAbapBulkSummary summary;
+    ok = tree_sitter_abap_bulk_parse(paths, 2, &options, &summary);
+
+    TSAbapBulkSummary old_summary;
+    uint64_t uncached_old_ns =
+            best_run(paths[0], &options, repeat, NULL, &old_summary, &ok);
+    TSAbapBulkSummary new_summary;
+    uint64_t uncached_new_ns =
+            best_run(paths[1], &options, repeat, NULL, &new_summary, &ok);
+
+    // The cold runs start from an empty cache each, the warm runs from the
+    // cache of the last cold run. Warm runs store the changed files, which
+    // the next warm run would hit, so each is preceded by a cold run.
+    options.cache_directory = cache;
+    uint64_t cold_ns = UINT64_MAX;
+    uint64_t warm_ns = UINT64_MAX;
+    TSAbapBulkSummary cold;
+    TSAbapBulkSummary warm;
+    for (uint32_t run = 0; run < repeat && ok; run++) {
+        uint64_t ns = best_run(paths[0], &options, 1, cache, &cold, &ok);
+        if (ns < cold_ns) {
+            cold_ns = ns;
+        }
+        ns = best_run(paths[1], &options, 1, NULL, &warm, &ok);
+        if (ns < warm_ns) {
+            warm_ns = ns;
+        }
+    }
+    uint64_t cache_bytes = tree_size(cache);
+
+    uint32_t read = warm.files - warm.unreadable;
+    fprintf(out, "{\n  \"old_files\": %u,\n", old_summary.files);
+    fprintf(out, "  \"new_files\": %u,\n", new_summary.files);
+    if (path_count == 0) {
+        fprintf(out, "  \"changed_files\": %u,\n", changed_files);
+    }
+    fprintf(out, "  \"new_bytes\": %llu,\n",
+            (unsigned long long)new_summary.bytes);
+    fprintf(out, "  \"cache_bytes\": %llu,\n",
+            (unsigned long long)cache_bytes);
+    fprintf(out, "  \"uncached_old_ns\": %llu,\n",
+            (unsigned long long)uncached_old_ns);
+    fprintf(out, "  \"uncached_new_ns\": %llu,\n",
+            (unsigned long long)uncached_new_ns);
+    fprintf(out, "  \"cold_ns\": %llu,\n", (unsigned long long)cold_ns);
+    fprintf(out, "  \"cold_overhead\": %.3f,\n",
+            uncached_old_ns ? (double)cold_ns / uncached_old_ns : 0.0);
+    fprintf(out, "  \"warm_ns\": %llu,\n", (unsigned long long)warm_ns);
+    fprintf(out, "  \"hit_rate\": %.4f,\n",
+            read ? (double)warm.cache_hits / read : 0.0);
+    fprintf(out, "  \"lookup_ns_per_file\": %llu,\n",
+            read ? (unsigned long long)(warm.cache_lookup_ns / read) : 0ull);
+    fprintf(out, "  \"stores\": %u,\n", warm.cache_stores);
+    fprintf(out, "  \"evictions\": %u,\n", warm.cache_evictions);
+    fprintf(out, "  \"speedup\": %.3f\n}\n",
+            warm_ns ? (double)uncached_new_ns / warm_ns : 0.0);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    remove_tree(cache, false);
+    free(cache);
+    for (int i = 0; i < 2; i++) {
+        if (generated[i]) {
+            remove_tree(generated[i], false);
+            free(generated[i]);
+        }
+    }
+    free(query);
+    return ok ? 0 : 1;
+}
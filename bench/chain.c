@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap-chain.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Chain expansion benchmark.
+ *
+ * Times `tree_sitter_abap_expand_chains` on its own, parses each source as
+ * it is and expanded, and reports the throughput of the expansion, both
+ * parse times and the ERROR and MISSING nodes of both parses as JSON. The
+ * expanded time includes the expansion.
+ *
+ * Every byte of the expanded source is looked up in the offset map and
+ * compared with the original byte it maps to. Periods and blanks that stand
+ * in for a comma or colon are expected to differ, anything else is reported
+ * as a mismatch.
+ */
+
+static const char* default_synthetic[] = {"chained:4m", "report:4m"};
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-chain [options] [path...]\n"
+            "\n"
+            "Parses the given files and directories (default: "
+            "synthetic:chained:4m\n"
+            "and synthetic:report:4m) as they are and with expanded chains "
+            "and\n"
+            "prints JSON.\n"
+            "\n"
+            "  --repeat N          runs per source, the fastest counts "
+            "(default 5)\n"
+            "  --synthetic SPEC    add a generated source, kind[:amount]\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static uint32_t count_map_mismatches(const TSAbapChainExpansion* expansion,
+                                     const BenchSource* source)
+{
+    uint32_t length;
+    const char* expanded =
+            tree_sitter_abap_chain_expansion_source(expansion, &length);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        uint32_t original =
+                tree_sitter_abap_chain_expansion_original_byte(expansion, i);
+        if (original >= source->length) {
+            mismatches++;
+            continue;
+        }
+        char c = source->data[original];
+        mismatches += expanded[i] != c && c != ':' && c != ',';
+    }
+    return mismatches;
+}
+
+static uint64_t parse_ns(TSParser* parser, const char* data, uint32_t length,
+                         uint32_t repeat, BenchTreeStats* stats)
+{
+    uint64_t fastest = UINT64_MAX;
+    for (uint32_t run = 0; run < repeat; run++) {
+        uint64_t start = bench_now_ns();
+        TSTree* tree = ts_parser_parse_string(parser, NULL, data, length);
+        uint64_t ns = bench_now_ns() - start;
+        if (ns < fastest) {
+            fastest = ns;
+        }
+        if (run == 0) {
+            *stats = bench_tree_stats(tree);
+        }
+        ts_tree_delete(tree);
+    }
+    return fastest;
+}
+
+static void run(FILE* out, TSParser* parser, const BenchSource* source,
+                uint32_t repeat, bool first)
+{
+    uint64_t expand_ns = UINT64_MAX;
+    for (uint32_t run = 0; run < repeat; run++) {
+        uint64_t start = bench_now_ns();
+        TSAbapChainExpansion* expansion =
+                tree_sitter_abap_expand_chains(source->data, source->length);
+        uint64_t ns = bench_now_ns() - start;
+        tree_sitter_abap_chain_expansion_delete(expansion);
+        if (ns < expand_ns) {
+            expand_ns = ns;
+        }
+    }
+
+    TSAbapChainExpansion* expansion =
+            tree_sitter_abap_expand_chains(source->data, source->length);
+    uint32_t expanded_length;
+    const char* expanded = tree_sitter_abap_chain_expansion_source(
+            expansion, &expanded_length);
+
+    BenchTreeStats original_stats;
+    BenchTreeStats expanded_stats;
+    uint64_t original_ns = parse_ns(parser, source->data, source->length,
+                                    repeat, &original_stats);
+    uint64_t expanded_ns = parse_ns(parser, expanded, expanded_length, repeat,
+                                    &expanded_stats) +
+                           expand_ns;
+
+    double mb = source->length / (1024.0 * 1024.0);
+    fprintf(out, "%s\n    {\"name\": ", first ? "" : ",");
+    bench_json_string(out, source->name);
+    fprintf(out,
+            ", \"bytes\": %u, \"expanded_bytes\": %u, \"chains\": %u,\n"
+            "     \"segments\": %u, \"expand_ns\": %llu, "
+            "\"expand_mb_per_s\": %.3f,\n"
+            "     \"original_parse_ns\": %llu, \"expanded_parse_ns\": %llu, "
+            "\"speedup\": %.3f,\n"
+            "     \"original_errors\": %u, \"expanded_errors\": %u, "
+            "\"map_mismatches\": %u}",
+            source->length, expanded_length,
+            tree_sitter_abap_chain_expansion_chain_count(expansion),
+            tree_sitter_abap_chain_expansion_segment_count(expansion),
+            (unsigned long long)expand_ns,
+            expand_ns ? mb / (expand_ns / 1e9) : 0.0,
+            (unsigned long long)original_ns, (unsigned long long)expanded_ns,
+            expanded_ns ? (double)original_ns / expanded_ns : 0.0,
+            original_stats.errors + original_stats.missing,
+            expanded_stats.errors + expanded_stats.missing,
+            count_map_mismatches(expansion, source));
+
+    tree_sitter_abap_chain_expansion_delete(expansion);
+}
+
+int main(int argc, char** argv)
+{
+    BenchSourceList sources = array_new();
+    uint32_t repeat = 5;
+    const char* output_path = NULL;
+    bool explicit_sources = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            if (!bench_collect_synthetic(&sources, argv[++i])) {
+                return 1;
+            }
+            explicit_sources = true;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            if (!bench_collect_path(&sources, argv[i])) {
+                return 1;
+            }
+            explicit_sources = true;
+        }
+    }
+    if (!explicit_sources) {
+        for (size_t i = 0; i < sizeof(default_synthetic) / sizeof(char*); i++) {
+            bench_collect_synthetic(&sources, default_synthetic[i]);
+        }
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+    fprintf(out, "{\n  \"sources\": [");
+    for (uint32_t i = 0; i < sources.size; i++) {
+        run(out, parser, &sources.contents[i], repeat, i == 0);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    ts_parser_delete(parser);
+    bench_sources_delete(&sources);
+    return 0;
+}
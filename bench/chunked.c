@@ -0,0 +1,266 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap-chunked.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * Chunked parse benchmark.
+ *
+ * Parses each source once in one piece with `ts_parser_parse_string` and
+ * once with `tree_sitter_abap_parse_chunked_file` from a memory mapped copy
+ * of it, and reports both times and the speedup as JSON. The chunked time
+ * includes mapping the file and finding the boundaries.
+ *
+ * The top-level nodes of both parses are compared by type and range, any
+ * difference is reported as a mismatch, so that the speedup is only trusted
+ * for an identical result.
+ */
+
+typedef struct
+{
+    TSSymbol symbol;
+    uint32_t start;
+    uint32_t end;
+} TopLevelNode;
+
+typedef Array(TopLevelNode) TopLevelList;
+
+static const char* default_synthetic[] = {"report:10m", "report:100m"};
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-chunked [options] [path...]\n"
+            "\n"
+            "Parses the given files and directories (default: "
+            "synthetic:report:10m\n"
+            "and synthetic:report:100m) sequentially and chunked and prints "
+            "JSON.\n"
+            "\n"
+            "  --threads N         chunked parse threads (default: one per "
+            "cpu)\n"
+            "  --min-chunk BYTES   smallest chunk (default 1 MiB)\n"
+            "  --repeat N          parses per source, the fastest counts\n"
+            "                      (default 3)\n"
+            "  --synthetic SPEC    add a generated source, kind[:amount]\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static void collect_top_level(const TSTree* tree, TopLevelList* nodes)
+{
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    if (ts_tree_cursor_goto_first_child(&cursor)) {
+        do {
+            TSNode node = ts_tree_cursor_current_node(&cursor);
+            array_push(nodes, ((TopLevelNode){
+                                      .symbol = ts_node_symbol(node),
+                                      .start = ts_node_start_byte(node),
+                                      .end = ts_node_end_byte(node),
+                              }));
+        } while (ts_tree_cursor_goto_next_sibling(&cursor));
+    }
+    ts_tree_cursor_delete(&cursor);
+}
+
+static uint32_t count_mismatches(const TopLevelList* expected,
+                                 const TopLevelList* actual)
+{
+    uint32_t common = expected->size < actual->size ? expected->size
+                                                    : actual->size;
+    uint32_t mismatches = expected->size > actual->size
+                                  ? expected->size - actual->size
+                                  : actual->size - expected->size;
+    for (uint32_t i = 0; i < common; i++) {
+        const TopLevelNode* a = &expected->contents[i];
+        const TopLevelNode* b = &actual->contents[i];
+        mismatches += a->symbol != b->symbol || a->start != b->start ||
+                      a->end != b->end;
+    }
+    return mismatches;
+}
+
+static bool write_temporary(const BenchSource* source, char* path)
+{
+    int file = mkstemp(path);
+    if (file < 0) {
+        return false;
+    }
+    FILE* out = fdopen(file, "wb");
+    bool ok = out && fwrite(source->data, 1, source->length, out) ==
+                             source->length;
+    if (out) {
+        ok &= fclose(out) == 0;
+    }
+    return ok;
+}
+
+static bool run(FILE* out, const BenchSource* source,
+                const TSAbapChunkedOptions* options, uint32_t repeat,
+                bool first)
+{
+    const char* tmp = getenv("TMPDIR");
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/tree-sitter-abap-chunked.XXXXXX",
+             tmp ? tmp : "/tmp");
+    if (!write_temporary(source, path)) {
+        fprintf(stderr, "failed to write a temporary copy of %s\n",
+                source->name);
+        unlink(path);
+        return false;
+    }
+
+    // One in one piece, the whole tree is gone before the chunked parses.
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+    TopLevelList expected = array_new();
+    BenchTreeStats sequential_stats = {0};
+    uint64_t sequential_ns = UINT64_MAX;
+    for (uint32_t run = 0; run < repeat; run++) {
+        uint64_t start = bench_now_ns();
+        TSTree* tree = ts_parser_parse_string(parser, NULL, source->data,
+                                              source->length);
+        uint64_t ns = bench_now_ns() - start;
+        if (ns < sequential_ns) {
+            sequential_ns = ns;
+        }
+        if (run == 0) {
+            sequential_stats = bench_tree_stats(tree);
+            collect_top_level(tree, &expected);
+        }
+        ts_tree_delete(tree);
+    }
+    ts_parser_delete(parser);
+
+    TopLevelList actual = array_new();
+    BenchTreeStats chunked_stats = {0};
+    uint64_t chunked_ns = UINT64_MAX;
+    uint32_t chunks = 0;
+    for (uint32_t run = 0; run < repeat; run++) {
+        uint64_t start = bench_now_ns();
+        TSAbapChunkedTree* tree =
+                tree_sitter_abap_parse_chunked_file(path, options);
+        uint64_t ns = bench_now_ns() - start;
+        if (!tree) {
+            break;
+        }
+        if (ns < chunked_ns) {
+            chunked_ns = ns;
+        }
+        chunks = tree_sitter_abap_chunked_tree_chunk_count(tree);
+        for (uint32_t i = 0; run == 0 && i < chunks; i++) {
+            const TSTree* chunk = tree_sitter_abap_chunked_tree_chunk(tree, i);
+            BenchTreeStats stats = bench_tree_stats(chunk);
+            chunked_stats.nodes += stats.nodes;
+            chunked_stats.errors += stats.errors;
+            chunked_stats.missing += stats.missing;
+            collect_top_level(chunk, &actual);
+        }
+        tree_sitter_abap_chunked_tree_delete(tree);
+    }
+    unlink(path);
+
+    // How long finding the boundaries takes on its own.
+    uint32_t count;
+    uint64_t start = bench_now_ns();
+    free(tree_sitter_abap_chunk_ranges(source->data, source->length, options,
+                                       &count));
+    uint64_t split_ns = bench_now_ns() - start;
+
+    double mb = source->length / (1024.0 * 1024.0);
+    fprintf(out, "%s\n    {\"name\": ", first ? "" : ",");
+    bench_json_string(out, source->name);
+    fprintf(out,
+            ", \"bytes\": %u, \"chunks\": %u, \"split_ns\": %llu,\n"
+            "     \"sequential_ns\": %llu, \"chunked_ns\": %llu, "
+            "\"speedup\": %.3f,\n"
+            "     \"sequential_mb_per_s\": %.3f, \"chunked_mb_per_s\": %.3f,\n"
+            "     \"sequential_errors\": %u, \"chunked_errors\": %u, "
+            "\"top_level_nodes\": %u, \"top_level_mismatches\": %u}",
+            source->length, chunks, (unsigned long long)split_ns,
+            (unsigned long long)sequential_ns,
+            (unsigned long long)chunked_ns,
+            chunked_ns ? (double)sequential_ns / chunked_ns : 0.0,
+            sequential_ns ? mb / (sequential_ns / 1e9) : 0.0,
+            chunked_ns ? mb / (chunked_ns / 1e9) : 0.0,
+            sequential_stats.errors + sequential_stats.missing,
+            chunked_stats.errors + chunked_stats.missing, expected.size,
+            count_mismatches(&expected, &actual));
+
+    array_delete(&expected);
+    array_delete(&actual);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchSourceList sources = array_new();
+    TSAbapChunkedOptions options = {0};
+    uint32_t repeat = 3;
+    const char* output_path = NULL;
+    bool explicit_sources = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--min-chunk") == 0 && i + 1 < argc) {
+            options.min_chunk_bytes = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            if (!bench_collect_synthetic(&sources, argv[++i])) {
+                return 1;
+            }
+            explicit_sources = true;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            if (!bench_collect_path(&sources, argv[i])) {
+                return 1;
+            }
+            explicit_sources = true;
+        }
+    }
+    if (!explicit_sources) {
+        for (size_t i = 0; i < sizeof(default_synthetic) / sizeof(char*); i++) {
+            bench_collect_synthetic(&sources, default_synthetic[i]);
+        }
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    fprintf(out, "{\n  \"threads\": %ld,\n  \"sources\": [",
+            options.threads ? (long)options.threads : cpus);
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < sources.size; i++) {
+        written += run(out, &sources.contents[i], &options, repeat,
+                       written == 0);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    bench_sources_delete(&sources);
+    return 0;
+}
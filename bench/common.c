@@ -0,0 +1,354 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include <dirent.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+bool bench_read_file(const char* path, char** data, uint32_t* length)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < 0 || (unsigned long)size > UINT32_MAX - 1) {
+        fclose(file);
+        return false;
+    }
+
+    *data = malloc((size_t)size + 1);
+    *length = (uint32_t)fread(*data, 1, (size_t)size, file);
+    (*data)[*length] = '\0';
+    fclose(file);
+    return true;
+}
+
+static bool ends_with(const char* value, const char* suffix)
+{
+    size_t value_length = strlen(value);
+    size_t suffix_length = strlen(suffix);
+    return value_length >= suffix_length &&
+           strcmp(value + value_length - suffix_length, suffix) == 0;
+}
+
+static char* copy_range(const char* start, size_t length)
+{
+    char* copy = malloc(length + 1);
+    memcpy(copy, start, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+static void push_source(BenchSourceList* sources, const char* group,
+                        const char* name, char* data, uint32_t length)
+{
+    BenchSource source = {
+            .name = strdup(name),
+            .group = strdup(group),
+            .data = data,
+            .length = length,
+    };
+    array_push(sources, source);
+}
+
+static const char* next_line(const char* line, const char* end)
+{
+    const char* newline = memchr(line, '\n', (size_t)(end - line));
+    return newline ? newline + 1 : end;
+}
+
+/**
+ * Splits a tree-sitter corpus file into its test cases. A case is made up of
+ * a `===` delimited header, the source and a `---` line followed by the
+ * expected tree, only the source is kept.
+ */
+static void collect_corpus_file(BenchSourceList* sources, const char* group,
+                                const char* path, const char* data,
+                                uint32_t length)
+{
+    const char* end = data + length;
+    const char* line = data;
+    const char* name = NULL;
+    size_t name_length = 0;
+    uint32_t index = 0;
+
+    while (line < end) {
+        if (strncmp(line, "===", 3) != 0) {
+            line = next_line(line, end);
+            continue;
+        }
+
+        // the header is the opening delimiter, the name (plus attributes
+        // such as `:error`) and the closing delimiter.
+        line = next_line(line, end);
+        name = line;
+        while (line < end && strncmp(line, "===", 3) != 0) {
+            line = next_line(line, end);
+        }
+        name_length = strcspn(name, "\r\n");
+        line = next_line(line, end);
+
+        const char* source_start = line;
+        while (line < end && strncmp(line, "---", 3) != 0) {
+            line = next_line(line, end);
+        }
+        const char* source_end = line;
+        while (source_end > source_start &&
+               (source_end[-1] == '\n' || source_end[-1] == '\r')) {
+            source_end--;
+        }
+
+        BenchBuffer case_name = array_new();
+        bench_buffer_appendf(&case_name, "%s#%u ", path, index++);
+        array_extend(&case_name, (uint32_t)name_length, name);
+        array_push(&case_name, '\0');
+
+        size_t source_length = (size_t)(source_end - source_start);
+        push_source(sources, group, case_name.contents,
+                    copy_range(source_start, source_length),
+                    (uint32_t)source_length);
+        array_delete(&case_name);
+    }
+}
+
+static void collect_file(BenchSourceList* sources, const char* group,
+                         const char* path)
+{
+    bool corpus = ends_with(path, ".txt");
+    if (!corpus && !ends_with(path, ".abap")) {
+        return;
+    }
+
+    char* data;
+    uint32_t length;
+    if (!bench_read_file(path, &data, &length)) {
+        fprintf(stderr, "failed to read %s\n", path);
+        return;
+    }
+
+    if (corpus) {
+        collect_corpus_file(sources, group, path, data, length);
+        free(data);
+    } else {
+        push_source(sources, group, path, data, length);
+    }
+}
+
+static int compare_names(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static void collect_directory(BenchSourceList* sources, const char* group,
+                              const char* path)
+{
+    DIR* directory = opendir(path);
+    if (!directory) {
+        return;
+    }
+
+    // Sort the entries so that runs are comparable across file systems.
+    Array(char*) entries = array_new();
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            array_push(&entries, strdup(entry->d_name));
+        }
+    }
+    closedir(directory);
+    qsort(entries.contents, entries.size, sizeof(char*), compare_names);
+
+    for (uint32_t i = 0; i < entries.size; i++) {
+        BenchBuffer child = array_new();
+        bench_buffer_appendf(&child, "%s/%s", path, entries.contents[i]);
+        array_push(&child, '\0');
+
+        struct stat info;
+        if (stat(child.contents, &info) == 0) {
+            if (S_ISDIR(info.st_mode)) {
+                collect_directory(sources, group, child.contents);
+            } else if (S_ISREG(info.st_mode)) {
+                collect_file(sources, group, child.contents);
+            }
+        }
+        array_delete(&child);
+        free(entries.contents[i]);
+    }
+    array_delete(&entries);
+}
+
+bool bench_collect_path(BenchSourceList* sources, const char* path)
+{
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        fprintf(stderr, "no such file or directory: %s\n", path);
+        return false;
+    }
+
+    if (S_ISDIR(info.st_mode)) {
+        collect_directory(sources, path, path);
+    } else {
+        collect_file(sources, path, path);
+    }
+    return true;
+}
+
+bool bench_collect_synthetic(BenchSourceList* sources, const char* spec)
+{
+    const char* separator = strchr(spec, ':');
+    char* kind = separator ? copy_range(spec, (size_t)(separator - spec))
+                           : strdup(spec);
+    const char* amount = separator ? separator + 1 : "";
+
+    BenchBuffer buffer = array_new();
+    bool known = bench_synthesize(kind, amount, &buffer);
+    free(kind);
+    if (!known) {
+        array_delete(&buffer);
+        fprintf(stderr, "unknown synthetic source: %s\n", spec);
+        return false;
+    }
+
+    BenchBuffer group = array_new();
+    bench_buffer_appendf(&group, "synthetic:%s", spec);
+    array_push(&group, '\0');
+
+    uint32_t length = buffer.size;
+    array_push(&buffer, '\0');
+    push_source(sources, group.contents, group.contents, buffer.contents,
+                length);
+    array_delete(&group);
+    return true;
+}
+
+void bench_sources_delete(BenchSourceList* sources)
+{
+    for (uint32_t i = 0; i < sources->size; i++) {
+        free(sources->contents[i].name);
+        free(sources->contents[i].group);
+        free(sources->contents[i].data);
+    }
+    array_delete(sources);
+}
+
+BenchTreeStats bench_tree_stats(const TSTree* tree)
+{
+    BenchTreeStats stats = {0};
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    uint32_t depth = 0;
+
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        stats.nodes++;
+        stats.errors += ts_node_is_error(node);
+        stats.missing += ts_node_is_missing(node);
+        if (depth > stats.max_depth) {
+            stats.max_depth = depth;
+        }
+
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            depth++;
+            continue;
+        }
+        stats.leaves++;
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return stats;
+            }
+            depth--;
+        }
+    }
+}
+
+static int compare_samples(const void* a, const void* b)
+{
+    uint64_t left = *(const uint64_t*)a;
+    uint64_t right = *(const uint64_t*)b;
+    return (left > right) - (left < right);
+}
+
+uint64_t bench_percentile(BenchSamples* samples, double percentile)
+{
+    if (samples->size == 0) {
+        return 0;
+    }
+    qsort(samples->contents, samples->size, sizeof(uint64_t),
+          compare_samples);
+
+    // nearest-rank, so p100 is the maximum and p0 the minimum
+    double rank = percentile / 100.0 * samples->size;
+    uint32_t index = rank <= 1.0 ? 0 : (uint32_t)(rank + 0.999999) - 1;
+    if (index >= samples->size) {
+        index = samples->size - 1;
+    }
+    return samples->contents[index];
+}
+
+void bench_buffer_append(BenchBuffer* buffer, const char* text)
+{
+    array_extend(buffer, (uint32_t)strlen(text), text);
+}
+
+void bench_buffer_appendf(BenchBuffer* buffer, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    if (length > 0) {
+        // vsnprintf always terminates, so reserve one more and drop it again
+        array_reserve(buffer, buffer->size + (uint32_t)length + 1);
+        vsnprintf(buffer->contents + buffer->size, (size_t)length + 1, format,
+                  args);
+        buffer->size += (uint32_t)length;
+    }
+    va_end(args);
+}
+
+void bench_json_string(FILE* out, const char* value)
+{
+    fputc('"', out);
+    for (const char* c = value; *c; c++) {
+        switch (*c) {
+            case '"':
+                fputs("\\\"", out);
+                break;
+            case '\\':
+                fputs("\\\\", out);
+                break;
+            case '\n':
+                fputs("\\n", out);
+                break;
+            case '\r':
+                fputs("\\r", out);
+                break;
+            case '\t':
+                fputs("\\t", out);
+                break;
+            default:
+                if ((unsigned char)*c < 0x20) {
+                    fprintf(out, "\\u%04x", *c);
+                } else {
+                    fputc(*c, out);
+                }
+        }
+    }
+    fputc('"', out);
+}
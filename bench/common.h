@@ -0,0 +1,92 @@
+#ifndef TREE_SITTER_ABAP_BENCH_COMMON_H_
+#define TREE_SITTER_ABAP_BENCH_COMMON_H_
+
+#include "tree_sitter/array.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <tree_sitter/api.h>
+
+/**
+ * A single piece of ABAP source the benchmarks operate on.
+ *
+ * The group is the input root the source was collected from, e.g.
+ * `test/corpus` or `synthetic:report:4m`, and is used to break results down.
+ */
+typedef struct
+{
+    char* name;
+    char* group;
+    char* data;
+    uint32_t length;
+} BenchSource;
+
+typedef Array(BenchSource) BenchSourceList;
+
+typedef Array(char) BenchBuffer;
+
+typedef Array(uint64_t) BenchSamples;
+
+typedef struct
+{
+    uint32_t nodes;
+    uint32_t leaves;
+    uint32_t errors;
+    uint32_t missing;
+    uint32_t max_depth;
+} BenchTreeStats;
+
+/** Monotonic clock in nanoseconds. */
+uint64_t bench_now_ns(void);
+
+/** Reads a whole file into memory, the result is NUL terminated. */
+bool bench_read_file(const char* path, char** data, uint32_t* length);
+
+/**
+ * Collects the sources below the given path.
+ *
+ * Directories are walked recursively. Tree-sitter corpus files (`*.txt`) are
+ * split into one source per test case so that only the ABAP part of each
+ * case is parsed, `*.abap` files are taken as they are.
+ */
+bool bench_collect_path(BenchSourceList* sources, const char* path);
+
+/**
+ * Adds a generated source, the spec has the form `kind[:amount]`.
+ *
+ * @see bench_synthesize
+ */
+bool bench_collect_synthetic(BenchSourceList* sources, const char* spec);
+
+void bench_sources_delete(BenchSourceList* sources);
+
+/**
+ * Walks the whole tree once, counting nodes, leaves (the tokens), ERROR and
+ * MISSING nodes and the maximum depth.
+ */
+BenchTreeStats bench_tree_stats(const TSTree* tree);
+
+/** Sorts the samples in place and returns the given percentile (0-100). */
+uint64_t bench_percentile(BenchSamples* samples, double percentile);
+
+void bench_buffer_append(BenchBuffer* buffer, const char* text);
+
+void bench_buffer_appendf(BenchBuffer* buffer, const char* format, ...);
+
+/** Writes the string as a quoted and escaped JSON string. */
+void bench_json_string(FILE* out, const char* value);
+
+/**
+ * Generates a large, real-world-style ABAP source of the given kind.
+ *
+ * The amount is either a byte target when suffixed with `k` or `m`, or a
+ * kind specific number of repetitions otherwise (classes for `report`, lines
+ * for `comment_block`, ...). Returns false for unknown kinds.
+ */
+bool bench_synthesize(const char* kind, const char* amount,
+                      BenchBuffer* buffer);
+
+/** Prints the known synthetic kinds, one per line. */
+void bench_list_synthetic(FILE* out);
+
+#endif // TREE_SITTER_ABAP_BENCH_COMMON_H_
@@ -0,0 +1,237 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap-cst.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * CST format benchmark.
+ *
+ * Compares getting at the nodes of a source by parsing it again against
+ * loading its CST file: both are timed through a walk over every node that
+ * counts the named ones, so that neither side is measured without touching
+ * its result. Also reports the sizes of the source, the CST file and the
+ * S-expression of the tree, and the time to write the file.
+ */
+
+static const char* default_synthetic[] = {"report:64k", "report:1m",
+                                          "report:25m"};
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-cst [options] [path...]\n"
+            "\n"
+            "Parses the given files and directories (default: "
+            "synthetic:report:64k,\n"
+            "report:1m and report:25m), writes each as a CST file and prints "
+            "JSON.\n"
+            "\n"
+            "  --no-source         do not embed the source in the files\n"
+            "  --repeat N          runs per source, the fastest counts\n"
+            "                      (default 5)\n"
+            "  --synthetic SPEC    add a generated source, kind[:amount]\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static uint32_t count_named_in_tree(const TSTree* tree)
+{
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    uint32_t named = 0;
+    for (;;) {
+        named += ts_node_is_named(ts_tree_cursor_current_node(&cursor));
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return named;
+            }
+        }
+    }
+}
+
+/** The same walk over the links of the file rather than its row order. */
+static uint32_t count_named_in_cst(const TSAbapCst* cst)
+{
+    const TSAbapCstColumns* columns = tree_sitter_abap_cst_columns(cst);
+    uint32_t named = 0;
+    uint32_t node = 0;
+    for (;;) {
+        named += columns->flags[node] & TREE_SITTER_ABAP_CST_NAMED;
+        if (columns->first_child[node] != TREE_SITTER_ABAP_CST_NONE) {
+            node = columns->first_child[node];
+            continue;
+        }
+        while (columns->next_sibling[node] == TREE_SITTER_ABAP_CST_NONE) {
+            node = columns->parent[node];
+            if (node == TREE_SITTER_ABAP_CST_NONE) {
+                return named;
+            }
+        }
+        node = columns->next_sibling[node];
+    }
+}
+
+static bool run(FILE* out, TSParser* parser, const BenchSource* source,
+                bool embed_source, uint32_t repeat, bool first)
+{
+    const char* tmp = getenv("TMPDIR");
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/tree-sitter-abap-cst.XXXXXX",
+             tmp ? tmp : "/tmp");
+    int file = mkstemp(path);
+    if (file < 0) {
+        fprintf(stderr, "failed to create a temporary file\n");
+        return false;
+    }
+    close(file);
+
+    TSTree* tree = NULL;
+    uint64_t parse_ns = UINT64_MAX;
+    uint32_t parsed_named = 0;
+    for (uint32_t run = 0; run < repeat; run++) {
+        ts_tree_delete(tree);
+        uint64_t start = bench_now_ns();
+        tree = ts_parser_parse_string(parser, NULL, source->data,
+                                      source->length);
+        parsed_named = count_named_in_tree(tree);
+        uint64_t ns = bench_now_ns() - start;
+        if (ns < parse_ns) {
+            parse_ns = ns;
+        }
+    }
+
+    char* sexp = ts_node_string(ts_tree_root_node(tree));
+    size_t sexp_bytes = strlen(sexp);
+    free(sexp);
+
+    uint64_t write_ns = UINT64_MAX;
+    for (uint32_t run = 0; run < repeat; run++) {
+        uint64_t start = bench_now_ns();
+        bool ok = tree_sitter_abap_cst_write_file(
+                path, tree, embed_source ? source->data : NULL,
+                source->length);
+        uint64_t ns = bench_now_ns() - start;
+        if (!ok) {
+            ts_tree_delete(tree);
+            unlink(path);
+            return false;
+        }
+        if (ns < write_ns) {
+            write_ns = ns;
+        }
+    }
+    ts_tree_delete(tree);
+
+    uint64_t load_ns = UINT64_MAX;
+    uint32_t loaded_named = 0;
+    for (uint32_t run = 0; run < repeat; run++) {
+        uint64_t start = bench_now_ns();
+        TSAbapCstStatus status;
+        TSAbapCst* cst = tree_sitter_abap_cst_open(path, &status);
+        if (!cst) {
+            fprintf(stderr, "failed to load %s, status %d\n", path, status);
+            unlink(path);
+            return false;
+        }
+        loaded_named = count_named_in_cst(cst);
+        uint64_t ns = bench_now_ns() - start;
+        tree_sitter_abap_cst_close(cst);
+        if (ns < load_ns) {
+            load_ns = ns;
+        }
+    }
+    struct stat info;
+    size_t cst_bytes = stat(path, &info) == 0 ? (size_t)info.st_size : 0;
+    unlink(path);
+
+    fprintf(out, "%s\n    {\"name\": ", first ? "" : ",");
+    bench_json_string(out, source->name);
+    fprintf(out,
+            ", \"bytes\": %u, \"cst_bytes\": %zu, \"sexp_bytes\": %zu,\n"
+            "     \"parse_ns\": %llu, \"write_ns\": %llu, \"load_ns\": %llu, "
+            "\"speedup\": %.3f,\n"
+            "     \"named_nodes\": %u, \"named_nodes_match\": %s}",
+            source->length, cst_bytes, sexp_bytes,
+            (unsigned long long)parse_ns, (unsigned long long)write_ns,
+            (unsigned long long)load_ns,
+            load_ns ? (double)parse_ns / load_ns : 0.0, parsed_named,
+            parsed_named == loaded_named ? "true" : "false");
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchSourceList sources = array_new();
+    bool embed_source = true;
+    uint32_t repeat = 5;
+    const char* output_path = NULL;
+    bool explicit_sources = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-source") == 0) {
+            embed_source = false;
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            if (!bench_collect_synthetic(&sources, argv[++i])) {
+                return 1;
+            }
+            explicit_sources = true;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            if (!bench_collect_path(&sources, argv[i])) {
+                return 1;
+            }
+            explicit_sources = true;
+        }
+    }
+    if (!explicit_sources) {
+        for (size_t i = 0; i < sizeof(default_synthetic) / sizeof(char*); i++) {
+            bench_collect_synthetic(&sources, default_synthetic[i]);
+        }
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+    fprintf(out, "{\n  \"embedded_source\": %s,\n  \"sources\": [",
+            embed_source ? "true" : "false");
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < sources.size; i++) {
+        written += run(out, parser, &sources.contents[i], embed_source, repeat,
+                       written == 0);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    ts_parser_delete(parser);
+    bench_sources_delete(&sources);
+    return 0;
+}
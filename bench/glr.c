@@ -0,0 +1,626 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * GLR ambiguity profiler.
+ *
+ * Parses the inputs with a logger on the parser and follows the stack
+ * versions through the log of the runtime, so any build of the runtime
+ * will do. Every `process` line names the version being advanced and the
+ * number of versions alive. When that number grows, the step before it
+ * split the stack, and the rules it reduced are the conflict: the first
+ * one that is an entry of `conflicts` or has a `prec.dynamic` in
+ * grammar.json, otherwise the first one reduced. An ambiguity window lasts
+ * from the split until a single version is left. Its steps, versions,
+ * merges and re-lexed bytes are charged to the conflict and to the source
+ * location of the split. `select_*` lines, where the runtime picks one of
+ * two trees for the same rule, count as merges of that rule.
+ *
+ * A `detect_error` outside a window opens one for `(error recovery)`. A
+ * token lexed again at a position already lexed is re-lexed work, counted
+ * separately during error recovery.
+ *
+ * Logging makes the parse many times slower, so each input is also parsed
+ * without a logger. The estimated time of a location is its share of the
+ * version steps of its input, times that parse time. The report is ranked
+ * by it.
+ */
+
+#define ERROR_RECOVERY "(error recovery)"
+#define NO_REDUCE "(no reduce)"
+#define NAME_LENGTH 256
+
+typedef Array(char*) StringList;
+
+typedef struct
+{
+    char* name;
+    /** An entry of `conflicts` or a rule with a `prec.dynamic`. */
+    bool declared;
+    uint32_t windows;
+    uint64_t versions_created;
+    uint32_t max_versions;
+    uint64_t merges;
+    uint64_t collapsed;
+    uint64_t steps;
+    uint64_t relexed_bytes;
+    uint64_t recovery_relexed_bytes;
+    double estimated_ns;
+} Conflict;
+
+typedef Array(Conflict) ConflictList;
+
+typedef struct
+{
+    uint32_t source;
+    uint32_t row;
+    uint32_t column;
+    /** Index into the conflicts while profiling, they are sorted after. */
+    uint32_t conflict;
+    const char* rule;
+    uint64_t versions_created;
+    uint32_t max_versions;
+    uint64_t merges;
+    uint64_t steps;
+    uint64_t relexed_bytes;
+    double estimated_ns;
+} Location;
+
+typedef Array(Location) LocationList;
+
+/** Open addressing set of the lexed positions of one input. */
+typedef struct
+{
+    uint64_t* slots;
+    uint32_t capacity;
+    uint32_t size;
+} PositionSet;
+
+typedef struct
+{
+    const StringList* declared;
+    ConflictList* conflicts;
+    LocationList* locations;
+    uint32_t source;
+
+    uint32_t version_count;
+    uint32_t row;
+    uint32_t column;
+    bool seen_process;
+    char step_declared[NAME_LENGTH];
+    char step_first[NAME_LENGTH];
+
+    bool in_window;
+    uint32_t window;
+    uint64_t window_steps;
+    bool recovering;
+
+    bool lex_pending;
+    uint64_t lex_position;
+    PositionSet lexed;
+
+    uint64_t steps;
+    uint64_t relexed_bytes;
+    uint64_t recovery_relexed_bytes;
+} Run;
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-glr [options] [path...]\n"
+            "\n"
+            "Parses the given files and directories (default: test/corpus) "
+            "with\n"
+            "a logger and prints the GLR ambiguities ranked by cost as "
+            "JSON.\n"
+            "\n"
+            "  --grammar FILE      grammar.json to take the declared "
+            "conflicts\n"
+            "                      from (default src/grammar.json)\n"
+            "  --top N             locations to list (default 30)\n"
+            "  --synthetic SPEC    add a generated source, kind[:amount]\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static bool contains(const StringList* list, const char* name)
+{
+    for (uint32_t i = 0; i < list->size; i++) {
+        if (strcmp(list->contents[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void add_unique(StringList* list, const char* name)
+{
+    if (!contains(list, name)) {
+        array_push(list, strdup(name));
+    }
+}
+
+/**
+ * The rules of `conflicts` and those with a PREC_DYNAMIC somewhere in
+ * their definition. Only the structure of grammar.json needed for that is
+ * followed: keys and strings, objects and arrays.
+ */
+static bool read_declared(const char* path, StringList* declared)
+{
+    char* data;
+    uint32_t length;
+    if (!bench_read_file(path, &data, &length)) {
+        return false;
+    }
+
+    enum { NONE, RULES, CONFLICTS } section = NONE;
+    BenchBuffer string = array_new();
+    char rule[NAME_LENGTH] = "";
+    uint32_t depth = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        char c = data[i];
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+            if (depth <= 1) {
+                section = depth == 1 ? section : NONE;
+            }
+        } else if (c == '"') {
+            array_clear(&string);
+            for (i++; i < length && data[i] != '"'; i++) {
+                if (data[i] == '\\' && i + 1 < length) {
+                    i++;
+                }
+                array_push(&string, data[i]);
+            }
+            array_push(&string, '\0');
+            uint32_t next = i + 1;
+            while (next < length && data[next] &&
+                   strchr(" \t\r\n", data[next])) {
+                next++;
+            }
+            bool key = next < length && data[next] == ':';
+
+            if (key && depth == 1) {
+                section = strcmp(string.contents, "rules") == 0 ? RULES
+                          : strcmp(string.contents, "conflicts") == 0
+                                  ? CONFLICTS
+                                  : NONE;
+            } else if (key && depth == 2 && section == RULES) {
+                snprintf(rule, sizeof(rule), "%s", string.contents);
+            } else if (!key && section == CONFLICTS) {
+                add_unique(declared, string.contents);
+            } else if (!key && section == RULES &&
+                       strcmp(string.contents, "PREC_DYNAMIC") == 0) {
+                add_unique(declared, rule);
+            }
+        }
+    }
+    array_delete(&string);
+    free(data);
+    return true;
+}
+
+static uint32_t conflict_for(Run* run, const char* name)
+{
+    ConflictList* conflicts = run->conflicts;
+    for (uint32_t i = 0; i < conflicts->size; i++) {
+        if (strcmp(conflicts->contents[i].name, name) == 0) {
+            return i;
+        }
+    }
+    Conflict conflict = {
+            .name = strdup(name),
+            .declared = contains(run->declared, name),
+    };
+    array_push(conflicts, conflict);
+    return conflicts->size - 1;
+}
+
+static bool position_insert(PositionSet* set, uint64_t position)
+{
+    if (2 * (set->size + 1) > set->capacity) {
+        PositionSet grown = {
+                .capacity = set->capacity ? 2 * set->capacity : 1024,
+        };
+        grown.slots = malloc(grown.capacity * sizeof(uint64_t));
+        memset(grown.slots, 0xff, grown.capacity * sizeof(uint64_t));
+        for (uint32_t i = 0; i < set->capacity; i++) {
+            if (set->slots[i] != UINT64_MAX) {
+                position_insert(&grown, set->slots[i]);
+            }
+        }
+        free(set->slots);
+        *set = grown;
+    }
+    uint32_t mask = set->capacity - 1;
+    uint32_t slot = (uint32_t)((position * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+    while (set->slots[slot] != UINT64_MAX) {
+        if (set->slots[slot] == position) {
+            return false;
+        }
+        slot = (slot + 1) & mask;
+    }
+    set->slots[slot] = position;
+    set->size++;
+    return true;
+}
+
+/** The symbol name after `prefix` up to `end`, e.g. "reduce sym:". */
+static void copy_name(char* name, const char* message, const char* prefix,
+                      const char* end)
+{
+    const char* start = message + strlen(prefix);
+    const char* stop = strstr(start, end);
+    size_t length = stop ? (size_t)(stop - start) : strlen(start);
+    if (length >= NAME_LENGTH) {
+        length = NAME_LENGTH - 1;
+    }
+    memcpy(name, start, length);
+    name[length] = '\0';
+}
+
+static void open_window(Run* run, const char* name)
+{
+    uint32_t conflict = conflict_for(run, name);
+    run->conflicts->contents[conflict].windows++;
+    Location location = {
+            .source = run->source,
+            .row = run->row,
+            .column = run->column,
+            .conflict = conflict,
+            .rule = run->conflicts->contents[conflict].name,
+    };
+    array_push(run->locations, location);
+    run->in_window = true;
+    run->window = run->locations->size - 1;
+    run->window_steps = 0;
+}
+
+static Location* window(Run* run)
+{
+    return &run->locations->contents[run->window];
+}
+
+static Conflict* window_conflict(Run* run)
+{
+    return &run->conflicts->contents[window(run)->conflict];
+}
+
+static void on_process(Run* run, uint32_t count, uint32_t row,
+                       uint32_t column)
+{
+    if (run->seen_process && count > run->version_count) {
+        const char* name = run->step_declared[0] ? run->step_declared
+                           : run->step_first[0]  ? run->step_first
+                                                 : NO_REDUCE;
+        // Splits inside a window are charged to the conflict that opened it.
+        if (!run->in_window) {
+            open_window(run, name);
+        }
+        uint32_t created = count - run->version_count;
+        window(run)->versions_created += created;
+        window_conflict(run)->versions_created += created;
+    } else if (run->in_window && count < run->version_count) {
+        window_conflict(run)->collapsed += run->version_count - count;
+    }
+
+    if (run->in_window && count == 1 && run->window_steps > 0) {
+        run->in_window = false;
+        run->recovering = false;
+    }
+    if (run->in_window) {
+        run->window_steps++;
+        window(run)->steps++;
+        window_conflict(run)->steps++;
+        if (count > window(run)->max_versions) {
+            window(run)->max_versions = count;
+        }
+        if (count > window_conflict(run)->max_versions) {
+            window_conflict(run)->max_versions = count;
+        }
+    }
+
+    run->steps++;
+    run->seen_process = true;
+    run->version_count = count;
+    run->row = row;
+    run->column = column;
+    run->step_declared[0] = '\0';
+    run->step_first[0] = '\0';
+}
+
+static void on_lexed(Run* run, uint32_t size)
+{
+    if (!run->lex_pending) {
+        return;
+    }
+    run->lex_pending = false;
+    if (position_insert(&run->lexed, run->lex_position)) {
+        return;
+    }
+    run->relexed_bytes += size;
+    run->recovery_relexed_bytes += run->recovering ? size : 0;
+    if (run->in_window) {
+        window(run)->relexed_bytes += size;
+        window_conflict(run)->relexed_bytes += size;
+        window_conflict(run)->recovery_relexed_bytes +=
+                run->recovering ? size : 0;
+    }
+}
+
+static void log_message(void* payload, TSLogType type, const char* message)
+{
+    Run* run = payload;
+    if (type != TSLogTypeParse) {
+        return;
+    }
+
+    unsigned version;
+    unsigned count;
+    int state;
+    unsigned row;
+    unsigned column;
+    char name[NAME_LENGTH];
+    if (sscanf(message,
+               "process version:%u, version_count:%u, state:%d, row:%u, "
+               "col:%u",
+               &version, &count, &state, &row, &column) == 5) {
+        on_process(run, count, row, column);
+    } else if (sscanf(message, "lex_internal state:%d, row:%u, column:%u",
+                      &state, &row, &column) == 3 ||
+               sscanf(message, "lex_external state:%d, row:%u, column:%u",
+                      &state, &row, &column) == 3) {
+        run->lex_pending = true;
+        run->lex_position = (uint64_t)row << 32 | column;
+    } else if (strncmp(message, "lexed_lookahead sym:", 20) == 0) {
+        const char* size = strstr(message, ", size:");
+        on_lexed(run, size ? (uint32_t)strtoul(size + 7, NULL, 10) : 0);
+    } else if (strncmp(message, "reduce sym:", 11) == 0) {
+        copy_name(name, message, "reduce sym:", ", child_count:");
+        if (!run->step_first[0]) {
+            memcpy(run->step_first, name, sizeof(name));
+        }
+        if (!run->step_declared[0] && contains(run->declared, name)) {
+            memcpy(run->step_declared, name, sizeof(name));
+        }
+    } else if (strncmp(message, "select_", 7) == 0) {
+        const char* symbol = strstr(message, "symbol:");
+        if (symbol) {
+            copy_name(name, symbol, "symbol:", ",");
+            run->conflicts->contents[conflict_for(run, name)].merges++;
+            if (run->in_window) {
+                window(run)->merges++;
+            }
+        }
+    } else if (strncmp(message, "detect_error", 12) == 0) {
+        if (!run->in_window) {
+            open_window(run, ERROR_RECOVERY);
+        }
+        run->recovering = true;
+    }
+}
+
+/** Runs one input, returns the parse time without a logger. */
+static uint64_t profile(TSParser* parser, Run* run, const BenchSource* source)
+{
+    uint64_t start = bench_now_ns();
+    TSTree* tree = ts_parser_parse_string(parser, NULL, source->data,
+                                          source->length);
+    uint64_t parse_ns = bench_now_ns() - start;
+    ts_tree_delete(tree);
+
+    ts_parser_set_logger(parser, (TSLogger){run, log_message});
+    tree = ts_parser_parse_string(parser, NULL, source->data, source->length);
+    ts_parser_set_logger(parser, (TSLogger){NULL, NULL});
+    ts_tree_delete(tree);
+    return parse_ns;
+}
+
+static int compare_conflicts(const void* a, const void* b)
+{
+    const Conflict* left = a;
+    const Conflict* right = b;
+    if (left->estimated_ns != right->estimated_ns) {
+        return left->estimated_ns > right->estimated_ns ? -1 : 1;
+    }
+    return strcmp(left->name, right->name);
+}
+
+static int compare_locations(const void* a, const void* b)
+{
+    const Location* left = a;
+    const Location* right = b;
+    if (left->estimated_ns != right->estimated_ns) {
+        return left->estimated_ns > right->estimated_ns ? -1 : 1;
+    }
+    return left->steps > right->steps ? -1 : left->steps < right->steps;
+}
+
+/** The source line of the location, up to 80 bytes, for the report. */
+static void write_line(FILE* out, const BenchSource* source, uint32_t row)
+{
+    const char* line = source->data;
+    const char* end = source->data + source->length;
+    for (uint32_t i = 0; i < row && line < end; i++) {
+        const char* newline = memchr(line, '\n', (size_t)(end - line));
+        line = newline ? newline + 1 : end;
+    }
+    size_t length = strcspn(line, "\r\n");
+    if (length > 80) {
+        length = 80;
+    }
+    if ((size_t)(end - line) < length) {
+        length = (size_t)(end - line);
+    }
+    char text[81];
+    memcpy(text, line, length);
+    text[length] = '\0';
+    bench_json_string(out, text);
+}
+
+int main(int argc, char** argv)
+{
+    BenchSourceList sources = array_new();
+    const char* grammar_path = "src/grammar.json";
+    uint32_t top = 30;
+    const char* output_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--grammar") == 0 && i + 1 < argc) {
+            grammar_path = argv[++i];
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            if (!bench_collect_synthetic(&sources, argv[++i])) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else if (!bench_collect_path(&sources, argv[i])) {
+            return 1;
+        }
+    }
+    if (sources.size == 0 && !bench_collect_path(&sources, "test/corpus")) {
+        return 1;
+    }
+
+    StringList declared = array_new();
+    if (!read_declared(grammar_path, &declared)) {
+        fprintf(stderr, "failed to read %s\n", grammar_path);
+        return 1;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+    ConflictList conflicts = array_new();
+    LocationList locations = array_new();
+    uint64_t parse_ns = 0;
+    uint64_t bytes = 0;
+    uint64_t steps = 0;
+    uint64_t relexed_bytes = 0;
+    uint64_t recovery_relexed_bytes = 0;
+
+    for (uint32_t i = 0; i < sources.size; i++) {
+        Run run = {
+                .declared = &declared,
+                .conflicts = &conflicts,
+                .locations = &locations,
+                .source = i,
+        };
+        uint32_t first_location = locations.size;
+        uint64_t ns = profile(parser, &run, &sources.contents[i]);
+        for (uint32_t l = first_location; l < locations.size; l++) {
+            Location* location = &locations.contents[l];
+            location->estimated_ns =
+                    run.steps ? (double)ns * location->steps / run.steps : 0.0;
+            conflicts.contents[location->conflict].estimated_ns +=
+                    location->estimated_ns;
+        }
+        parse_ns += ns;
+        bytes += sources.contents[i].length;
+        steps += run.steps;
+        relexed_bytes += run.relexed_bytes;
+        recovery_relexed_bytes += run.recovery_relexed_bytes;
+        free(run.lexed.slots);
+    }
+
+    if (conflicts.size > 1) {
+        qsort(conflicts.contents, conflicts.size, sizeof(Conflict),
+              compare_conflicts);
+    }
+    fprintf(out, "{\n  \"inputs\": %u,\n", sources.size);
+    fprintf(out, "  \"bytes\": %llu,\n", (unsigned long long)bytes);
+    fprintf(out, "  \"parse_ns\": %llu,\n", (unsigned long long)parse_ns);
+    fprintf(out, "  \"version_steps\": %llu,\n", (unsigned long long)steps);
+    fprintf(out, "  \"relexed_bytes\": %llu,\n",
+            (unsigned long long)relexed_bytes);
+    fprintf(out, "  \"recovery_relexed_bytes\": %llu,\n",
+            (unsigned long long)recovery_relexed_bytes);
+    fprintf(out, "  \"conflicts\": [");
+    for (uint32_t i = 0; i < conflicts.size; i++) {
+        const Conflict* conflict = &conflicts.contents[i];
+        fprintf(out, "%s\n    {\"rule\": ", i ? "," : "");
+        bench_json_string(out, conflict->name);
+        fprintf(out,
+                ", \"declared\": %s, \"windows\": %u, "
+                "\"versions_created\": %llu,\n"
+                "     \"max_versions\": %u, \"merges\": %llu, "
+                "\"collapsed\": %llu, \"steps\": %llu,\n"
+                "     \"relexed_bytes\": %llu, "
+                "\"recovery_relexed_bytes\": %llu, \"estimated_ns\": %.0f, "
+                "\"share\": %.4f}",
+                conflict->declared ? "true" : "false", conflict->windows,
+                (unsigned long long)conflict->versions_created,
+                conflict->max_versions, (unsigned long long)conflict->merges,
+                (unsigned long long)conflict->collapsed,
+                (unsigned long long)conflict->steps,
+                (unsigned long long)conflict->relexed_bytes,
+                (unsigned long long)conflict->recovery_relexed_bytes,
+                conflict->estimated_ns,
+                parse_ns ? conflict->estimated_ns / parse_ns : 0.0);
+    }
+    fprintf(out, "\n  ],\n  \"locations\": [");
+    if (locations.size > 1) {
+        qsort(locations.contents, locations.size, sizeof(Location),
+              compare_locations);
+    }
+    for (uint32_t i = 0; i < locations.size && i < top; i++) {
+        const Location* location = &locations.contents[i];
+        const BenchSource* source = &sources.contents[location->source];
+        fprintf(out, "%s\n    {\"rule\": ", i ? "," : "");
+        bench_json_string(out, location->rule);
+        fprintf(out, ", \"source\": ");
+        bench_json_string(out, source->name);
+        fprintf(out,
+                ", \"row\": %u, \"column\": %u,\n"
+                "     \"versions_created\": %llu, \"max_versions\": %u, "
+                "\"merges\": %llu, \"steps\": %llu,\n"
+                "     \"relexed_bytes\": %llu, \"estimated_ns\": %.0f,\n"
+                "     \"line\": ",
+                location->row + 1, location->column + 1,
+                (unsigned long long)location->versions_created,
+                location->max_versions, (unsigned long long)location->merges,
+                (unsigned long long)location->steps,
+                (unsigned long long)location->relexed_bytes,
+                location->estimated_ns);
+        write_line(out, source, location->row);
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    ts_parser_delete(parser);
+    for (uint32_t i = 0; i < conflicts.size; i++) {
+        free(conflicts.contents[i].name);
+    }
+    for (uint32_t i = 0; i < declared.size; i++) {
+        free(declared.contents[i]);
+    }
+    array_delete(&conflicts);
+    array_delete(&locations);
+    array_delete(&declared);
+    bench_sources_delete(&sources);
+    return 0;
+}
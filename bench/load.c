@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * Shared library load benchmark.
+ *
+ * Loads the parser library with `dlopen`, resolves `tree_sitter_abap` and
+ * parses a single statement with it, then unloads it again. The load covers
+ * the dynamic linker's work, which grows with the number of exported symbols
+ * and relocations, the first parse the page faults of the tables it touches.
+ * Used to compare the default build with the optimized one, see
+ * `scripts/compare-release-build.sh`.
+ */
+
+typedef const TSLanguage* (*LanguageFunction)(void);
+
+#ifdef __APPLE__
+static const char* default_library = "./libtree-sitter-abap.dylib";
+#else
+static const char* default_library = "./libtree-sitter-abap.so";
+#endif
+
+static const char sample[] = "DATA(result) = to_upper( text ).\n";
+
+static void usage(FILE* out)
+{
+    fprintf(out, "usage: abap-bench-load [options] [library]\n"
+                 "\n"
+                 "Loads the parser library (default %s) repeatedly\n"
+                 "and prints the load and first parse latency as JSON.\n"
+                 "\n"
+                 "  --repeat N          loads (default 100)\n"
+                 "  --output FILE       write the JSON to FILE instead of "
+                 "stdout\n",
+            default_library);
+}
+
+int main(int argc, char** argv)
+{
+    const char* library = default_library;
+    uint32_t repeat = 100;
+    const char* output_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            library = argv[i];
+        }
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    struct stat info;
+    if (stat(library, &info) != 0) {
+        fprintf(stderr, "no such file: %s\n", library);
+        return 1;
+    }
+
+    BenchSamples load_runs = array_new();
+    BenchSamples parse_runs = array_new();
+    for (uint32_t run = 0; run < repeat; run++) {
+        uint64_t start = bench_now_ns();
+        void* handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+        if (!handle) {
+            fprintf(stderr, "%s\n", dlerror());
+            return 1;
+        }
+        // ISO C has no conversion from object to function pointers.
+        union
+        {
+            void* symbol;
+            LanguageFunction function;
+        } lookup = {.symbol = dlsym(handle, "tree_sitter_abap")};
+        LanguageFunction language = lookup.function;
+        if (!language) {
+            fprintf(stderr, "%s\n", dlerror());
+            return 1;
+        }
+        uint64_t loaded = bench_now_ns();
+
+        TSParser* parser = ts_parser_new();
+        ts_parser_set_language(parser, language());
+        TSTree* tree = ts_parser_parse_string(parser, NULL, sample,
+                                              sizeof(sample) - 1);
+        uint64_t parsed = bench_now_ns();
+
+        ts_tree_delete(tree);
+        ts_parser_delete(parser);
+        dlclose(handle);
+        array_push(&load_runs, loaded - start);
+        array_push(&parse_runs, parsed - loaded);
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    // The first run is the only one that may find the library cold.
+    uint64_t first_load = load_runs.contents[0];
+    uint64_t first_parse = parse_runs.contents[0];
+    fprintf(out, "{\n  \"library\": ");
+    bench_json_string(out, library);
+    fprintf(out, ",\n");
+    fprintf(out, "  \"bytes\": %lld,\n", (long long)info.st_size);
+    fprintf(out, "  \"repeat\": %u,\n", repeat);
+    fprintf(out, "  \"first_load_ns\": %llu,\n",
+            (unsigned long long)first_load);
+    fprintf(out, "  \"first_parse_ns\": %llu,\n",
+            (unsigned long long)first_parse);
+    fprintf(out, "  \"load_p50_ns\": %llu,\n",
+            (unsigned long long)bench_percentile(&load_runs, 50));
+    fprintf(out, "  \"load_p99_ns\": %llu,\n",
+            (unsigned long long)bench_percentile(&load_runs, 99));
+    fprintf(out, "  \"first_parse_p50_ns\": %llu,\n",
+            (unsigned long long)bench_percentile(&parse_runs, 50));
+    fprintf(out, "  \"first_parse_p99_ns\": %llu\n}\n",
+            (unsigned long long)bench_percentile(&parse_runs, 99));
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    array_delete(&load_runs);
+    array_delete(&parse_runs);
+    return 0;
+}
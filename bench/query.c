@@ -0,0 +1,721 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <dirent.h>
+#include <regex.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * Query benchmark.
+ *
+ * Measures how long a query takes to compile and how fast its captures are
+ * produced on parsed sources, the two costs an editor pays for highlighting:
+ * once at startup and on every visible range.
+ *
+ * The runtime leaves text predicates to the host, so they are evaluated
+ * here the way editors do it, once per match: `#match?` with a POSIX
+ * extended regex, `#any-of?` and `#eq?` by string comparison. The regexes
+ * are compiled together with the query and count towards its compile time.
+ *
+ * The cursor runs with the match limit of the editors, matches dropped
+ * because of it are invisible to the user, so every source that exceeds the
+ * limit is reported. To find the patterns that make up the cost, each
+ * pattern is compiled and run on its own, the slowest ones are reported with
+ * their line in the query.
+ */
+
+typedef enum
+{
+    PREDICATE_MATCH,
+    PREDICATE_ANY_OF,
+    PREDICATE_EQ,
+} PredicateKind;
+
+typedef struct
+{
+    const char* data;
+    uint32_t length;
+} StringView;
+
+typedef struct
+{
+    PredicateKind kind;
+    bool negated;
+    uint32_t capture;
+    // `#eq?` against another capture rather than a string
+    int64_t other_capture;
+    regex_t regex;
+    Array(StringView) values;
+} Predicate;
+
+typedef struct
+{
+    Array(Predicate) predicates;
+    uint64_t matches;
+    uint64_t captures;
+    uint64_t predicate_ns;
+} Pattern;
+
+typedef struct
+{
+    TSQuery* query;
+    Array(Pattern) patterns;
+    uint32_t regexes;
+    uint32_t string_sets;
+    uint32_t unsupported;
+} CompiledQuery;
+
+typedef struct
+{
+    uint64_t exec_ns;
+    uint64_t predicate_ns;
+    uint64_t matches;
+    uint64_t rejected;
+    uint64_t captures;
+    bool exceeded_match_limit;
+} Totals;
+
+/** Patterns sharing the same source, e.g. the branches of an alternation. */
+typedef struct
+{
+    uint32_t first_pattern;
+    uint32_t pattern_count;
+    uint32_t line;
+    uint64_t exec_ns;
+} PatternCost;
+
+typedef struct
+{
+    char* path;
+    char* source;
+    uint32_t length;
+    CompiledQuery compiled;
+    uint64_t compile_ns;
+    Totals totals;
+    Array(uint32_t) exceeded_sources;
+    Array(PatternCost) pattern_costs;
+    uint64_t isolated_ns;
+} QueryResult;
+
+typedef Array(QueryResult) QueryResultList;
+
+static const char* default_paths[] = {"test/highlight"};
+static const char* default_synthetic[] = {"report:4m"};
+static const char* default_queries = "queries";
+
+// Neovim highlights with this match limit.
+#define DEFAULT_MATCH_LIMIT 256
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-query [options] [path...]\n"
+            "\n"
+            "Compiles queries and runs them over the given files and\n"
+            "directories (default: test/highlight and synthetic report:4m).\n"
+            "\n"
+            "  --query PATH        query file or directory of *.scm files,\n"
+            "                      may be repeated (default queries)\n"
+            "  --repeat N          compiles and runs per source (default 5)\n"
+            "  --match-limit N     cursor match limit, 0 for none (default "
+            "256)\n"
+            "  --slowest N         patterns to report per query, 0 skips the\n"
+            "                      attribution (default 10)\n"
+            "  --synthetic SPEC    add a generated source, kind[:amount]\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static StringView string_value(const TSQuery* query, uint32_t id)
+{
+    StringView view;
+    view.data = ts_query_string_value_for_id(query, id, &view.length);
+    return view;
+}
+
+static bool string_equals(StringView view, const char* value)
+{
+    return strlen(value) == view.length &&
+           memcmp(view.data, value, view.length) == 0;
+}
+
+/**
+ * Reads the text predicates of every pattern. Predicates the benchmark does
+ * not know, such as `#set!`, are counted and otherwise ignored.
+ */
+static bool compile_predicates(CompiledQuery* compiled, BenchBuffer* scratch)
+{
+    uint32_t pattern_count = ts_query_pattern_count(compiled->query);
+    for (uint32_t p = 0; p < pattern_count; p++) {
+        Pattern pattern = {0};
+        uint32_t step_count;
+        const TSQueryPredicateStep* steps =
+                ts_query_predicates_for_pattern(compiled->query, p,
+                                                &step_count);
+
+        for (uint32_t start = 0; start < step_count;) {
+            uint32_t end = start;
+            while (end < step_count &&
+                   steps[end].type != TSQueryPredicateStepTypeDone) {
+                end++;
+            }
+            uint32_t count = end - start;
+            const TSQueryPredicateStep* step = &steps[start];
+            start = end + 1;
+
+            StringView name = string_value(compiled->query, step[0].value_id);
+            Predicate predicate = {.other_capture = -1};
+            if (string_equals(name, "match?") ||
+                string_equals(name, "not-match?")) {
+                predicate.kind = PREDICATE_MATCH;
+            } else if (string_equals(name, "any-of?") ||
+                       string_equals(name, "not-any-of?")) {
+                predicate.kind = PREDICATE_ANY_OF;
+            } else if (string_equals(name, "eq?") ||
+                       string_equals(name, "not-eq?")) {
+                predicate.kind = PREDICATE_EQ;
+            } else {
+                compiled->unsupported++;
+                continue;
+            }
+            predicate.negated = name.data[0] == 'n';
+
+            if (count < 3 || step[1].type != TSQueryPredicateStepTypeCapture) {
+                fprintf(stderr, "malformed #%.*s in pattern %u\n",
+                        (int)name.length, name.data, p);
+                return false;
+            }
+            predicate.capture = step[1].value_id;
+            for (uint32_t i = 2; i < count; i++) {
+                if (step[i].type == TSQueryPredicateStepTypeCapture) {
+                    predicate.other_capture = step[i].value_id;
+                } else {
+                    array_push(&predicate.values,
+                               string_value(compiled->query,
+                                            step[i].value_id));
+                }
+            }
+
+            if (predicate.kind == PREDICATE_MATCH) {
+                StringView pattern_text = *array_front(&predicate.values);
+                array_clear(scratch);
+                array_extend(scratch, pattern_text.length, pattern_text.data);
+                array_push(scratch, '\0');
+                if (regcomp(&predicate.regex, scratch->contents,
+                            REG_EXTENDED | REG_NOSUB) != 0) {
+                    fprintf(stderr, "invalid regex in pattern %u: %s\n", p,
+                            scratch->contents);
+                    return false;
+                }
+                compiled->regexes++;
+            } else if (predicate.kind == PREDICATE_ANY_OF) {
+                compiled->string_sets++;
+            }
+            array_push(&pattern.predicates, predicate);
+        }
+        array_push(&compiled->patterns, pattern);
+    }
+    return true;
+}
+
+static void compiled_query_delete(CompiledQuery* compiled)
+{
+    for (uint32_t p = 0; p < compiled->patterns.size; p++) {
+        Pattern* pattern = &compiled->patterns.contents[p];
+        for (uint32_t i = 0; i < pattern->predicates.size; i++) {
+            Predicate* predicate = &pattern->predicates.contents[i];
+            if (predicate->kind == PREDICATE_MATCH) {
+                regfree(&predicate->regex);
+            }
+            array_delete(&predicate->values);
+        }
+        array_delete(&pattern->predicates);
+    }
+    array_delete(&compiled->patterns);
+    if (compiled->query) {
+        ts_query_delete(compiled->query);
+    }
+    *compiled = (CompiledQuery){0};
+}
+
+static bool compile_query(CompiledQuery* compiled, const char* source,
+                          uint32_t length, BenchBuffer* scratch)
+{
+    uint32_t error_offset;
+    TSQueryError error_type;
+    compiled->query = ts_query_new(tree_sitter_abap(), source, length,
+                                   &error_offset, &error_type);
+    if (!compiled->query) {
+        fprintf(stderr, "query error %d at offset %u\n", (int)error_type,
+                error_offset);
+        return false;
+    }
+    return compile_predicates(compiled, scratch);
+}
+
+/** The text of the first node of a capture, empty if it did not capture. */
+static bool capture_text(const TSQueryMatch* match, uint32_t capture,
+                         const char* source, StringView* text)
+{
+    for (uint16_t i = 0; i < match->capture_count; i++) {
+        if (match->captures[i].index == capture) {
+            uint32_t start = ts_node_start_byte(match->captures[i].node);
+            text->data = source + start;
+            text->length = ts_node_end_byte(match->captures[i].node) - start;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool evaluate(const Predicate* predicate, const TSQueryMatch* match,
+                     const char* source, BenchBuffer* scratch)
+{
+    StringView text;
+    if (!capture_text(match, predicate->capture, source, &text)) {
+        // an optional capture that is absent does not reject the match
+        return true;
+    }
+
+    bool result = false;
+    switch (predicate->kind) {
+        case PREDICATE_MATCH:
+            array_clear(scratch);
+            array_extend(scratch, text.length, text.data);
+            array_push(scratch, '\0');
+            result = regexec(&predicate->regex, scratch->contents, 0, NULL,
+                             0) == 0;
+            break;
+        case PREDICATE_ANY_OF:
+        case PREDICATE_EQ:
+            if (predicate->other_capture >= 0) {
+                StringView other;
+                result = capture_text(match,
+                                      (uint32_t)predicate->other_capture,
+                                      source, &other) &&
+                         other.length == text.length &&
+                         memcmp(other.data, text.data, text.length) == 0;
+                break;
+            }
+            for (uint32_t i = 0; i < predicate->values.size && !result; i++) {
+                StringView value = predicate->values.contents[i];
+                result = value.length == text.length &&
+                         memcmp(value.data, text.data, text.length) == 0;
+            }
+            break;
+    }
+    return result != predicate->negated;
+}
+
+static void run_query(CompiledQuery* compiled, TSQueryCursor* cursor,
+                      const TSTree* tree, const BenchSource* source,
+                      BenchBuffer* scratch, Totals* totals)
+{
+    uint64_t start = bench_now_ns();
+    ts_query_cursor_exec(cursor, compiled->query, ts_tree_root_node(tree));
+
+    TSQueryMatch match;
+    while (ts_query_cursor_next_match(cursor, &match)) {
+        Pattern* pattern = &compiled->patterns.contents[match.pattern_index];
+        bool accepted = true;
+        if (pattern->predicates.size > 0) {
+            uint64_t predicate_start = bench_now_ns();
+            for (uint32_t i = 0; i < pattern->predicates.size && accepted;
+                 i++) {
+                accepted = evaluate(&pattern->predicates.contents[i], &match,
+                                    source->data, scratch);
+            }
+            uint64_t predicate_ns = bench_now_ns() - predicate_start;
+            pattern->predicate_ns += predicate_ns;
+            totals->predicate_ns += predicate_ns;
+        }
+        pattern->matches++;
+        totals->matches++;
+        if (accepted) {
+            pattern->captures += match.capture_count;
+            totals->captures += match.capture_count;
+        } else {
+            totals->rejected++;
+        }
+    }
+    totals->exec_ns += bench_now_ns() - start;
+    totals->exceeded_match_limit =
+            ts_query_cursor_did_exceed_match_limit(cursor);
+}
+
+static int compare_names(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static bool has_suffix(const char* name, const char* suffix)
+{
+    size_t length = strlen(name);
+    size_t suffix_length = strlen(suffix);
+    return length >= suffix_length &&
+           strcmp(name + length - suffix_length, suffix) == 0;
+}
+
+static bool add_query(QueryResultList* queries, const char* path)
+{
+    QueryResult result = {.path = strdup(path)};
+    if (!bench_read_file(path, &result.source, &result.length)) {
+        fprintf(stderr, "failed to read %s\n", path);
+        free(result.path);
+        return false;
+    }
+    array_push(queries, result);
+    return true;
+}
+
+/** Adds a query file or, sorted by name, the `*.scm` files of a directory. */
+static bool collect_queries(QueryResultList* queries, const char* path)
+{
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        fprintf(stderr, "no such file or directory: %s\n", path);
+        return false;
+    }
+    if (!S_ISDIR(info.st_mode)) {
+        return add_query(queries, path);
+    }
+
+    DIR* directory = opendir(path);
+    if (!directory) {
+        return false;
+    }
+    Array(char*) entries = array_new();
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL) {
+        if (entry->d_name[0] != '.' && has_suffix(entry->d_name, ".scm")) {
+            array_push(&entries, strdup(entry->d_name));
+        }
+    }
+    closedir(directory);
+    qsort(entries.contents, entries.size, sizeof(char*), compare_names);
+
+    bool ok = true;
+    for (uint32_t i = 0; i < entries.size; i++) {
+        BenchBuffer child = array_new();
+        bench_buffer_appendf(&child, "%s/%s", path, entries.contents[i]);
+        array_push(&child, '\0');
+        ok = add_query(queries, child.contents) && ok;
+        array_delete(&child);
+        free(entries.contents[i]);
+    }
+    array_delete(&entries);
+    return ok;
+}
+
+static uint32_t line_of(const char* source, uint32_t offset)
+{
+    uint32_t line = 1;
+    for (uint32_t i = 0; i < offset; i++) {
+        line += source[i] == '\n';
+    }
+    return line;
+}
+
+static int compare_costs(const void* a, const void* b)
+{
+    uint64_t left = ((const PatternCost*)a)->exec_ns;
+    uint64_t right = ((const PatternCost*)b)->exec_ns;
+    return left < right ? 1 : left > right ? -1 : 0;
+}
+
+/**
+ * Runs every pattern of the query on its own over all sources and keeps the
+ * slowest. Patterns are compiled from their own source range, so branches of
+ * a top level alternation are measured together.
+ */
+static void attribute_patterns(QueryResult* result, TSTree** trees,
+                               const BenchSourceList* sources,
+                               TSQueryCursor* cursor, BenchBuffer* scratch,
+                               uint32_t slowest)
+{
+    const TSQuery* query = result->compiled.query;
+    uint32_t pattern_count = ts_query_pattern_count(query);
+    for (uint32_t p = 0; p < pattern_count;) {
+        uint32_t start = ts_query_start_byte_for_pattern(query, p);
+        uint32_t end = ts_query_end_byte_for_pattern(query, p);
+        uint32_t next = p + 1;
+        while (next < pattern_count &&
+               ts_query_start_byte_for_pattern(query, next) == start) {
+            next++;
+        }
+
+        PatternCost cost = {
+                .first_pattern = p,
+                .pattern_count = next - p,
+                .line = line_of(result->source, start),
+        };
+        CompiledQuery single = {0};
+        if (compile_query(&single, result->source + start, end - start,
+                          scratch)) {
+            for (uint32_t i = 0; i < sources->size; i++) {
+                Totals totals = {0};
+                run_query(&single, cursor, trees[i], &sources->contents[i],
+                          scratch, &totals);
+                cost.exec_ns += totals.exec_ns;
+            }
+        }
+        compiled_query_delete(&single);
+
+        result->isolated_ns += cost.exec_ns;
+        array_push(&result->pattern_costs, cost);
+        p = next;
+    }
+
+    if (result->pattern_costs.size > 1) {
+        qsort(result->pattern_costs.contents, result->pattern_costs.size,
+              sizeof(PatternCost), compare_costs);
+    }
+    if (result->pattern_costs.size > slowest) {
+        result->pattern_costs.size = slowest;
+    }
+}
+
+static void print_query(FILE* out, QueryResult* result,
+                        const BenchSourceList* sources, uint64_t bytes,
+                        uint64_t parse_ns, uint32_t repeat)
+{
+    const Totals* totals = &result->totals;
+    double seconds = totals->exec_ns / 1e9;
+    fprintf(out, "    {\n      \"query\": ");
+    bench_json_string(out, result->path);
+    fprintf(out, ",\n");
+    fprintf(out, "      \"patterns\": %u,\n",
+            ts_query_pattern_count(result->compiled.query));
+    fprintf(out, "      \"regex_predicates\": %u,\n",
+            result->compiled.regexes);
+    fprintf(out, "      \"string_set_predicates\": %u,\n",
+            result->compiled.string_sets);
+    fprintf(out, "      \"unsupported_predicates\": %u,\n",
+            result->compiled.unsupported);
+    fprintf(out, "      \"compile_ns\": %llu,\n",
+            (unsigned long long)result->compile_ns);
+    fprintf(out, "      \"exec_ns\": %llu,\n",
+            (unsigned long long)totals->exec_ns);
+    fprintf(out, "      \"predicate_ns\": %llu,\n",
+            (unsigned long long)totals->predicate_ns);
+    fprintf(out, "      \"matches\": %llu,\n",
+            (unsigned long long)totals->matches);
+    fprintf(out, "      \"rejected_matches\": %llu,\n",
+            (unsigned long long)totals->rejected);
+    fprintf(out, "      \"captures\": %llu,\n",
+            (unsigned long long)totals->captures);
+    fprintf(out, "      \"mb_per_s\": %.3f,\n",
+            seconds > 0 ? bytes * repeat / (1024.0 * 1024.0) / seconds : 0.0);
+    fprintf(out, "      \"ns_per_capture\": %.3f,\n",
+            totals->captures ? (double)totals->exec_ns / totals->captures
+                             : 0.0);
+    // Relative to parsing the same sources, comparable across machines.
+    fprintf(out, "      \"exec_to_parse\": %.4f,\n",
+            parse_ns ? (double)totals->exec_ns / repeat / parse_ns : 0.0);
+
+    fprintf(out, "      \"match_limit_exceeded\": [");
+    for (uint32_t i = 0; i < result->exceeded_sources.size; i++) {
+        if (i > 0) {
+            fprintf(out, ", ");
+        }
+        uint32_t source = result->exceeded_sources.contents[i];
+        bench_json_string(out, sources->contents[source].name);
+    }
+    fprintf(out, "],\n");
+
+    fprintf(out, "      \"slowest_patterns\": [");
+    for (uint32_t i = 0; i < result->pattern_costs.size; i++) {
+        const PatternCost* cost = &result->pattern_costs.contents[i];
+        uint64_t matches = 0, captures = 0, predicate_ns = 0;
+        for (uint32_t p = 0; p < cost->pattern_count; p++) {
+            const Pattern* pattern =
+                    &result->compiled.patterns
+                             .contents[cost->first_pattern + p];
+            matches += pattern->matches;
+            captures += pattern->captures;
+            predicate_ns += pattern->predicate_ns;
+        }
+        fprintf(out,
+                "%s\n        {\"line\": %u, \"patterns\": %u, "
+                "\"exec_ns\": %llu, \"share\": %.4f, \"matches\": %llu, "
+                "\"captures\": %llu, \"predicate_ns\": %llu}",
+                i ? "," : "", cost->line, cost->pattern_count,
+                (unsigned long long)cost->exec_ns,
+                result->isolated_ns ? (double)cost->exec_ns /
+                                              result->isolated_ns
+                                    : 0.0,
+                (unsigned long long)matches, (unsigned long long)captures,
+                (unsigned long long)predicate_ns);
+    }
+    fprintf(out, "%s]\n    }", result->pattern_costs.size ? "\n      " : "");
+}
+
+static void query_result_delete(QueryResult* result)
+{
+    compiled_query_delete(&result->compiled);
+    array_delete(&result->exceeded_sources);
+    array_delete(&result->pattern_costs);
+    free(result->source);
+    free(result->path);
+}
+
+int main(int argc, char** argv)
+{
+    BenchSourceList sources = array_new();
+    QueryResultList queries = array_new();
+    uint32_t repeat = 5;
+    uint32_t match_limit = DEFAULT_MATCH_LIMIT;
+    uint32_t slowest = 10;
+    const char* output_path = NULL;
+    bool explicit_inputs = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            if (!collect_queries(&queries, argv[++i])) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--match-limit") == 0 && i + 1 < argc) {
+            match_limit = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--slowest") == 0 && i + 1 < argc) {
+            slowest = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            explicit_inputs = true;
+            if (!bench_collect_synthetic(&sources, argv[++i])) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            explicit_inputs = true;
+            if (!bench_collect_path(&sources, argv[i])) {
+                return 1;
+            }
+        }
+    }
+
+    if (!explicit_inputs) {
+        for (size_t i = 0; i < sizeof(default_paths) / sizeof(char*); i++) {
+            bench_collect_path(&sources, default_paths[i]);
+        }
+        for (size_t i = 0; i < sizeof(default_synthetic) / sizeof(char*);
+             i++) {
+            bench_collect_synthetic(&sources, default_synthetic[i]);
+        }
+    }
+    if (queries.size == 0 && !collect_queries(&queries, default_queries)) {
+        return 1;
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    // The sources are parsed once, the parse time is the reference the query
+    // time is reported against.
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+    TSTree** trees = calloc(sources.size ? sources.size : 1, sizeof(TSTree*));
+    uint64_t parse_ns = 0;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < sources.size; i++) {
+        const BenchSource* source = &sources.contents[i];
+        uint64_t start = bench_now_ns();
+        trees[i] = ts_parser_parse_string(parser, NULL, source->data,
+                                          source->length);
+        parse_ns += bench_now_ns() - start;
+        bytes += source->length;
+    }
+
+    BenchBuffer scratch = array_new();
+    BenchSamples compile_runs = array_new();
+    TSQueryCursor* cursor = ts_query_cursor_new();
+    if (match_limit > 0) {
+        ts_query_cursor_set_match_limit(cursor, match_limit);
+    }
+
+    for (uint32_t q = 0; q < queries.size; q++) {
+        QueryResult* result = &queries.contents[q];
+
+        // Compile time is the median of separate compilations, the last one
+        // is kept for the runs.
+        array_clear(&compile_runs);
+        for (uint32_t run = 0; run < repeat; run++) {
+            compiled_query_delete(&result->compiled);
+            uint64_t start = bench_now_ns();
+            if (!compile_query(&result->compiled, result->source,
+                               result->length, &scratch)) {
+                fprintf(stderr, "in %s\n", result->path);
+                return 1;
+            }
+            array_push(&compile_runs, bench_now_ns() - start);
+        }
+        result->compile_ns = bench_percentile(&compile_runs, 50);
+
+        for (uint32_t i = 0; i < sources.size; i++) {
+            bool exceeded = false;
+            for (uint32_t run = 0; run < repeat; run++) {
+                run_query(&result->compiled, cursor, trees[i],
+                          &sources.contents[i], &scratch, &result->totals);
+                exceeded |= result->totals.exceeded_match_limit;
+            }
+            if (exceeded) {
+                array_push(&result->exceeded_sources, i);
+            }
+        }
+
+        if (slowest > 0) {
+            attribute_patterns(result, trees, &sources, cursor, &scratch,
+                               slowest);
+        }
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"repeat\": %u,\n", repeat);
+    fprintf(out, "  \"match_limit\": %u,\n", match_limit);
+    fprintf(out, "  \"files\": %u,\n", sources.size);
+    fprintf(out, "  \"bytes\": %llu,\n", (unsigned long long)bytes);
+    fprintf(out, "  \"parse_ns\": %llu,\n", (unsigned long long)parse_ns);
+    fprintf(out, "  \"queries\": [\n");
+    for (uint32_t q = 0; q < queries.size; q++) {
+        print_query(out, &queries.contents[q], &sources, bytes, parse_ns,
+                    repeat);
+        fprintf(out, q + 1 < queries.size ? ",\n" : "\n");
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    for (uint32_t q = 0; q < queries.size; q++) {
+        query_result_delete(&queries.contents[q]);
+    }
+    array_delete(&queries);
+    for (uint32_t i = 0; i < sources.size; i++) {
+        ts_tree_delete(trees[i]);
+    }
+    free(trees);
+    ts_query_cursor_delete(cursor);
+    ts_parser_delete(parser);
+    array_delete(&compile_runs);
+    array_delete(&scratch);
+    bench_sources_delete(&sources);
+    return 0;
+}
@@ -0,0 +1,644 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Incremental reparse benchmark.
+ *
+ * Replays edit scripts (see bench/edits) against a source. Every edit is
+ * applied to the buffer and the previous tree, then the incremental
+ * `ts_parser_parse` and `ts_tree_get_changed_ranges` are timed separately.
+ *
+ * Timing runs without a logger. Afterwards, each edit is replayed once more
+ * with a logger attached to count how many bytes the lexer and the external
+ * scanner walked over to produce the new tree, which is what makes a one
+ * character edit in a long comment or docstring expensive.
+ */
+
+typedef enum
+{
+    OP_GOTO,
+    OP_FIND,
+    OP_TYPE,
+    OP_INSERT,
+    OP_DELETE,
+    OP_BACKSPACE,
+    OP_TOGGLE_COMMENT,
+} OpKind;
+
+typedef struct
+{
+    OpKind kind;
+    char* text;
+    uint32_t first;
+    uint32_t second;
+} Op;
+
+typedef struct
+{
+    char* path;
+    char* source_spec;
+    Array(Op) ops;
+} Script;
+
+typedef struct
+{
+    BenchSamples parse_ns;
+    BenchSamples changed_ranges_ns;
+    BenchSamples lexed_bytes;
+    BenchSamples changed_bytes;
+    uint64_t full_parse_ns;
+    uint32_t source_bytes;
+    uint32_t edits;
+} Result;
+
+typedef struct
+{
+    uint64_t lexed_bytes;
+} LexCounter;
+
+/** An edit together with the text it inserted, so it can be replayed. */
+typedef struct
+{
+    TSInputEdit input_edit;
+    char* inserted;
+} Edit;
+
+typedef Array(Edit) EditList;
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-reparse [options] script...\n"
+            "\n"
+            "Replays edit scripts and prints the incremental reparse\n"
+            "latency as JSON. Defaults to every script in bench/edits.\n"
+            "\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "  --no-lex-stats      skip the logged replay counting lexed bytes\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+// Script parsing
+// --------------
+
+static const char* skip_blank(const char* c)
+{
+    while (*c == ' ' || *c == '\t') {
+        c++;
+    }
+    return c;
+}
+
+static char* parse_string(const char** cursor)
+{
+    const char* c = skip_blank(*cursor);
+    if (*c != '"') {
+        return NULL;
+    }
+    c++;
+
+    BenchBuffer text = array_new();
+    while (*c && *c != '"' && *c != '\n') {
+        if (*c == '\\' && c[1]) {
+            c++;
+            char escaped = *c == 'n' ? '\n' : *c == 't' ? '\t' : *c;
+            array_push(&text, escaped);
+        } else {
+            array_push(&text, *c);
+        }
+        c++;
+    }
+    if (*c != '"') {
+        array_delete(&text);
+        return NULL;
+    }
+    *cursor = c + 1;
+    array_push(&text, '\0');
+    return text.contents;
+}
+
+static bool parse_number(const char** cursor, uint32_t* value)
+{
+    const char* c = skip_blank(*cursor);
+    if (!isdigit((unsigned char)*c)) {
+        return false;
+    }
+    char* end;
+    *value = (uint32_t)strtoul(c, &end, 10);
+    *cursor = end;
+    return true;
+}
+
+static bool keyword(const char** cursor, const char* word)
+{
+    size_t length = strlen(word);
+    if (strncmp(*cursor, word, length) != 0 ||
+        isgraph((unsigned char)(*cursor)[length])) {
+        return false;
+    }
+    *cursor += length;
+    return true;
+}
+
+static bool parse_op(const char* line, Op* op)
+{
+    *op = (Op){0};
+    const char* c = line;
+    if (keyword(&c, "goto")) {
+        op->kind = OP_GOTO;
+        return parse_number(&c, &op->first) && parse_number(&c, &op->second);
+    }
+    if (keyword(&c, "find")) {
+        op->kind = OP_FIND;
+        op->second = 1;
+        op->text = parse_string(&c);
+        parse_number(&c, &op->second);
+        return op->text != NULL;
+    }
+    if (keyword(&c, "type")) {
+        op->kind = OP_TYPE;
+        return (op->text = parse_string(&c)) != NULL;
+    }
+    if (keyword(&c, "insert")) {
+        op->kind = OP_INSERT;
+        return (op->text = parse_string(&c)) != NULL;
+    }
+    if (keyword(&c, "delete")) {
+        op->kind = OP_DELETE;
+        return parse_number(&c, &op->first);
+    }
+    if (keyword(&c, "backspace")) {
+        op->kind = OP_BACKSPACE;
+        return parse_number(&c, &op->first);
+    }
+    if (keyword(&c, "toggle-comment")) {
+        op->kind = OP_TOGGLE_COMMENT;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Edit scripts are line based. `#` starts a comment line, `source` names
+ * the file or `synthetic:kind[:amount]` to edit and every other line is an
+ * operation on a cursor:
+ *
+ *   goto LINE COL      move the cursor, both 1-based
+ *   find "TEXT" [N]    move the cursor to the Nth occurrence of TEXT
+ *   type "TEXT"        insert TEXT one keystroke (and reparse) at a time
+ *   insert "TEXT"      insert TEXT as a single edit, e.g. a paste
+ *   delete N           delete N bytes after the cursor as a single edit
+ *   backspace N        delete N bytes before the cursor, one at a time
+ *   toggle-comment     add or remove a `*` in column 0 of the cursor line
+ */
+static bool load_script(const char* path, Script* script)
+{
+    char* data;
+    uint32_t length;
+    if (!bench_read_file(path, &data, &length)) {
+        fprintf(stderr, "failed to read %s\n", path);
+        return false;
+    }
+
+    *script = (Script){.path = strdup(path)};
+    array_init(&script->ops);
+
+    uint32_t line_number = 0;
+    bool valid = true;
+    for (char* line = strtok(data, "\n"); line && valid;
+         line = strtok(NULL, "\n")) {
+        line_number++;
+        const char* c = skip_blank(line);
+        if (*c == '#' || *c == '\0' || *c == '\r') {
+            continue;
+        }
+        if (keyword(&c, "source")) {
+            c = skip_blank(c);
+            script->source_spec = strndup(c, strcspn(c, " \t\r"));
+            continue;
+        }
+
+        Op op;
+        if (parse_op(c, &op)) {
+            array_push(&script->ops, op);
+        } else {
+            fprintf(stderr, "%s:%u: invalid operation: %s\n", path,
+                    line_number, line);
+            valid = false;
+        }
+    }
+    free(data);
+
+    if (valid && !script->source_spec) {
+        fprintf(stderr, "%s: missing source\n", path);
+        valid = false;
+    }
+    return valid;
+}
+
+static void script_delete(Script* script)
+{
+    for (uint32_t i = 0; i < script->ops.size; i++) {
+        free(script->ops.contents[i].text);
+    }
+    array_delete(&script->ops);
+    free(script->source_spec);
+    free(script->path);
+}
+
+// Editing
+// -------
+
+static TSPoint point_at(const BenchBuffer* buffer, uint32_t offset)
+{
+    TSPoint point = {0, 0};
+    for (uint32_t i = 0; i < offset; i++) {
+        if (buffer->contents[i] == '\n') {
+            point.row++;
+            point.column = 0;
+        } else {
+            point.column++;
+        }
+    }
+    return point;
+}
+
+static uint32_t offset_at(const BenchBuffer* buffer, uint32_t row,
+                          uint32_t column)
+{
+    uint32_t offset = 0;
+    while (row > 0 && offset < buffer->size) {
+        if (buffer->contents[offset++] == '\n') {
+            row--;
+        }
+    }
+    while (column > 0 && offset < buffer->size &&
+           buffer->contents[offset] != '\n') {
+        offset++;
+        column--;
+    }
+    return offset;
+}
+
+static uint32_t line_start(const BenchBuffer* buffer, uint32_t offset)
+{
+    while (offset > 0 && buffer->contents[offset - 1] != '\n') {
+        offset--;
+    }
+    return offset;
+}
+
+/**
+ * Replaces `removed` bytes at `offset` with `inserted` and records the
+ * change in terms of a TSInputEdit.
+ */
+static void splice(BenchBuffer* buffer, uint32_t offset, uint32_t removed,
+                   const char* inserted, uint32_t inserted_length,
+                   EditList* edits)
+{
+    Edit edit = {
+            .input_edit =
+                    {
+                            .start_byte = offset,
+                            .old_end_byte = offset + removed,
+                            .new_end_byte = offset + inserted_length,
+                            .start_point = point_at(buffer, offset),
+                            .old_end_point = point_at(buffer, offset + removed),
+                    },
+            .inserted = strndup(inserted, inserted_length),
+    };
+    array_splice(buffer, offset, removed, inserted_length, inserted);
+    edit.input_edit.new_end_point = point_at(buffer, offset + inserted_length);
+    array_push(edits, edit);
+}
+
+/**
+ * Expands an operation into the individual edits an editor would report,
+ * one per keystroke for typing and backspacing.
+ */
+static void expand_op(BenchBuffer* buffer, const Op* op, uint32_t* cursor,
+                      EditList* edits)
+{
+    switch (op->kind) {
+        case OP_GOTO:
+            *cursor = offset_at(buffer, op->first ? op->first - 1 : 0,
+                                op->second ? op->second - 1 : 0);
+            break;
+        case OP_FIND: {
+            const char* match = buffer->contents;
+            for (uint32_t n = 0; n < op->second && match; n++) {
+                match = strstr(n ? match + 1 : match, op->text);
+            }
+            if (match) {
+                *cursor = (uint32_t)(match - buffer->contents);
+            } else {
+                fprintf(stderr, "not found: %s\n", op->text);
+            }
+            break;
+        }
+        case OP_TYPE:
+            for (const char* c = op->text; *c; c++) {
+                splice(buffer, *cursor, 0, c, 1, edits);
+                (*cursor)++;
+            }
+            break;
+        case OP_INSERT: {
+            uint32_t length = (uint32_t)strlen(op->text);
+            splice(buffer, *cursor, 0, op->text, length, edits);
+            *cursor += length;
+            break;
+        }
+        case OP_DELETE: {
+            uint32_t length = op->first;
+            if (*cursor + length > buffer->size - 1) {
+                length = buffer->size - 1 - *cursor;
+            }
+            splice(buffer, *cursor, length, "", 0, edits);
+            break;
+        }
+        case OP_BACKSPACE:
+            for (uint32_t n = 0; n < op->first && *cursor > 0; n++) {
+                (*cursor)--;
+                splice(buffer, *cursor, 1, "", 0, edits);
+            }
+            break;
+        case OP_TOGGLE_COMMENT: {
+            uint32_t start = line_start(buffer, *cursor);
+            if (buffer->contents[start] == '*') {
+                splice(buffer, start, 1, "", 0, edits);
+                *cursor -= *cursor > start;
+            } else {
+                splice(buffer, start, 0, "*", 1, edits);
+                (*cursor)++;
+            }
+            break;
+        }
+    }
+}
+
+// Replay
+// ------
+
+typedef struct
+{
+    BenchBuffer buffer;
+    TSTree* tree;
+} Document;
+
+static TSTree* parse(TSParser* parser, const TSTree* old, Document* document)
+{
+    // the buffer carries a trailing NUL that is not part of the source
+    return ts_parser_parse_string(parser, old, document->buffer.contents,
+                                  document->buffer.size - 1);
+}
+
+static void count_lexed(void* payload, TSLogType type, const char* message)
+{
+    // The lexer logs every character it consumes or skips, including
+    // those advanced over by the external scanner.
+    if (type == TSLogTypeLex && (strncmp(message, "consume", 7) == 0 ||
+                                 strncmp(message, "skip", 4) == 0)) {
+        ((LexCounter*)payload)->lexed_bytes++;
+    }
+}
+
+static bool replay(TSParser* parser, const Script* script, bool lex_stats,
+                   Result* result)
+{
+    BenchSourceList sources = array_new();
+    bool loaded = strncmp(script->source_spec, "synthetic:", 10) == 0
+                          ? bench_collect_synthetic(&sources,
+                                                    script->source_spec + 10)
+                          : bench_collect_path(&sources, script->source_spec);
+    if (!loaded || sources.size != 1) {
+        fprintf(stderr, "%s: source must be a single file\n", script->path);
+        bench_sources_delete(&sources);
+        return false;
+    }
+
+    Document document = {.buffer = array_new()};
+    array_extend(&document.buffer, sources.contents[0].length,
+                 sources.contents[0].data);
+    array_push(&document.buffer, '\0');
+    bench_sources_delete(&sources);
+
+    // Expand everything up front so the timed loop only parses.
+    BenchBuffer initial = array_new();
+    array_push_all(&initial, &document.buffer);
+    EditList edits = array_new();
+    uint32_t cursor = 0;
+    for (uint32_t i = 0; i < script->ops.size; i++) {
+        expand_op(&document.buffer, &script->ops.contents[i], &cursor, &edits);
+    }
+
+    *result = (Result){.source_bytes = initial.size - 1, .edits = edits.size};
+    array_init(&result->parse_ns);
+    array_init(&result->changed_ranges_ns);
+    array_init(&result->lexed_bytes);
+    array_init(&result->changed_bytes);
+
+    LexCounter counter = {0};
+    TSLogger logger = {.payload = &counter, .log = count_lexed};
+    for (uint32_t pass = 0; pass < (lex_stats ? 2 : 1); pass++) {
+        array_clear(&document.buffer);
+        array_push_all(&document.buffer, &initial);
+        if (pass == 1) {
+            ts_parser_set_logger(parser, logger);
+        }
+
+        uint64_t start = bench_now_ns();
+        document.tree = parse(parser, NULL, &document);
+        if (pass == 0) {
+            result->full_parse_ns = bench_now_ns() - start;
+        }
+
+        for (uint32_t e = 0; e < edits.size; e++) {
+            const Edit* edit = &edits.contents[e];
+            const TSInputEdit* input_edit = &edit->input_edit;
+            array_splice(&document.buffer, input_edit->start_byte,
+                         input_edit->old_end_byte - input_edit->start_byte,
+                         input_edit->new_end_byte - input_edit->start_byte,
+                         edit->inserted);
+
+            TSTree* old = document.tree;
+            ts_tree_edit(old, input_edit);
+
+            counter.lexed_bytes = 0;
+            uint64_t parse_start = bench_now_ns();
+            TSTree* tree = parse(parser, old, &document);
+            uint64_t parse_end = bench_now_ns();
+            uint32_t range_count = 0;
+            TSRange* ranges = ts_tree_get_changed_ranges(old, tree,
+                                                         &range_count);
+            uint64_t ranges_end = bench_now_ns();
+
+            if (pass == 0) {
+                uint64_t changed = 0;
+                for (uint32_t r = 0; r < range_count; r++) {
+                    changed += ranges[r].end_byte - ranges[r].start_byte;
+                }
+                array_push(&result->parse_ns, parse_end - parse_start);
+                array_push(&result->changed_ranges_ns,
+                           ranges_end - parse_end);
+                array_push(&result->changed_bytes, changed);
+            } else {
+                array_push(&result->lexed_bytes, counter.lexed_bytes);
+            }
+
+            free(ranges);
+            ts_tree_delete(old);
+            document.tree = tree;
+        }
+        ts_tree_delete(document.tree);
+    }
+    ts_parser_set_logger(parser, (TSLogger){0});
+
+    for (uint32_t i = 0; i < edits.size; i++) {
+        free(edits.contents[i].inserted);
+    }
+    array_delete(&edits);
+    array_delete(&initial);
+    array_delete(&document.buffer);
+    return true;
+}
+
+static int compare_sources(const void* a, const void* b)
+{
+    return strcmp(((const BenchSource*)a)->name,
+                  ((const BenchSource*)b)->name);
+}
+
+static void collect_scripts(BenchSourceList* scripts, const char* path)
+{
+    DIR* directory = opendir(path);
+    if (!directory) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length > 6 && strcmp(entry->d_name + length - 6, ".edits") == 0) {
+            BenchBuffer name = array_new();
+            bench_buffer_appendf(&name, "%s/%s", path, entry->d_name);
+            array_push(&name, '\0');
+            BenchSource script = {.name = name.contents};
+            array_push(scripts, script);
+        }
+    }
+    closedir(directory);
+    qsort(scripts->contents, scripts->size, sizeof(BenchSource),
+          compare_sources);
+}
+
+static void print_distribution(FILE* out, const char* name,
+                               BenchSamples* samples, bool last)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < samples->size; i++) {
+        sum += samples->contents[i];
+    }
+    fprintf(out,
+            "      \"%s\": {\"mean\": %.1f, \"p50\": %llu, \"p99\": %llu, "
+            "\"max\": %llu}%s\n",
+            name, samples->size ? (double)sum / samples->size : 0.0,
+            (unsigned long long)bench_percentile(samples, 50),
+            (unsigned long long)bench_percentile(samples, 99),
+            (unsigned long long)bench_percentile(samples, 100),
+            last ? "" : ",");
+}
+
+static void result_delete(Result* result)
+{
+    array_delete(&result->parse_ns);
+    array_delete(&result->changed_ranges_ns);
+    array_delete(&result->lexed_bytes);
+    array_delete(&result->changed_bytes);
+}
+
+int main(int argc, char** argv)
+{
+    const char* output_path = NULL;
+    bool lex_stats = true;
+    BenchSourceList scripts = array_new();
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--no-lex-stats") == 0) {
+            lex_stats = false;
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            BenchSource script = {.name = strdup(argv[i])};
+            array_push(&scripts, script);
+        }
+    }
+    if (scripts.size == 0) {
+        collect_scripts(&scripts, "bench/edits");
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+
+    int status = 0;
+    bool first = true;
+    fprintf(out, "{\n  \"scripts\": [\n");
+    for (uint32_t i = 0; i < scripts.size; i++) {
+        Script script = {0};
+        Result result;
+        if (!load_script(scripts.contents[i].name, &script) ||
+            !replay(parser, &script, lex_stats, &result)) {
+            script_delete(&script);
+            status = 1;
+            continue;
+        }
+
+        fprintf(out, "%s    {\n      \"script\": ", first ? "" : ",\n");
+        bench_json_string(out, script.path);
+        fprintf(out, ",\n      \"source\": ");
+        bench_json_string(out, script.source_spec);
+        fprintf(out, ",\n      \"source_bytes\": %u,\n", result.source_bytes);
+        fprintf(out, "      \"edits\": %u,\n", result.edits);
+        fprintf(out, "      \"full_parse_ns\": %llu,\n",
+                (unsigned long long)result.full_parse_ns);
+        print_distribution(out, "reparse_ns", &result.parse_ns, false);
+        print_distribution(out, "changed_ranges_ns",
+                           &result.changed_ranges_ns, false);
+        print_distribution(out, "changed_bytes", &result.changed_bytes,
+                           !lex_stats);
+        if (lex_stats) {
+            print_distribution(out, "lexed_bytes", &result.lexed_bytes, true);
+        }
+        fprintf(out, "    }");
+        first = false;
+
+        result_delete(&result);
+        script_delete(&script);
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    ts_parser_delete(parser);
+    bench_sources_delete(&scripts);
+    return status;
+}
@@ -0,0 +1,204 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Per-token cost on long lines.
+ *
+ * The external scanner runs in front of almost every token. Anything in it
+ * that is linear in the column, like `TSLexer.get_column`, turns a single
+ * long line into quadratic parse time. This benchmark parses inputs of the
+ * same total size made up of lines of growing width and reports the parse
+ * time per token for each width. With a constant per-token cost the ratio
+ * to the narrowest width stays close to 1.
+ */
+
+typedef Array(char*) StringList;
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-scanner [options]\n"
+            "\n"
+            "Parses single-line synthetic sources of growing width and prints\n"
+            "the parse time per token as JSON.\n"
+            "\n"
+            "  --kinds LIST        synthetic kinds (default long_line,minified)\n"
+            "  --widths LIST       line widths as synthetic amounts\n"
+            "                      (default 1k,10k,100k,1m)\n"
+            "  --total BYTES       size of each input, lines are repeated\n"
+            "                      up to it (default 4194304)\n"
+            "  --repeat N          parses per input (default 3)\n"
+            "  --max-ratio R       fail if the ns per token of a width exceeds\n"
+            "                      R times the one of the narrowest width\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static void split_list(StringList* list, const char* value)
+{
+    const char* start = value;
+    for (;;) {
+        size_t length = strcspn(start, ",");
+        if (length > 0) {
+            char* item = malloc(length + 1);
+            memcpy(item, start, length);
+            item[length] = '\0';
+            array_push(list, item);
+        }
+        if (start[length] == '\0') {
+            return;
+        }
+        start += length + 1;
+    }
+}
+
+static void string_list_delete(StringList* list)
+{
+    for (uint32_t i = 0; i < list->size; i++) {
+        free(list->contents[i]);
+    }
+    array_delete(list);
+}
+
+int main(int argc, char** argv)
+{
+    StringList kinds = array_new();
+    StringList widths = array_new();
+    uint64_t total = 4 * 1024 * 1024;
+    uint32_t repeat = 3;
+    double max_ratio = 0;
+    const char* output_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--kinds") == 0 && i + 1 < argc) {
+            split_list(&kinds, argv[++i]);
+        } else if (strcmp(argv[i], "--widths") == 0 && i + 1 < argc) {
+            split_list(&widths, argv[++i]);
+        } else if (strcmp(argv[i], "--total") == 0 && i + 1 < argc) {
+            total = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--max-ratio") == 0 && i + 1 < argc) {
+            max_ratio = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else {
+            usage(stderr);
+            return 1;
+        }
+    }
+
+    if (kinds.size == 0) {
+        split_list(&kinds, "long_line,minified");
+    }
+    if (widths.size == 0) {
+        split_list(&widths, "1k,10k,100k,1m");
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+    BenchBuffer buffer = array_new();
+    BenchSamples runs = array_new();
+    bool within_ratio = true;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"abi_version\": %u,\n",
+            ts_language_abi_version(tree_sitter_abap()));
+    fprintf(out, "  \"repeat\": %u,\n", repeat);
+    fprintf(out, "  \"total_bytes\": %llu,\n", (unsigned long long)total);
+    fprintf(out, "  \"results\": [\n");
+
+    for (uint32_t k = 0; k < kinds.size; k++) {
+        double baseline = 0;
+        for (uint32_t w = 0; w < widths.size; w++) {
+            // Repeat the line up to the total so that every width parses
+            // the same amount of code.
+            array_clear(&buffer);
+            if (!bench_synthesize(kinds.contents[k], widths.contents[w],
+                                  &buffer)) {
+                fprintf(stderr, "unknown synthetic source: %s\n",
+                        kinds.contents[k]);
+                return 1;
+            }
+            uint32_t line_bytes = buffer.size;
+            while (buffer.size < total) {
+                bench_synthesize(kinds.contents[k], widths.contents[w],
+                                 &buffer);
+            }
+
+            array_clear(&runs);
+            BenchTreeStats stats = {0};
+            for (uint32_t run = 0; run < repeat; run++) {
+                uint64_t start = bench_now_ns();
+                TSTree* tree = ts_parser_parse_string(parser, NULL,
+                                                      buffer.contents,
+                                                      buffer.size);
+                array_push(&runs, bench_now_ns() - start);
+                if (run == 0) {
+                    stats = bench_tree_stats(tree);
+                }
+                ts_tree_delete(tree);
+            }
+
+            uint64_t median = bench_percentile(&runs, 50);
+            double ns_per_token =
+                    stats.leaves ? (double)median / stats.leaves : 0.0;
+            if (w == 0) {
+                baseline = ns_per_token;
+            }
+            double ratio = baseline > 0 ? ns_per_token / baseline : 0.0;
+            within_ratio &= max_ratio <= 0 || ratio <= max_ratio;
+
+            fprintf(out, "    {\n      \"kind\": ");
+            bench_json_string(out, kinds.contents[k]);
+            fprintf(out, ",\n      \"width\": ");
+            bench_json_string(out, widths.contents[w]);
+            fprintf(out, ",\n");
+            fprintf(out, "      \"line_bytes\": %u,\n", line_bytes);
+            fprintf(out, "      \"bytes\": %u,\n", buffer.size);
+            fprintf(out, "      \"tokens\": %u,\n", stats.leaves);
+            fprintf(out, "      \"error_nodes\": %u,\n", stats.errors);
+            fprintf(out, "      \"parse_ns\": %llu,\n",
+                    (unsigned long long)median);
+            fprintf(out, "      \"ns_per_token\": %.3f,\n", ns_per_token);
+            fprintf(out, "      \"ratio\": %.3f\n", ratio);
+            fprintf(out, "    }%s\n",
+                    k + 1 < kinds.size || w + 1 < widths.size ? "," : "");
+        }
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    if (!within_ratio) {
+        fprintf(stderr, "per-token cost grows with the line width by more "
+                        "than %.2fx\n",
+                max_ratio);
+    }
+
+    array_delete(&buffer);
+    array_delete(&runs);
+    ts_parser_delete(parser);
+    string_list_delete(&kinds);
+    string_list_delete(&widths);
+    return within_ratio ? 0 : 1;
+}
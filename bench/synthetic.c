@@ -0,0 +1,440 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A generator for a synthetic source. Sources are built from an optional
+ * prologue, a number of repeated units and an optional epilogue so that the
+ * size can be scaled without changing the shape of the code.
+ */
+typedef struct
+{
+    const char* kind;
+    const char* description;
+    uint32_t default_units;
+    void (*prologue)(BenchBuffer* buffer);
+    void (*unit)(BenchBuffer* buffer, uint32_t index);
+    void (*epilogue)(BenchBuffer* buffer);
+} SyntheticKind;
+
+static void report_prologue(BenchBuffer* buffer)
+{
+    bench_buffer_append(
+            buffer,
+            "REPORT zsynthetic_report MESSAGE-ID zbench.\n"
+            "\n"
+            "TABLES sflight.\n"
+            "\n"
+            "TYPES: BEGIN OF ty_flight,\n"
+            "         carrid TYPE s_carr_id,\n"
+            "         connid TYPE s_conn_id,\n"
+            "         fldate TYPE s_date,\n"
+            "         price  TYPE s_price,\n"
+            "       END OF ty_flight,\n"
+            "       tt_flights TYPE STANDARD TABLE OF ty_flight "
+            "WITH DEFAULT KEY.\n"
+            "\n"
+            "PARAMETERS p_carr TYPE s_carr_id OBLIGATORY.\n"
+            "SELECT-OPTIONS s_date FOR sflight-fldate.\n"
+            "\n");
+}
+
+// One local class with a definition, an implementation and a form using it,
+// roughly what a legacy report accumulates per feature.
+static void report_unit(BenchBuffer* buffer, uint32_t i)
+{
+    bench_buffer_appendf(
+            buffer,
+            "*&---------------------------------------------------------*\n"
+            "*& Feature %u\n"
+            "*&---------------------------------------------------------*\n"
+            "CLASS lcl_feature_%u DEFINITION FINAL.\n"
+            "  PUBLIC SECTION.\n"
+            "    \"! Loads the flights of the feature\n"
+            "    \"! @parameter iv_carrid | Carrier to load\n"
+            "    METHODS load\n"
+            "      IMPORTING iv_carrid TYPE s_carr_id\n"
+            "      RETURNING VALUE(rt_flights) TYPE tt_flights.\n"
+            "    METHODS total\n"
+            "      IMPORTING it_flights TYPE tt_flights\n"
+            "      RETURNING VALUE(rv_total) TYPE p.\n"
+            "  PRIVATE SECTION.\n"
+            "    DATA mv_count TYPE i.\n"
+            "    CONSTANTS c_limit TYPE i VALUE %u.\n"
+            "ENDCLASS.\n"
+            "\n"
+            "CLASS lcl_feature_%u IMPLEMENTATION.\n"
+            "  METHOD load.\n"
+            "    SELECT carrid, connid, fldate, price\n"
+            "      FROM sflight\n"
+            "      WHERE carrid = @iv_carrid\n"
+            "      INTO TABLE @rt_flights.\n"
+            "    mv_count = lines( rt_flights ).\n"
+            "    IF mv_count > c_limit.\n"
+            "      DELETE rt_flights FROM c_limit.\n"
+            "    ENDIF.\n"
+            "  ENDMETHOD.\n"
+            "\n"
+            "  METHOD total.\n"
+            "    \" sum up everything below the limit\n"
+            "    LOOP AT it_flights INTO DATA(ls_flight).\n"
+            "      IF ls_flight-price > 0 AND ls_flight-carrid IS NOT "
+            "INITIAL.\n"
+            "        rv_total = rv_total + ls_flight-price.\n"
+            "      ELSE.\n"
+            "        CONTINUE.\n"
+            "      ENDIF.\n"
+            "    ENDLOOP.\n"
+            "    DATA(lv_text) = |Feature { %u }: { rv_total }|.\n"
+            "    CONDENSE lv_text.\n"
+            "  ENDMETHOD.\n"
+            "ENDCLASS.\n"
+            "\n"
+            "FORM run_feature_%u USING pv_carrid TYPE s_carr_id.\n"
+            "  DATA lo_feature TYPE REF TO lcl_feature_%u.\n"
+            "  lo_feature = NEW #( ).\n"
+            "  DATA(lt_flights) = lo_feature->load( pv_carrid ).\n"
+            "  CASE lines( lt_flights ).\n"
+            "    WHEN 0.\n"
+            "      MESSAGE e001(zbench) WITH pv_carrid.\n"
+            "    WHEN OTHERS.\n"
+            "      WRITE lo_feature->total( lt_flights ) TO gv_out.\n"
+            "  ENDCASE.\n"
+            "ENDFORM.\n"
+            "\n",
+            i, i, 100 + i % 900, i, i, i, i);
+}
+
+static void report_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "START-OF-SELECTION.\n"
+                                "  PERFORM run_feature_0 USING p_carr.\n");
+}
+
+static void event_report_prologue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer,
+                        "REPORT zsynthetic_events.\n"
+                        "\n"
+                        "TABLES sflight.\n"
+                        "PARAMETERS p_carr TYPE s_carr_id.\n"
+                        "DATA gt_flights TYPE STANDARD TABLE OF sflight.\n"
+                        "DATA gv_total TYPE p.\n"
+                        "\n"
+                        "INITIALIZATION.\n"
+                        "  p_carr = 'LH'.\n"
+                        "\n"
+                        "AT SELECTION-SCREEN.\n"
+                        "  IF p_carr IS INITIAL.\n"
+                        "    MESSAGE e001(zbench).\n"
+                        "  ENDIF.\n"
+                        "\n"
+                        "START-OF-SELECTION.\n");
+}
+
+// Statements of one huge START-OF-SELECTION block, the way old reports
+// were written before they had forms or classes.
+static void event_report_unit(BenchBuffer* buffer, uint32_t i)
+{
+    bench_buffer_appendf(
+            buffer,
+            "  SELECT * FROM sflight INTO TABLE gt_flights\n"
+            "    WHERE carrid = p_carr AND connid = '%04u'.\n"
+            "  LOOP AT gt_flights INTO DATA(ls_flight_%u).\n"
+            "    gv_total = gv_total + ls_flight_%u-price.\n"
+            "  ENDLOOP.\n"
+            "  WRITE: / 'Connection', '%04u', gv_total.\n"
+            "  CLEAR gv_total.\n",
+            i % 10000, i, i, i % 10000);
+}
+
+static void event_report_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "\n"
+                                "FORM done.\n"
+                                "  WRITE / 'done'.\n"
+                                "ENDFORM.\n");
+}
+
+static void amdp_prologue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "CLASS zcl_synthetic_amdp IMPLEMENTATION.\n");
+}
+
+// An AMDP procedure with a SQLScript body, as generated for HANA views.
+static void amdp_unit(BenchBuffer* buffer, uint32_t i)
+{
+    bench_buffer_appendf(
+            buffer,
+            "  METHOD get_sales_%u BY DATABASE PROCEDURE\n"
+            "      FOR HDB LANGUAGE SQLSCRIPT OPTIONS READ-ONLY\n"
+            "      USING vbak vbap.\n"
+            "    -- open orders of the sales organization\n"
+            "    lt_orders = SELECT vbeln, erdat, netwr, waerk\n"
+            "                  FROM vbak\n"
+            "                 WHERE mandt = :iv_client\n"
+            "                   AND vkorg = :iv_vkorg\n"
+            "                   AND gbstk <> 'C';\n"
+            "    et_items = SELECT o.vbeln, p.posnr, p.matnr,\n"
+            "                      SUM( p.kwmeng ) AS quantity,\n"
+            "                      CASE WHEN p.abgru = '' THEN 'X'\n"
+            "                           ELSE '' END AS open\n"
+            "                 FROM :lt_orders AS o\n"
+            "                 INNER JOIN vbap AS p ON p.vbeln = o.vbeln\n"
+            "                GROUP BY o.vbeln, p.posnr, p.matnr, p.abgru;\n"
+            "    /* %u */\n"
+            "  ENDMETHOD.\n"
+            "\n",
+            i, i);
+}
+
+static void amdp_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "ENDCLASS.\n");
+}
+
+static void chained_prologue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "REPORT zsynthetic_chains.\n"
+                                "\n"
+                                "FORM log USING pv_value TYPE any.\n"
+                                "ENDFORM.\n"
+                                "\n");
+}
+
+// A form of old procedural code that chains every statement it can, most of
+// which the grammar only parses through error recovery.
+static void chained_unit(BenchBuffer* buffer, uint32_t i)
+{
+    bench_buffer_appendf(
+            buffer,
+            "FORM chained_%u USING pv_count TYPE i.\n"
+            "  DATA: lv_a TYPE i, lv_b TYPE string,\n"
+            "        lv_c TYPE p LENGTH 8 DECIMALS 2.\n"
+            "  CLEAR: lv_a, lv_b, lv_c.\n"
+            "  MOVE: pv_count TO lv_a, 'x' TO lv_b.\n"
+            "  ADD 1 TO: lv_a, lv_c.\n"
+            "  REPLACE ALL OCCURRENCES OF 'a' IN: lv_b WITH 'b',\n"
+            "                                     lv_b WITH 'c'.\n"
+            "  CONCATENATE: lv_b 'x' INTO lv_b, lv_b 'y' INTO lv_b.\n"
+            "  WRITE: / lv_a, / lv_b, lv_c.\n"
+            "  PERFORM log USING: lv_a, lv_b.\n"
+            "ENDFORM.\n"
+            "\n",
+            i);
+}
+
+static void chained_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "START-OF-SELECTION.\n"
+                                "  PERFORM chained_0 USING 1.\n");
+}
+
+static void comment_block_prologue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "REPORT zsynthetic_comments.\n"
+                                "\n"
+                                "DATA gv_count TYPE i.\n"
+                                "\n");
+}
+
+// Legacy code that was commented out line by line rather than deleted.
+static void comment_block_unit(BenchBuffer* buffer, uint32_t i)
+{
+    static const char* lines[] = {
+            "*  LOOP AT gt_items INTO gs_item.",
+            "*    IF gs_item-flag = abap_true.",
+            "*      gv_count = gv_count + 1.",
+            "*    ENDIF.",
+            "*  ENDLOOP.",
+            "*& old implementation, kept for reference",
+    };
+    bench_buffer_appendf(buffer, "%s\n", lines[i % 6]);
+}
+
+static void comment_block_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "\n"
+                                "START-OF-SELECTION.\n"
+                                "  gv_count = 0.\n");
+}
+
+static void abapdoc_prologue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "CLASS zcl_synthetic_docs DEFINITION PUBLIC.\n"
+                                "  PUBLIC SECTION.\n");
+}
+
+// A documented method, as found in RAP and OO class headers.
+static void abapdoc_unit(BenchBuffer* buffer, uint32_t i)
+{
+    bench_buffer_appendf(
+            buffer,
+            "    \"! <p class=\"shorttext synchronized\">Operation %u</p>\n"
+            "    \"! Reads the entities of the business object and maps them\n"
+            "    \"! onto the {@link zcl_synthetic_docs.METH:op_%u} result.\n"
+            "    \"! The mapping is done in two passes, see\n"
+            "    \"! {@link cl_abap_behv.DATA:flags} for the details.\n"
+            "    \"! @parameter keys | Keys of the entities to read\n"
+            "    \"! @parameter result | Mapped entities\n"
+            "    \"! @raising cx_static_check | If the read fails\n"
+            "    METHODS op_%u\n"
+            "      IMPORTING keys TYPE string_table\n"
+            "      EXPORTING result TYPE string_table\n"
+            "      RAISING cx_static_check.\n",
+            i, i + 1, i);
+}
+
+static void abapdoc_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "ENDCLASS.\n");
+}
+
+static void long_line_prologue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "lv_sum = lv_sum");
+}
+
+// One operand of a single arithmetic statement, the source is one line. The
+// `*` is preceded by a blank, as it always is in ABAP, but still has to be
+// told apart from a full-line comment by the scanner.
+static void long_line_unit(BenchBuffer* buffer, uint32_t i)
+{
+    bench_buffer_appendf(buffer, " + lv_value_%u * %u", i, i % 7 + 1);
+}
+
+static void long_line_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, ".\n");
+}
+
+// Statements of a generated program with all line breaks removed, units are
+// complete statements.
+static void minified_unit(BenchBuffer* buffer, uint32_t i)
+{
+    bench_buffer_appendf(buffer,
+                         "DATA lv_%u TYPE i. lv_%u = %u * 2. "
+                         "IF lv_%u > 10. WRITE lv_%u. ENDIF. ",
+                         i, i, i, i, i);
+}
+
+static void minified_epilogue(BenchBuffer* buffer)
+{
+    bench_buffer_append(buffer, "\n");
+}
+
+static const SyntheticKind kinds[] = {
+        {
+                .kind = "report",
+                .description = "classic report, units are local classes",
+                .default_units = 200,
+                .prologue = report_prologue,
+                .unit = report_unit,
+                .epilogue = report_epilogue,
+        },
+        {
+                .kind = "event_report",
+                .description = "report with event blocks, units are loops",
+                .default_units = 2000,
+                .prologue = event_report_prologue,
+                .unit = event_report_unit,
+                .epilogue = event_report_epilogue,
+        },
+        {
+                .kind = "amdp",
+                .description = "AMDP class, units are SQLScript procedures",
+                .default_units = 500,
+                .prologue = amdp_prologue,
+                .unit = amdp_unit,
+                .epilogue = amdp_epilogue,
+        },
+        {
+                .kind = "chained",
+                .description = "legacy forms of chained statements",
+                .default_units = 2000,
+                .prologue = chained_prologue,
+                .unit = chained_unit,
+                .epilogue = chained_epilogue,
+        },
+        {
+                .kind = "comment_block",
+                .description = "one commented-out block, units are lines",
+                .default_units = 5000,
+                .prologue = comment_block_prologue,
+                .unit = comment_block_unit,
+                .epilogue = comment_block_epilogue,
+        },
+        {
+                .kind = "abapdoc",
+                .description = "ABAP Doc heavy class, units are methods",
+                .default_units = 200,
+                .prologue = abapdoc_prologue,
+                .unit = abapdoc_unit,
+                .epilogue = abapdoc_epilogue,
+        },
+        {
+                .kind = "long_line",
+                .description = "one statement on one line, units are operands",
+                .default_units = 1000,
+                .prologue = long_line_prologue,
+                .unit = long_line_unit,
+                .epilogue = long_line_epilogue,
+        },
+        {
+                .kind = "minified",
+                .description = "program without line breaks, units are blocks",
+                .default_units = 500,
+                .unit = minified_unit,
+                .epilogue = minified_epilogue,
+        },
+};
+
+bool bench_synthesize(const char* kind, const char* amount,
+                      BenchBuffer* buffer)
+{
+    const SyntheticKind* generator = NULL;
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        if (strcmp(kinds[i].kind, kind) == 0) {
+            generator = &kinds[i];
+        }
+    }
+    if (!generator) {
+        return false;
+    }
+
+    char* suffix = NULL;
+    unsigned long long value = strtoull(amount, &suffix, 10);
+    uint64_t target_bytes = 0;
+    uint32_t units = generator->default_units;
+    if (suffix && (*suffix == 'k' || *suffix == 'K')) {
+        target_bytes = value * 1024;
+    } else if (suffix && (*suffix == 'm' || *suffix == 'M')) {
+        target_bytes = value * 1024 * 1024;
+    } else if (suffix != amount) {
+        units = (uint32_t)value;
+    }
+
+    // the target is relative, so sources can be appended to each other
+    uint32_t start = buffer->size;
+    if (generator->prologue) {
+        generator->prologue(buffer);
+    }
+    for (uint32_t i = 0;
+         target_bytes ? buffer->size - start < target_bytes : i < units; i++) {
+        generator->unit(buffer, i);
+    }
+    if (generator->epilogue) {
+        generator->epilogue(buffer);
+    }
+    return true;
+}
+
+void bench_list_synthetic(FILE* out)
+{
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        fprintf(out, "  %-16s %s (default %u)\n", kinds[i].kind,
+                kinds[i].description, kinds[i].default_units);
+    }
+}
@@ -0,0 +1,265 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "common.h"
+#include "tree_sitter/tree-sitter-abap-scanner-stats.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * Parse throughput benchmark.
+ *
+ * Parses every source a number of times with a fresh tree and reports the
+ * throughput, the tree density and the per-file latency distribution as
+ * JSON, both in total and per input group. The output is meant to be stored
+ * next to `parser-size.json` so grammar changes can be compared on speed as
+ * well as on size. The number of cpus and the compiler are recorded with
+ * them, timings are only comparable between runs on the same machine.
+ *
+ * Built with TREE_SITTER_ABAP_SCANNER_STATS, the scanner counters of the
+ * first parse of every source are added up per group as well. The counting
+ * slows the scanner down, so the timings of such a build are not comparable
+ * with others.
+ */
+
+typedef struct
+{
+    const char* name;
+    uint32_t files;
+    uint64_t bytes;
+    uint64_t parse_ns;
+    uint64_t nodes;
+    uint32_t errors;
+    uint32_t missing;
+    uint32_t files_with_errors;
+    BenchSamples latencies;
+    TSAbapScannerStats* scanner_stats;
+} Group;
+
+typedef Array(Group) GroupList;
+
+static const char* default_paths[] = {"test/corpus", "test/highlight"};
+static const char* default_synthetic[] = {"report:4m"};
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bench-throughput [options] [path...]\n"
+            "\n"
+            "Parses the given files and directories (default: test/corpus\n"
+            "test/highlight and synthetic:report:4m) and prints JSON.\n"
+            "\n"
+            "  --repeat N          parses per source (default 3)\n"
+            "  --synthetic SPEC    add a generated source, kind[:amount]\n"
+            "  --output FILE       write the JSON to FILE instead of stdout\n"
+            "\n"
+            "synthetic kinds:\n");
+    bench_list_synthetic(out);
+}
+
+static Group* group_for(GroupList* groups, const char* name)
+{
+    for (uint32_t i = 0; i < groups->size; i++) {
+        if (strcmp(groups->contents[i].name, name) == 0) {
+            return &groups->contents[i];
+        }
+    }
+    Group group = {.name = name};
+    array_init(&group.latencies);
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+    group.scanner_stats = calloc(1, sizeof(TSAbapScannerStats));
+#endif
+    array_push(groups, group);
+    return array_back(groups);
+}
+
+static void record(Group* group, const BenchSource* source, uint64_t ns,
+                   const BenchTreeStats* stats)
+{
+    group->files++;
+    group->bytes += source->length;
+    group->parse_ns += ns;
+    group->nodes += stats->nodes;
+    group->errors += stats->errors;
+    group->missing += stats->missing;
+    group->files_with_errors += stats->errors + stats->missing > 0;
+    array_push(&group->latencies, ns);
+}
+
+static void print_metrics(FILE* out, Group* group, const char* indent)
+{
+    double seconds = group->parse_ns / 1e9;
+    double megabytes = group->bytes / (1024.0 * 1024.0);
+
+    fprintf(out, "%s\"files\": %u,\n", indent, group->files);
+    fprintf(out, "%s\"bytes\": %llu,\n", indent,
+            (unsigned long long)group->bytes);
+    fprintf(out, "%s\"parse_ns\": %llu,\n", indent,
+            (unsigned long long)group->parse_ns);
+    fprintf(out, "%s\"mb_per_s\": %.3f,\n", indent,
+            seconds > 0 ? megabytes / seconds : 0.0);
+    fprintf(out, "%s\"ns_per_byte\": %.3f,\n", indent,
+            group->bytes ? (double)group->parse_ns / group->bytes : 0.0);
+    fprintf(out, "%s\"nodes_per_byte\": %.4f,\n", indent,
+            group->bytes ? (double)group->nodes / group->bytes : 0.0);
+    fprintf(out, "%s\"error_nodes\": %u,\n", indent, group->errors);
+    fprintf(out, "%s\"missing_nodes\": %u,\n", indent, group->missing);
+    fprintf(out, "%s\"files_with_errors\": %u,\n", indent,
+            group->files_with_errors);
+    fprintf(out, "%s\"latency_p50_ns\": %llu,\n", indent,
+            (unsigned long long)bench_percentile(&group->latencies, 50));
+    fprintf(out, "%s\"latency_p99_ns\": %llu", indent,
+            (unsigned long long)bench_percentile(&group->latencies, 99));
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+    fprintf(out, ",\n%s\"scanner\": ", indent);
+    tree_sitter_abap_scanner_stats_write_json(group->scanner_stats, out);
+#endif
+    fprintf(out, "\n");
+}
+
+int main(int argc, char** argv)
+{
+    BenchSourceList sources = array_new();
+    uint32_t repeat = 3;
+    const char* output_path = NULL;
+    bool explicit_inputs = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            explicit_inputs = true;
+            if (!bench_collect_synthetic(&sources, argv[++i])) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            explicit_inputs = true;
+            if (!bench_collect_path(&sources, argv[i])) {
+                return 1;
+            }
+        }
+    }
+
+    if (!explicit_inputs) {
+        for (size_t i = 0; i < sizeof(default_paths) / sizeof(char*); i++) {
+            bench_collect_path(&sources, default_paths[i]);
+        }
+        for (size_t i = 0; i < sizeof(default_synthetic) / sizeof(char*);
+             i++) {
+            bench_collect_synthetic(&sources, default_synthetic[i]);
+        }
+    }
+    if (repeat == 0) {
+        repeat = 1;
+    }
+
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+
+    GroupList groups = array_new();
+    Group total = {.name = "total"};
+    array_init(&total.latencies);
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+    total.scanner_stats = calloc(1, sizeof(TSAbapScannerStats));
+#endif
+    BenchSamples runs = array_new();
+
+    for (uint32_t i = 0; i < sources.size; i++) {
+        const BenchSource* source = &sources.contents[i];
+        Group* group = group_for(&groups, source->group);
+
+        // The latency of a file is the median of its runs, the throughput
+        // is based on all of them.
+        array_clear(&runs);
+        BenchTreeStats stats = {0};
+        for (uint32_t run = 0; run < repeat; run++) {
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+            tree_sitter_abap_scanner_stats_reset();
+#endif
+            uint64_t start = bench_now_ns();
+            TSTree* tree = ts_parser_parse_string(parser, NULL, source->data,
+                                                  source->length);
+            array_push(&runs, bench_now_ns() - start);
+            if (run == 0) {
+                stats = bench_tree_stats(tree);
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+                const TSAbapScannerStats* counters =
+                        tree_sitter_abap_scanner_stats();
+                tree_sitter_abap_scanner_stats_add(group->scanner_stats,
+                                                   counters);
+                tree_sitter_abap_scanner_stats_add(total.scanner_stats,
+                                                   counters);
+#endif
+            }
+            ts_tree_delete(tree);
+        }
+
+        uint64_t sum = 0;
+        for (uint32_t run = 0; run < runs.size; run++) {
+            sum += runs.contents[run];
+        }
+        uint64_t median = bench_percentile(&runs, 50);
+
+        Group* targets[] = {group, &total};
+        for (size_t t = 0; t < 2; t++) {
+            record(targets[t], source, median, &stats);
+            // record() counts a single run, account for the others
+            targets[t]->parse_ns += sum - median;
+            targets[t]->bytes += (uint64_t)source->length * (repeat - 1);
+            targets[t]->nodes += (uint64_t)stats.nodes * (repeat - 1);
+        }
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"abi_version\": %u,\n",
+            ts_language_abi_version(tree_sitter_abap()));
+    fprintf(out, "  \"repeat\": %u,\n", repeat);
+    fprintf(out, "  \"cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+#ifdef __VERSION__
+    fprintf(out, "  \"compiler\": ");
+    bench_json_string(out, __VERSION__);
+    fprintf(out, ",\n");
+#endif
+    fprintf(out, "  \"total\": {\n");
+    print_metrics(out, &total, "    ");
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"groups\": [\n");
+    for (uint32_t i = 0; i < groups.size; i++) {
+        fprintf(out, "    {\n      \"name\": ");
+        bench_json_string(out, groups.contents[i].name);
+        fprintf(out, ",\n");
+        print_metrics(out, &groups.contents[i], "      ");
+        fprintf(out, "    }%s\n", i + 1 < groups.size ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    for (uint32_t i = 0; i < groups.size; i++) {
+        array_delete(&groups.contents[i].latencies);
+        free(groups.contents[i].scanner_stats);
+    }
+    array_delete(&groups);
+    array_delete(&total.latencies);
+    free(total.scanner_stats);
+    array_delete(&runs);
+    ts_parser_delete(parser);
+    bench_sources_delete(&sources);
+    return 0;
+}
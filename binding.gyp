@@ -14,7 +14,10 @@
                 "src/scanner.c",
             ],
             "variables": {
-                "has_scanner": "<!(node -p \"fs.existsSync('src/scanner.c')\")"
+                "has_scanner": "<!(node -p \"fs.existsSync('src/scanner.c')\")",
+                # parseAsync needs the runtime itself, taken from the sources
+                # vendored by node-tree-sitter when it is installed.
+                "tree_sitter_lib": "<!(node -p \"try { const lib = require('path').join(require('path').dirname(require.resolve('tree-sitter/package.json')), 'vendor/tree-sitter/lib'); fs.existsSync(lib + '/src/lib.c') ? lib : '' } catch (_) { '' }\")",
             },
             "conditions": [
                 [
@@ -23,6 +26,20 @@
                         "sources+": ["src/scanner.c"],
                     },
                 ],
+                [
+                    "tree_sitter_lib!=''",
+                    {
+                        "sources+": [
+                            "bindings/node/async.cc",
+                            "<(tree_sitter_lib)/src/lib.c",
+                        ],
+                        "include_dirs+": [
+                            "<(tree_sitter_lib)/include",
+                            "<(tree_sitter_lib)/src",
+                        ],
+                        "defines": ["TREE_SITTER_ABAP_ASYNC"],
+                    },
+                ],
                 [
                     "OS!='win'",
                     {
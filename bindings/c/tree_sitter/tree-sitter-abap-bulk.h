@@ -0,0 +1,118 @@
+#ifndef TREE_SITTER_ABAP_BULK_H_
+#define TREE_SITTER_ABAP_BULK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tree-sitter-abap-scanner-stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Parses many files on a pool of threads, one `TSParser` per thread.
+ *
+ * Built from `tools/` as `libtree-sitter-abap-tools`, links against the
+ * tree-sitter runtime and pthreads.
+ */
+
+typedef struct
+{
+    /** The path as passed in or found while walking a directory. */
+    const char* path;
+    uint64_t bytes;
+    uint64_t parse_ns;
+    uint32_t nodes;
+    uint32_t errors;
+    uint32_t missing;
+    uint32_t max_depth;
+    /** Captures of the query, if one was given. */
+    uint64_t captures;
+    /** The parse was cancelled after exceeding the time budget. */
+    bool timed_out;
+    /** The file could not be read, all other fields but the path are 0. */
+    bool unreadable;
+    /** Taken from the cache, the parse time is 0. */
+    bool cached;
+    /**
+     * The scanner counters of the parse, only valid during the callback.
+     * NULL unless built with TREE_SITTER_ABAP_SCANNER_STATS, asked for
+     * through `scanner_stats` in the options and parsed.
+     */
+    const TSAbapScannerStats* scanner_stats;
+} TSAbapBulkFileResult;
+
+typedef struct
+{
+    uint32_t files;
+    uint64_t bytes;
+    uint64_t wall_ns;
+    /** Sum of the per-file parse times over all threads. */
+    uint64_t parse_ns;
+    uint32_t files_with_errors;
+    uint32_t timed_out;
+    uint32_t unreadable;
+    /** Files a thread took over from the queue of another. */
+    uint32_t stolen;
+    /** Files taken from the cache, if one was given. */
+    uint32_t cache_hits;
+    /** Time spent hashing files and looking them up in the cache. */
+    uint64_t cache_lookup_ns;
+    /** Cache entries written and removed, trees and query results. */
+    uint32_t cache_stores;
+    uint32_t cache_evictions;
+} TSAbapBulkSummary;
+
+/**
+ * Called once per file, from the worker thread that parsed it. With more
+ * than one thread the calls run concurrently and in any order, so anything
+ * the callback shares through `payload` needs its own locking. `index` is
+ * the position of the file in the sorted file list.
+ */
+typedef void (*TSAbapBulkCallback)(void* payload, uint32_t index,
+                                   const TSAbapBulkFileResult* result);
+
+typedef struct
+{
+    /** Worker threads, 0 for one per online cpu. */
+    uint32_t threads;
+    /** Time budget per file in microseconds, 0 for none. */
+    uint64_t timeout_micros;
+    /** Optional query source to run over every tree. */
+    const char* query;
+    uint32_t query_length;
+    /** Optional, runs concurrently on the worker threads. */
+    TSAbapBulkCallback callback;
+    void* payload;
+    /**
+     * Optional directory of a parse result cache, see
+     * tree-sitter-abap-cache.h. Files found there are not parsed, the
+     * others are stored after parsing.
+     */
+    const char* cache_directory;
+    /** Size limit of the cache directory in bytes, 0 for none. */
+    uint64_t cache_max_bytes;
+    /**
+     * Optional, set to the sum of the scanner counters of all parsed files.
+     * Left untouched unless built with TREE_SITTER_ABAP_SCANNER_STATS.
+     */
+    TSAbapScannerStats* scanner_stats;
+} TSAbapBulkOptions;
+
+/**
+ * Parses every `*.abap` file below the given paths, files are taken as
+ * they are. Symbolic links to directories below a path are not followed,
+ * so a link cycle can not make the walk endless, links to files are.
+ * Returns false if a path does not exist or the query does not compile,
+ * with a message on stderr.
+ */
+bool tree_sitter_abap_bulk_parse(const char* const* paths, uint32_t count,
+                                 const TSAbapBulkOptions* options,
+                                 TSAbapBulkSummary* summary);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_ABAP_BULK_H_
@@ -0,0 +1,123 @@
+#ifndef TREE_SITTER_ABAP_CACHE_H_
+#define TREE_SITTER_ABAP_CACHE_H_
+
+#include "tree-sitter-abap-cst.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A content addressed cache of parse results on local disk.
+ *
+ * Entries are keyed by a 128 bit hash of the source and live below a
+ * directory named after the ABI version and the grammar hash of the
+ * language, see tree_sitter_abap_cst_grammar_hash, so that a new grammar
+ * never sees the entries of an old one. Trees are stored as CST files with
+ * the source embedded and are only returned if that source equals the one
+ * looked up. Query results are stored next to them, keyed by the hash of
+ * the query source as well.
+ *
+ * Entries are written to a temporary file and renamed into place, so any
+ * number of threads and processes may read and write the same directory:
+ * a reader sees a whole entry or none. A hit sets the modification time of
+ * the entry, which is what eviction goes by: once more than an eighth of the
+ * size limit has been written, the oldest entries of all grammars are
+ * removed until the directory is below seven eighths of the limit. Only one
+ * process trims at a time, the others carry on.
+ *
+ * Built from `tools/` as part of `libtree-sitter-abap-tools`.
+ */
+
+typedef struct TSAbapCache TSAbapCache;
+
+typedef struct
+{
+    uint64_t low;
+    uint64_t high;
+} TSAbapCacheKey;
+
+/** One capture of a query match, in the order the matches were returned. */
+typedef struct
+{
+    uint32_t pattern_index;
+    uint32_t capture_index;
+    uint32_t start_byte;
+    uint32_t end_byte;
+} TSAbapCacheCapture;
+
+/** Counters of one open cache, since it was opened. */
+typedef struct
+{
+    uint64_t lookups;
+    uint64_t hits;
+    /** Time spent hashing sources and looking up entries. */
+    uint64_t lookup_ns;
+    uint64_t stores;
+    uint64_t stored_bytes;
+    uint64_t evictions;
+    uint64_t evicted_bytes;
+} TSAbapCacheStats;
+
+/**
+ * Opens the cache in the directory, creating it if needed. `max_bytes` is
+ * the size limit of the whole directory, 0 for none. Returns NULL, with a
+ * message on stderr, if the directory cannot be created.
+ */
+TSAbapCache* tree_sitter_abap_cache_open(const char* directory,
+                                         uint64_t max_bytes);
+
+/** Trims the directory if needed and releases the cache. */
+void tree_sitter_abap_cache_close(TSAbapCache* self);
+
+/** The key of the source, counted as lookup time. */
+TSAbapCacheKey tree_sitter_abap_cache_key(TSAbapCache* self, const char* data,
+                                          uint32_t length);
+
+/**
+ * The cached tree of the source, or NULL on a miss. Entries that cannot be
+ * read are removed.
+ */
+TSAbapCst* tree_sitter_abap_cache_get_tree(TSAbapCache* self,
+                                           TSAbapCacheKey key,
+                                           const char* source,
+                                           uint32_t length);
+
+bool tree_sitter_abap_cache_put_tree(TSAbapCache* self, TSAbapCacheKey key,
+                                     const TSTree* tree, const char* source,
+                                     uint32_t length);
+
+/**
+ * The cached captures of the query over the tree of the source, in a buffer
+ * to be released with `free`. Returns false on a miss.
+ */
+bool tree_sitter_abap_cache_get_captures(TSAbapCache* self,
+                                         TSAbapCacheKey key,
+                                         TSAbapCacheKey query,
+                                         TSAbapCacheCapture** captures,
+                                         uint32_t* count);
+
+bool tree_sitter_abap_cache_put_captures(TSAbapCache* self,
+                                         TSAbapCacheKey key,
+                                         TSAbapCacheKey query,
+                                         const TSAbapCacheCapture* captures,
+                                         uint32_t count);
+
+/**
+ * Evicts the oldest entries until the directory is below the limit. Called
+ * by the cache itself, see above. Returns false if another process is
+ * already trimming.
+ */
+bool tree_sitter_abap_cache_trim(TSAbapCache* self);
+
+void tree_sitter_abap_cache_stats(const TSAbapCache* self,
+                                  TSAbapCacheStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_ABAP_CACHE_H_
@@ -0,0 +1,82 @@
+#ifndef TREE_SITTER_ABAP_CHAIN_H_
+#define TREE_SITTER_ABAP_CHAIN_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Expands chained statements before parsing.
+ *
+ * ABAP repeats everything in front of the colon of a chained statement for
+ * every comma separated part after it, so that
+ * `REPLACE ALL OCCURRENCES OF foo IN: bar WITH '', baz WITH ''.` is
+ * `REPLACE ALL OCCURRENCES OF foo IN bar WITH ''.` followed by the same for
+ * `baz`. The grammar only supports chaining where it is common, other
+ * chains parse to ERROR nodes and slow error recovery. Parsing the expanded
+ * source instead gives the trees of the long forms, and the offset map
+ * translates their positions back to the source.
+ *
+ * Literals, string templates and comments are skipped, commas inside
+ * parentheses do not separate parts. Macro definitions, native SQL between
+ * `EXEC SQL` and `ENDEXEC` and AMDP method bodies are left as they are, as
+ * are statements with more than one colon.
+ *
+ * Built from `tools/` as part of `libtree-sitter-abap-tools`.
+ */
+
+typedef struct TSAbapChainExpansion TSAbapChainExpansion;
+
+/**
+ * Expands the chained statements of a source owned by the caller, which
+ * must outlive the result. Without chains, the expanded source is the
+ * source itself and nothing is copied.
+ */
+TSAbapChainExpansion* tree_sitter_abap_expand_chains(const char* source,
+                                                     uint32_t length);
+
+void tree_sitter_abap_chain_expansion_delete(TSAbapChainExpansion* self);
+
+/** The source to parse instead of the original one. */
+const char* tree_sitter_abap_chain_expansion_source(
+        const TSAbapChainExpansion* self, uint32_t* length);
+
+/** The number of chained statements that were expanded. */
+uint32_t tree_sitter_abap_chain_expansion_chain_count(
+        const TSAbapChainExpansion* self);
+
+/**
+ * The number of entries in the offset map, each a run of expanded bytes
+ * that maps to a run of original bytes of the same length. 0 if there was
+ * nothing to expand.
+ */
+uint32_t tree_sitter_abap_chain_expansion_segment_count(
+        const TSAbapChainExpansion* self);
+
+/**
+ * The original offset of a byte of the expanded source. The text in front
+ * of a colon occurs once per part in the expanded source, all of its copies
+ * map to the original. The periods that end the parts, and blanks added
+ * after them, map to their commas, the blanks in place of the colon to the
+ * colon. The end of the expanded source maps to the end of the original.
+ */
+uint32_t tree_sitter_abap_chain_expansion_original_byte(
+        const TSAbapChainExpansion* self, uint32_t byte);
+
+/**
+ * The original range of a node of a tree parsed from the expanded source,
+ * from the original offset of its first to that of its last byte.
+ */
+void tree_sitter_abap_chain_expansion_original_range(
+        const TSAbapChainExpansion* self, TSNode node, uint32_t* start_byte,
+        uint32_t* end_byte);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_ABAP_CHAIN_H_
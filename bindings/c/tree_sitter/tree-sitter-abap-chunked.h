@@ -0,0 +1,92 @@
+#ifndef TREE_SITTER_ABAP_CHUNKED_H_
+#define TREE_SITTER_ABAP_CHUNKED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Parses a single large source, e.g. a generated function group, as several
+ * chunks on a pool of threads.
+ *
+ * The source is split right after the statement that precedes a top-level
+ * processing block or declaration: `CLASS`, `INTERFACE`, `FORM`,
+ * `FUNCTION`, `MODULE` and the `INITIALIZATION`, `START-OF-SELECTION`,
+ * `LOAD-OF-PROGRAM` and `AT SELECTION-SCREEN` events. Each chunk is parsed
+ * over the whole source restricted to its range, so all positions in the
+ * chunk trees are positions in the source, and the top-level nodes of the
+ * chunk trees in order are the top-level nodes of a parse of the whole.
+ *
+ * Built from `tools/` as part of `libtree-sitter-abap-tools`.
+ */
+
+typedef struct TSAbapChunkedTree TSAbapChunkedTree;
+
+typedef struct
+{
+    /** Worker threads, 0 for one per online cpu. */
+    uint32_t threads;
+    /**
+     * Smallest chunk worth a parse of its own in bytes, 0 for 1 MiB. Sources
+     * below twice this size are parsed in one piece.
+     */
+    uint32_t min_chunk_bytes;
+} TSAbapChunkedOptions;
+
+/**
+ * Finds the chunk ranges of the source for the given number of threads.
+ * Returns an array of `*count` ranges covering the whole source, to be
+ * released with `free`.
+ */
+TSRange* tree_sitter_abap_chunk_ranges(const char* source, uint32_t length,
+                                       const TSAbapChunkedOptions* options,
+                                       uint32_t* count);
+
+/**
+ * Parses a source owned by the caller, which must outlive the result.
+ * Returns NULL if out of memory. Worker threads that can not be started
+ * leave their chunks to the calling thread.
+ */
+TSAbapChunkedTree* tree_sitter_abap_parse_chunked(
+        const char* source, uint32_t length,
+        const TSAbapChunkedOptions* options);
+
+/**
+ * Maps the file into memory and parses it without copying. Returns NULL,
+ * with a message on stderr, if the file cannot be mapped, is 4 GiB or
+ * larger or the memory runs out.
+ */
+TSAbapChunkedTree* tree_sitter_abap_parse_chunked_file(
+        const char* path, const TSAbapChunkedOptions* options);
+
+void tree_sitter_abap_chunked_tree_delete(TSAbapChunkedTree* self);
+
+/** The parsed source, for a file the mapping. */
+const char* tree_sitter_abap_chunked_tree_source(const TSAbapChunkedTree* self,
+                                                 uint32_t* length);
+
+uint32_t tree_sitter_abap_chunked_tree_chunk_count(
+        const TSAbapChunkedTree* self);
+
+/** The tree of a chunk, its included range is the range of the chunk. */
+const TSTree* tree_sitter_abap_chunked_tree_chunk(
+        const TSAbapChunkedTree* self, uint32_t index);
+
+/**
+ * The smallest node spanning the given range, looked up only in the chunk
+ * that contains `start`. No single tree spans a range that ends past that
+ * chunk, it yields the root of the chunk, which ends before `end`. Compare
+ * `ts_node_end_byte` with `end` to tell the two apart.
+ */
+TSNode tree_sitter_abap_chunked_tree_descendant_for_byte_range(
+        const TSAbapChunkedTree* self, uint32_t start, uint32_t end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_ABAP_CHUNKED_H_
@@ -0,0 +1,161 @@
+#ifndef TREE_SITTER_ABAP_CST_H_
+#define TREE_SITTER_ABAP_CST_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <tree_sitter/api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A flat binary format for parse results, read in place from a memory
+ * mapped file without parsing again.
+ *
+ * All integers are little-endian. A file starts with a 64 byte header:
+ *
+ *   offset  size  field
+ *        0     8  magic "ABAPCST\0"
+ *        8     4  format version, TREE_SITTER_ABAP_CST_VERSION
+ *       12     4  header size, 64
+ *       16     8  grammar hash, see tree_sitter_abap_cst_grammar_hash
+ *       24     4  node count
+ *       28     4  source length in bytes
+ *       32     4  flags, bit 0 set if the source is embedded
+ *       36     4  reserved, 0
+ *       40     8  file size
+ *       48    16  reserved, 0
+ *
+ * followed by one array per column, each with one entry per node and each
+ * starting at a multiple of 8 bytes, zero padded, in this order:
+ *
+ *   symbol, field, flags                                       uint16_t
+ *   start_byte, end_byte, start_row, start_column, end_row,
+ *   end_column, parent, first_child, next_sibling              uint32_t
+ *
+ * and, if embedded, the source. The nodes are in pre-order, the root is
+ * node 0 and the first child of a node is the node right after it. Missing
+ * parents, children and siblings are TREE_SITTER_ABAP_CST_NONE. The field
+ * is the id of the field the node is in within its parent, or 0.
+ *
+ * Built from `tools/` as part of `libtree-sitter-abap-tools`.
+ */
+
+#define TREE_SITTER_ABAP_CST_VERSION 1
+#define TREE_SITTER_ABAP_CST_NONE UINT32_MAX
+
+/** Bits of the flags column, the same as `NODE_*` in the Python binding. */
+enum
+{
+    TREE_SITTER_ABAP_CST_NAMED = 1,
+    TREE_SITTER_ABAP_CST_ERROR = 2,
+    TREE_SITTER_ABAP_CST_MISSING = 4,
+    TREE_SITTER_ABAP_CST_EXTRA = 8,
+    TREE_SITTER_ABAP_CST_HAS_ERROR = 16,
+};
+
+typedef enum
+{
+    TREE_SITTER_ABAP_CST_OK,
+    /** The file could not be opened or mapped, see errno. */
+    TREE_SITTER_ABAP_CST_IO_ERROR,
+    /** Not a CST file, or truncated or inconsistent. */
+    TREE_SITTER_ABAP_CST_BAD_FORMAT,
+    /** Written in another version of the format. */
+    TREE_SITTER_ABAP_CST_BAD_VERSION,
+    /** Written with another grammar, the symbol and field ids differ. */
+    TREE_SITTER_ABAP_CST_STALE,
+} TSAbapCstStatus;
+
+typedef struct TSAbapCst TSAbapCst;
+
+/** The columns of a loaded file, pointing into the file itself. */
+typedef struct
+{
+    uint32_t node_count;
+    const uint16_t* symbol;
+    const uint16_t* field;
+    const uint16_t* flags;
+    const uint32_t* start_byte;
+    const uint32_t* end_byte;
+    const uint32_t* start_row;
+    const uint32_t* start_column;
+    const uint32_t* end_row;
+    const uint32_t* end_column;
+    const uint32_t* parent;
+    const uint32_t* first_child;
+    const uint32_t* next_sibling;
+    /** NULL unless the source is embedded. */
+    const char* source;
+    uint32_t source_length;
+} TSAbapCstColumns;
+
+/**
+ * A hash of the symbol and field tables of the language: the name, named
+ * and visible flags of every symbol and the name of every field, in id
+ * order. Files are only read by a grammar with the same hash.
+ */
+uint64_t tree_sitter_abap_cst_grammar_hash(const TSLanguage* language);
+
+/**
+ * Serializes the tree into a buffer to be released with `free`, embedding
+ * the source unless it is NULL. Returns NULL if out of memory.
+ */
+void* tree_sitter_abap_cst_serialize(const TSTree* tree, const char* source,
+                                     uint32_t length, size_t* size);
+
+/**
+ * Writes the tree to a file, see tree_sitter_abap_cst_serialize. Returns
+ * false, with a message on stderr, if the file cannot be written.
+ */
+bool tree_sitter_abap_cst_write_file(const char* path, const TSTree* tree,
+                                     const char* source, uint32_t length);
+
+/**
+ * Maps the file into memory and checks its header against the ABAP
+ * grammar, and its links, symbols and fields against the node count and
+ * the language. Returns NULL and sets `*status` if it cannot be used.
+ */
+TSAbapCst* tree_sitter_abap_cst_open(const char* path,
+                                     TSAbapCstStatus* status);
+
+/**
+ * Reads a file already in memory, 4 byte aligned and owned by the caller,
+ * which must outlive the result.
+ */
+TSAbapCst* tree_sitter_abap_cst_from_buffer(const void* data, size_t size,
+                                            TSAbapCstStatus* status);
+
+void tree_sitter_abap_cst_close(TSAbapCst* self);
+
+const TSAbapCstColumns* tree_sitter_abap_cst_columns(const TSAbapCst* self);
+
+/**
+ * The node after the last descendant of `node`, so that its subtree is the
+ * nodes from `node` up to here.
+ */
+uint32_t tree_sitter_abap_cst_subtree_end(const TSAbapCst* self,
+                                          uint32_t node);
+
+/**
+ * The first node of the given symbol in [from, end), or
+ * TREE_SITTER_ABAP_CST_NONE. Scans the symbol column only, so listing the
+ * nodes of a type in a subtree is a loop over this with `from` one past the
+ * last match.
+ */
+uint32_t tree_sitter_abap_cst_find_symbol(const TSAbapCst* self,
+                                          TSSymbol symbol, uint32_t from,
+                                          uint32_t end);
+
+/** The smallest node spanning the given byte range. */
+uint32_t tree_sitter_abap_cst_descendant_for_byte_range(const TSAbapCst* self,
+                                                        uint32_t start,
+                                                        uint32_t end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_ABAP_CST_H_
@@ -0,0 +1,40 @@
+#ifndef TREE_SITTER_ABAP_DOC_H_
+#define TREE_SITTER_ABAP_DOC_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The text of ABAP Doc comments.
+ *
+ * A `paragraph` node of a `docstring` spans all of its lines, including the
+ * `"!` that starts each line after the first. Its text is also written with
+ * the escapes ABAP Doc requires for its special characters, `&quot;`,
+ * `&apos;`, `&lt;`, `&gt;`, `&#64;`, `&#123;`, `&#124;` and `&#125;`, and
+ * with `&amp;` and the `\{` and `\}` the grammar accepts outside of
+ * doclinks.
+ *
+ * Built from `tools/` as part of `libtree-sitter-abap-tools`.
+ */
+
+/**
+ * Writes the text of a paragraph, the source in the range of its node, to
+ * `out` as it reads. Each line break, together with the blanks and the `"!`
+ * around it, becomes a single blank, and the escapes above and any other
+ * decimal character reference below 128 are decoded. Doclinks and anything
+ * else are copied as they are.
+ *
+ * The text never grows, `out` needs room for `length` bytes and may be
+ * `text` itself. Returns the number of bytes written.
+ */
+uint32_t tree_sitter_abap_doc_text(const char* text, uint32_t length,
+                                   char* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_ABAP_DOC_H_
@@ -0,0 +1,101 @@
+#ifndef TREE_SITTER_ABAP_SCANNER_STATS_H_
+#define TREE_SITTER_ABAP_SCANNER_STATS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Counters of the external scanner in `src/scanner.c`.
+ *
+ * Only compiled in with TREE_SITTER_ABAP_SCANNER_STATS defined, through
+ * `make SCANNER_STATS=1` or the CMake option of the same name. Without it,
+ * none of the functions below exist and the scanner is built as if the
+ * counters were never there.
+ *
+ * Every call of the scanner walks through the checks of its branches in a
+ * fixed order and may enter several before one returns. A branch counts the
+ * calls that entered it, the calls that returned a token from it and the
+ * calls that returned nothing from it, the rest fell through to a later
+ * one. Advanced bytes, skipped or not, count for the branch entered last.
+ *
+ * The counters are per thread, a parse runs on the thread that started it.
+ * Reset them before a parse and read them after it for the counters of that
+ * parse. Parsers generated with tree-sitter lex everything else in the
+ * generated `ts_lex`, which is not counted.
+ */
+
+/** The branches of the scanner, in the order they are checked. */
+enum
+{
+    /** Error recovery asked, nothing is lexed. */
+    TREE_SITTER_ABAP_SCANNER_BRANCH_ERROR_RECOVERY,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_COMMENT_CHUNK,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_AMDP_BODY,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_SQL_BODY,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_PARAGRAPH_TEXT,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_EVENT_BLOCK_END,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_CONTEXTUAL_NAME,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_MESSAGE_TYPE,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_DOCSTRING_CONTINUATION,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_DOCTAG_TEXT,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_LINE_COMMENT,
+    /** Keywords, only with TREE_SITTER_ABAP_KEYWORD_SCANNER. */
+    TREE_SITTER_ABAP_SCANNER_BRANCH_KEYWORD,
+    /** Calls that entered no branch. */
+    TREE_SITTER_ABAP_SCANNER_BRANCH_NONE,
+    TREE_SITTER_ABAP_SCANNER_BRANCH_COUNT,
+};
+
+/**
+ * Sets of valid tokens are counted by a mask, bit i for the external token
+ * at index i of the grammar's `externals` up to the error sentinel, and
+ * this bit for any of the keyword tokens.
+ */
+#define TREE_SITTER_ABAP_SCANNER_KEYWORD_BIT 12
+#define TREE_SITTER_ABAP_SCANNER_VALID_SET_COUNT \
+    (1u << (TREE_SITTER_ABAP_SCANNER_KEYWORD_BIT + 1))
+
+typedef struct
+{
+    uint64_t calls;
+    uint64_t tokens;
+    uint64_t rejected;
+    uint64_t bytes;
+} TSAbapScannerCounter;
+
+typedef struct
+{
+    /** All calls, `rejected` are those that returned no token. */
+    TSAbapScannerCounter total;
+    TSAbapScannerCounter branches[TREE_SITTER_ABAP_SCANNER_BRANCH_COUNT];
+    /** Calls and the tokens returned by them per set of valid tokens. */
+    uint64_t valid_set_calls[TREE_SITTER_ABAP_SCANNER_VALID_SET_COUNT];
+    uint64_t valid_set_tokens[TREE_SITTER_ABAP_SCANNER_VALID_SET_COUNT];
+} TSAbapScannerStats;
+
+/** The counters of the calling thread since its last reset. */
+const TSAbapScannerStats* tree_sitter_abap_scanner_stats(void);
+
+void tree_sitter_abap_scanner_stats_reset(void);
+
+/** Adds `other` to `self`, for totals over files or threads. */
+void tree_sitter_abap_scanner_stats_add(TSAbapScannerStats* self,
+                                        const TSAbapScannerStats* other);
+
+/**
+ * Writes the counters as a single line JSON object, leaving out branches
+ * that were never entered. The valid sets are listed by the names of their
+ * tokens, most called first.
+ */
+void tree_sitter_abap_scanner_stats_write_json(const TSAbapScannerStats* self,
+                                               FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TREE_SITTER_ABAP_SCANNER_STATS_H_
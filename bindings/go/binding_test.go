@@ -1,7 +1,15 @@
 package tree_sitter_abap_test
 
 import (
+	"context"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"runtime"
+	"strings"
 	"testing"
+	"time"
 
 	tree_sitter "github.com/tree-sitter/go-tree-sitter"
 	tree_sitter_abap "github.com/kennyhml/tree-sitter-abap/bindings/go"
@@ -13,3 +21,163 @@ func TestCanLoadGrammar(t *testing.T) {
 		t.Errorf("Error loading Abap grammar")
 	}
 }
+
+const reportUnit = `
+CLASS lcl_feature_%[1]d DEFINITION FINAL.
+  PUBLIC SECTION.
+    METHODS total IMPORTING it_values TYPE int4_table
+                  RETURNING VALUE(rv) TYPE i.
+ENDCLASS.
+
+CLASS lcl_feature_%[1]d IMPLEMENTATION.
+  METHOD total.
+    LOOP AT it_values INTO DATA(lv_value).
+      rv = rv + lv_value * %[1]d.
+    ENDLOOP.
+    DATA(lv_text) = |Feature { rv } of %[1]d|.
+  ENDMETHOD.
+ENDCLASS.
+`
+
+// report generates a report of about size bytes.
+func report(size int) []byte {
+	var source strings.Builder
+	source.WriteString("REPORT zpool.\n")
+	for i := 0; source.Len() < size; i++ {
+		fmt.Fprintf(&source, reportUnit, i)
+	}
+	return []byte(source.String())
+}
+
+// writeReports writes count reports of about size bytes to a temporary
+// directory and returns their paths.
+func writeReports(tb testing.TB, count, size int) []string {
+	dir := tb.TempDir()
+	source := report(size)
+	paths := make([]string, count)
+	for i := range paths {
+		paths[i] = filepath.Join(dir, fmt.Sprintf("zpool_%d.prog.abap", i))
+		if err := os.WriteFile(paths[i], source, 0o644); err != nil {
+			tb.Fatal(err)
+		}
+	}
+	return paths
+}
+
+func TestParseFiles(t *testing.T) {
+	paths := writeReports(t, 32, 8*1024)
+	paths = append(paths, filepath.Join(t.TempDir(), "missing.prog.abap"))
+
+	results, err := tree_sitter_abap.ParseFiles(context.Background(), paths, 4)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for i, result := range results[:len(results)-1] {
+		if result.Path != paths[i] || result.Err != nil {
+			t.Fatalf("%s: %v", result.Path, result.Err)
+		}
+		if result.Tree.RootNode().HasError() {
+			t.Errorf("%s: parse has errors", result.Path)
+		}
+		result.Tree.Close()
+	}
+	if missing := results[len(results)-1]; !errors.Is(missing.Err, os.ErrNotExist) {
+		t.Errorf("expected a missing file error, got %v", missing.Err)
+	}
+}
+
+func TestParseCancelled(t *testing.T) {
+	pool := tree_sitter_abap.NewParserPool(1)
+	defer pool.Close()
+	source := report(8 * 1024 * 1024)
+
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	if _, err := pool.Parse(ctx, source); !errors.Is(err, context.Canceled) {
+		t.Fatalf("expected context.Canceled, got %v", err)
+	}
+
+	ctx, cancel = context.WithTimeout(context.Background(), time.Millisecond)
+	defer cancel()
+	if _, err := pool.Parse(ctx, source); !errors.Is(err, context.DeadlineExceeded) {
+		t.Fatalf("expected context.DeadlineExceeded, got %v", err)
+	}
+
+	// The parser goes back to the pool and must start afresh.
+	tree, err := pool.Parse(context.Background(), report(4*1024))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer tree.Close()
+	if tree.RootNode().HasError() {
+		t.Error("parse after a cancelled parse has errors")
+	}
+}
+
+// A new parser per parse, what ParserPool saves.
+func BenchmarkParseNewParser(b *testing.B) {
+	language := tree_sitter.NewLanguage(tree_sitter_abap.Language())
+	source := report(16 * 1024)
+	b.SetBytes(int64(len(source)))
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		parser := tree_sitter.NewParser()
+		parser.SetLanguage(language)
+		parser.Parse(source, nil).Close()
+		parser.Close()
+	}
+}
+
+func BenchmarkParserPool(b *testing.B) {
+	pool := tree_sitter_abap.NewParserPool(0)
+	defer pool.Close()
+	source := report(16 * 1024)
+	ctx := context.Background()
+	b.SetBytes(int64(len(source)))
+	b.ReportAllocs()
+	b.RunParallel(func(pb *testing.PB) {
+		for pb.Next() {
+			tree, err := pool.Parse(ctx, source)
+			if err != nil {
+				b.Error(err)
+				return
+			}
+			tree.Close()
+		}
+	})
+}
+
+// Throughput of ParseFiles as GOMAXPROCS grows, in MB/s of source.
+func BenchmarkParseFiles(b *testing.B) {
+	paths := writeReports(b, 256, 16*1024)
+	var bytes int64
+	for _, path := range paths {
+		info, err := os.Stat(path)
+		if err != nil {
+			b.Fatal(err)
+		}
+		bytes += info.Size()
+	}
+
+	for _, procs := range []int{1, 2, 4, 8, 16} {
+		if procs > runtime.NumCPU() && procs != 1 {
+			break
+		}
+		b.Run(fmt.Sprintf("GOMAXPROCS=%d", procs), func(b *testing.B) {
+			defer runtime.GOMAXPROCS(runtime.GOMAXPROCS(procs))
+			pool := tree_sitter_abap.NewParserPool(procs)
+			defer pool.Close()
+			b.SetBytes(bytes)
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				results, err := pool.ParseFiles(context.Background(), paths, procs)
+				if err != nil {
+					b.Fatal(err)
+				}
+				for _, result := range results {
+					result.Tree.Close()
+				}
+			}
+		})
+	}
+}
@@ -0,0 +1,195 @@
+package tree_sitter_abap
+
+// #include <stdlib.h>
+import "C"
+
+import (
+	"context"
+	"os"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"unsafe"
+
+	tree_sitter "github.com/tree-sitter/go-tree-sitter"
+)
+
+// A parser of the pool with its cancellation flag. The flag lives in C
+// memory, the runtime keeps a pointer to it for the life of the parser.
+type pooledParser struct {
+	parser *tree_sitter.Parser
+	cancel *uintptr
+}
+
+// ParserPool hands out ABAP parsers to concurrent parses, so that a parse
+// does not pay for creating a parser and setting its language. Idle parsers
+// are kept up to the size of the pool, parsers beyond that are closed when
+// they are returned.
+type ParserPool struct {
+	language *tree_sitter.Language
+	idle     chan *pooledParser
+}
+
+// NewParserPool creates a pool keeping up to size idle parsers, one per
+// GOMAXPROCS if size is not positive.
+func NewParserPool(size int) *ParserPool {
+	if size <= 0 {
+		size = runtime.GOMAXPROCS(0)
+	}
+	return &ParserPool{
+		language: tree_sitter.NewLanguage(Language()),
+		idle:     make(chan *pooledParser, size),
+	}
+}
+
+func (p *ParserPool) get() (*pooledParser, error) {
+	select {
+	case parser := <-p.idle:
+		return parser, nil
+	default:
+	}
+	parser := tree_sitter.NewParser()
+	if err := parser.SetLanguage(p.language); err != nil {
+		parser.Close()
+		return nil, err
+	}
+	flag := (*uintptr)(C.calloc(1, C.size_t(unsafe.Sizeof(uintptr(0)))))
+	parser.SetCancellationFlag(flag)
+	return &pooledParser{parser: parser, cancel: flag}, nil
+}
+
+func (p *ParserPool) put(parser *pooledParser) {
+	select {
+	case p.idle <- parser:
+	default:
+		parser.close()
+	}
+}
+
+func (parser *pooledParser) close() {
+	parser.parser.Close()
+	C.free(unsafe.Pointer(parser.cancel))
+}
+
+// Parse parses source with a parser of the pool. The whole source is handed
+// to the runtime in one call rather than read through a callback, so the
+// parse crosses into C once. Cancelling ctx stops the parse and returns
+// ctx.Err(). The caller owns the tree and must close it.
+func (p *ParserPool) Parse(ctx context.Context, source []byte) (*tree_sitter.Tree, error) {
+	if err := ctx.Err(); err != nil {
+		return nil, err
+	}
+	parser, err := p.get()
+	if err != nil {
+		return nil, err
+	}
+	cancelled := make(chan struct{})
+	stop := context.AfterFunc(ctx, func() {
+		atomic.StoreUintptr(parser.cancel, 1)
+		close(cancelled)
+	})
+	tree := parser.parser.Parse(source, nil)
+	if !stop() {
+		// Cancelled, possibly after the parse finished. A cancelled parse
+		// leaves state behind that the next parse would resume from.
+		<-cancelled
+		atomic.StoreUintptr(parser.cancel, 0)
+		parser.parser.Reset()
+	}
+	p.put(parser)
+
+	if tree == nil {
+		if err := ctx.Err(); err != nil {
+			return nil, err
+		}
+		return nil, errParseFailed
+	}
+	return tree, nil
+}
+
+// Close closes the idle parsers. Parsers still in use are closed when they
+// are returned, the pool must not be used for new parses afterwards.
+func (p *ParserPool) Close() {
+	for {
+		select {
+		case parser := <-p.idle:
+			parser.close()
+		default:
+			return
+		}
+	}
+}
+
+type parseError string
+
+func (e parseError) Error() string { return string(e) }
+
+const errParseFailed = parseError("tree-sitter-abap: parse failed")
+
+// FileResult is the outcome of parsing one file in ParseFiles. Tree is nil
+// if Err is set, otherwise the caller owns it and must close it.
+type FileResult struct {
+	Path string
+	Tree *tree_sitter.Tree
+	Err  error
+}
+
+// ParseFiles reads and parses the files at paths with up to workers
+// goroutines, one per GOMAXPROCS if workers is not positive, and returns
+// the results in the order of paths. Files that cannot be read have Err
+// set. Once ctx is cancelled running parses stop, the remaining files are
+// skipped and ctx.Err() is returned along with the trees parsed so far.
+func (p *ParserPool) ParseFiles(ctx context.Context, paths []string, workers int) ([]FileResult, error) {
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	if workers > len(paths) {
+		workers = len(paths)
+	}
+
+	results := make([]FileResult, len(paths))
+	var next atomic.Int64
+	var wg sync.WaitGroup
+	wg.Add(workers)
+	for w := 0; w < workers; w++ {
+		go func() {
+			defer wg.Done()
+			for ctx.Err() == nil {
+				i := int(next.Add(1) - 1)
+				if i >= len(paths) {
+					return
+				}
+				result := &results[i]
+				result.Path = paths[i]
+				source, err := os.ReadFile(paths[i])
+				if err != nil {
+					result.Err = err
+					continue
+				}
+				result.Tree, result.Err = p.Parse(ctx, source)
+			}
+		}()
+	}
+	wg.Wait()
+
+	if err := ctx.Err(); err != nil {
+		for i := range results {
+			if results[i].Path == "" {
+				results[i] = FileResult{Path: paths[i], Err: err}
+			}
+		}
+		return results, err
+	}
+	return results, nil
+}
+
+var (
+	defaultPool     *ParserPool
+	defaultPoolOnce sync.Once
+)
+
+// ParseFiles is ParserPool.ParseFiles on a pool shared by the package.
+func ParseFiles(ctx context.Context, paths []string, workers int) ([]FileResult, error) {
+	defaultPoolOnce.Do(func() { defaultPool = NewParserPool(0) })
+	return defaultPool.ParseFiles(ctx, paths, workers)
+}
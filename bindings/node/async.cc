@@ -0,0 +1,278 @@
+#include <napi.h>
+
+#include <tree_sitter/api.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+extern "C" TSLanguage *tree_sitter_abap();
+
+// Parsing on the libuv thread pool for parseAsync in async.js.
+//
+// A tree cannot be handed to node-tree-sitter, its trees only come from its
+// own parser. The worker therefore flattens the tree into a table of
+// numbers on the pool thread as well, and async.js wraps that table in
+// objects shaped like node-tree-sitter's. The source is parsed as UTF-16,
+// the way node-tree-sitter parses strings, so indices and columns are in
+// UTF-16 code units just like there.
+
+namespace {
+
+// One row of the node table, keep in sync with async.js.
+enum Column : uint32_t {
+    PARENT,
+    PREVIOUS_SIBLING,
+    NEXT_SIBLING,
+    CHILD_COUNT,
+    START_INDEX,
+    END_INDEX,
+    START_ROW,
+    START_COLUMN,
+    END_ROW,
+    END_COLUMN,
+    SYMBOL_AND_FIELD,
+    FLAGS,
+    STRIDE,
+};
+
+enum Flag : uint32_t {
+    NAMED = 1,
+    MISSING = 2,
+    EXTRA = 4,
+    ERROR = 8,
+    HAS_ERROR = 16,
+};
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+// The runtime reads the flag as a plain size_t.
+struct Cancellation {
+    std::atomic<size_t> flag{0};
+};
+
+static_assert(sizeof(std::atomic<size_t>) == sizeof(size_t),
+              "the cancellation flag must be layout compatible");
+
+const char *read_source(void *payload, uint32_t byte_index, TSPoint,
+                        uint32_t *bytes_read) {
+    auto *source = static_cast<const std::u16string *>(payload);
+    size_t length = source->size() * sizeof(char16_t);
+    if (byte_index >= length) {
+        *bytes_read = 0;
+        return "";
+    }
+    *bytes_read = static_cast<uint32_t>(length - byte_index);
+    return reinterpret_cast<const char *>(source->data()) + byte_index;
+}
+
+// Rows in pre-order, so the first child of a node is the next row.
+std::vector<uint32_t> *flatten(const TSTree *tree) {
+    TSNode root = ts_tree_root_node(tree);
+    auto *table = new std::vector<uint32_t>();
+    table->reserve(size_t(ts_node_descendant_count(root)) * STRIDE);
+
+    // The row of the node and of its last child seen so far at each depth.
+    std::vector<uint32_t> path;
+    std::vector<uint32_t> last_child;
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    uint32_t depth = 0;
+
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        uint32_t index = static_cast<uint32_t>(table->size() / STRIDE);
+        uint32_t parent = depth ? path[depth - 1] : NONE;
+        uint32_t previous = depth ? last_child[depth - 1] : NONE;
+        TSPoint start = ts_node_start_point(node);
+        TSPoint end = ts_node_end_point(node);
+        uint32_t flags = (ts_node_is_named(node) ? NAMED : 0) |
+                         (ts_node_is_missing(node) ? MISSING : 0) |
+                         (ts_node_is_extra(node) ? EXTRA : 0) |
+                         (ts_node_is_error(node) ? ERROR : 0) |
+                         (ts_node_has_error(node) ? HAS_ERROR : 0);
+        uint32_t row[STRIDE] = {
+            parent,
+            previous,
+            NONE,
+            0,
+            ts_node_start_byte(node) / 2,
+            ts_node_end_byte(node) / 2,
+            start.row,
+            start.column / 2,
+            end.row,
+            end.column / 2,
+            ts_node_symbol(node) |
+                uint32_t(ts_tree_cursor_current_field_id(&cursor)) << 16,
+            flags,
+        };
+        table->insert(table->end(), row, row + STRIDE);
+
+        if (previous != NONE) {
+            (*table)[previous * STRIDE + NEXT_SIBLING] = index;
+        }
+        if (parent != NONE) {
+            (*table)[parent * STRIDE + CHILD_COUNT]++;
+            last_child[depth - 1] = index;
+        }
+        if (path.size() <= depth) {
+            path.push_back(index);
+            last_child.push_back(NONE);
+        } else {
+            path[depth] = index;
+            last_child[depth] = NONE;
+        }
+
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            depth++;
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return table;
+            }
+            depth--;
+        }
+    }
+}
+
+class ParseWorker : public Napi::AsyncWorker {
+  public:
+    ParseWorker(Napi::Env env, std::u16string source, double timeout_micros,
+                std::shared_ptr<Cancellation> cancellation)
+        : Napi::AsyncWorker(env, "tree-sitter-abap:parseAsync"),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          source_(std::move(source)), timeout_micros_(timeout_micros),
+          cancellation_(std::move(cancellation)) {}
+
+    ~ParseWorker() override { delete table_; }
+
+    Napi::Promise Promise() { return deferred_.Promise(); }
+
+  protected:
+    void Execute() override {
+        // The flag and timeout API rather than ts_parser_parse_with_options,
+        // which the runtime vendored by node-tree-sitter 0.22 lacks.
+        TSParser *parser = ts_parser_new();
+        ts_parser_set_language(parser, tree_sitter_abap());
+        ts_parser_set_cancellation_flag(
+            parser, reinterpret_cast<const size_t *>(&cancellation_->flag));
+        if (timeout_micros_ > 0) {
+            ts_parser_set_timeout_micros(parser, uint64_t(timeout_micros_));
+        }
+        TSInput input = {};
+        input.payload = &source_;
+        input.read = read_source;
+#if TREE_SITTER_LANGUAGE_VERSION >= 15
+        input.encoding = TSInputEncodingUTF16LE;
+#else
+        input.encoding = TSInputEncodingUTF16;
+#endif
+        TSTree *tree = ts_parser_parse(parser, nullptr, input);
+        ts_parser_delete(parser);
+
+        if (!tree) {
+            bool aborted = cancellation_->flag.load() != 0;
+            error_name_ = aborted ? "AbortError" : "TimeoutError";
+            SetError(aborted ? "The parse was aborted"
+                             : "The parse exceeded its timeout");
+            return;
+        }
+        table_ = flatten(tree);
+        ts_tree_delete(tree);
+        std::u16string().swap(source_);
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        size_t length = table_->size();
+        size_t bytes = length * sizeof(uint32_t);
+        Napi::ArrayBuffer buffer;
+#ifndef NODE_API_NO_EXTERNAL_BUFFERS_ALLOWED
+        try {
+            // Hand the table over without copying it on the main thread.
+            buffer = Napi::ArrayBuffer::New(
+                env, table_->data(), bytes,
+                [](Napi::Env, void *, std::vector<uint32_t> *table) {
+                    delete table;
+                },
+                table_);
+            table_ = nullptr;
+        } catch (const Napi::Error &) {
+            // Runtimes with a V8 sandbox, e.g. Electron, refuse them.
+        }
+#endif
+        if (table_) {
+            buffer = Napi::ArrayBuffer::New(env, bytes);
+            std::memcpy(buffer.Data(), table_->data(), bytes);
+        }
+        deferred_.Resolve(Napi::Uint32Array::New(env, length, buffer, 0));
+    }
+
+    void OnError(const Napi::Error &error) override {
+        Napi::Error rejection = Napi::Error::New(Env(), error.Message());
+        rejection.Set("name", Napi::String::New(Env(), error_name_));
+        deferred_.Reject(rejection.Value());
+    }
+
+  private:
+    Napi::Promise::Deferred deferred_;
+    std::u16string source_;
+    double timeout_micros_;
+    std::shared_ptr<Cancellation> cancellation_;
+    std::vector<uint32_t> *table_ = nullptr;
+    std::string error_name_ = "Error";
+};
+
+// _startParse(source, timeoutMicros) -> { promise, cancel }
+Napi::Value StartParse(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        throw Napi::TypeError::New(env, "The source must be a string");
+    }
+    double timeout_micros = 0;
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        timeout_micros = info[1].As<Napi::Number>().DoubleValue();
+    }
+
+    auto cancellation = std::make_shared<Cancellation>();
+    auto *worker = new ParseWorker(env, info[0].As<Napi::String>().Utf16Value(),
+                                   timeout_micros, cancellation);
+    Napi::Object result = Napi::Object::New(env);
+    result["promise"] = worker->Promise();
+    result["cancel"] = Napi::Function::New(
+        env, [cancellation](const Napi::CallbackInfo &) {
+            cancellation->flag.store(1);
+        });
+    worker->Queue();
+    return result;
+}
+
+} // namespace
+
+void InitAsync(Napi::Env env, Napi::Object exports) {
+    const TSLanguage *language = tree_sitter_abap();
+
+    uint32_t symbol_count = ts_language_symbol_count(language);
+    Napi::Array symbols = Napi::Array::New(env, symbol_count);
+    for (uint32_t i = 0; i < symbol_count; i++) {
+        const char *name = ts_language_symbol_name(language, TSSymbol(i));
+        symbols[i] = Napi::String::New(env, name ? name : "");
+    }
+
+    // Field ids start at 1.
+    uint32_t field_count = ts_language_field_count(language);
+    Napi::Array fields = Napi::Array::New(env, field_count + 1);
+    fields[uint32_t(0)] = env.Null();
+    for (uint32_t i = 1; i <= field_count; i++) {
+        const char *name =
+            ts_language_field_name_for_id(language, TSFieldId(i));
+        fields[i] = Napi::String::New(env, name ? name : "");
+    }
+
+    exports["_nodeTypeNames"] = symbols;
+    exports["_fieldNames"] = fields;
+    exports["_startParse"] = Napi::Function::New(env, StartParse);
+}
@@ -0,0 +1,295 @@
+// parseAsync and parseBatchAsync, parsing on the libuv thread pool.
+//
+// The native side (async.cc) hands back the tree as a table of numbers, one
+// row per node in pre-order. The classes below read from that table and
+// follow the read-only part of node-tree-sitter's Tree and SyntaxNode, so
+// code walking the result does not care which parse produced it.
+
+// Columns of a row, keep in sync with async.cc.
+const PARENT = 0;
+const PREVIOUS_SIBLING = 1;
+const NEXT_SIBLING = 2;
+const CHILD_COUNT = 3;
+const START_INDEX = 4;
+const END_INDEX = 5;
+const START_ROW = 6;
+const START_COLUMN = 7;
+const END_ROW = 8;
+const END_COLUMN = 9;
+const SYMBOL_AND_FIELD = 10;
+const FLAGS = 11;
+const STRIDE = 12;
+
+const NAMED = 1;
+const MISSING = 2;
+const EXTRA = 4;
+const ERROR = 8;
+const HAS_ERROR = 16;
+
+const NONE = 0xffffffff;
+
+class SyntaxNode {
+  constructor(tree, index) {
+    this.tree = tree;
+    this.id = index;
+  }
+
+  _get(column) {
+    return this.tree._table[this.id * STRIDE + column];
+  }
+
+  _node(index) {
+    return index === NONE ? null : this.tree._node(index);
+  }
+
+  get typeId() {
+    return this._get(SYMBOL_AND_FIELD) & 0xffff;
+  }
+
+  get type() {
+    return this.tree._types[this.typeId];
+  }
+
+  get isNamed() {
+    return (this._get(FLAGS) & NAMED) !== 0;
+  }
+
+  get isMissing() {
+    return (this._get(FLAGS) & MISSING) !== 0;
+  }
+
+  get isExtra() {
+    return (this._get(FLAGS) & EXTRA) !== 0;
+  }
+
+  get isError() {
+    return (this._get(FLAGS) & ERROR) !== 0;
+  }
+
+  get hasError() {
+    return (this._get(FLAGS) & HAS_ERROR) !== 0;
+  }
+
+  get startIndex() {
+    return this._get(START_INDEX);
+  }
+
+  get endIndex() {
+    return this._get(END_INDEX);
+  }
+
+  get startPosition() {
+    return { row: this._get(START_ROW), column: this._get(START_COLUMN) };
+  }
+
+  get endPosition() {
+    return { row: this._get(END_ROW), column: this._get(END_COLUMN) };
+  }
+
+  get text() {
+    return this.tree._source.slice(this.startIndex, this.endIndex);
+  }
+
+  get parent() {
+    return this._node(this._get(PARENT));
+  }
+
+  get childCount() {
+    return this._get(CHILD_COUNT);
+  }
+
+  get children() {
+    const children = [];
+    for (let child = this.firstChild; child; child = child.nextSibling) {
+      children.push(child);
+    }
+    return children;
+  }
+
+  get namedChildren() {
+    return this.children.filter((child) => child.isNamed);
+  }
+
+  get namedChildCount() {
+    return this.namedChildren.length;
+  }
+
+  get firstChild() {
+    return this.childCount > 0 ? this.tree._node(this.id + 1) : null;
+  }
+
+  get lastChild() {
+    const children = this.children;
+    return children.length ? children[children.length - 1] : null;
+  }
+
+  get firstNamedChild() {
+    return this.namedChildren[0] ?? null;
+  }
+
+  get lastNamedChild() {
+    const children = this.namedChildren;
+    return children.length ? children[children.length - 1] : null;
+  }
+
+  get nextSibling() {
+    return this._node(this._get(NEXT_SIBLING));
+  }
+
+  get previousSibling() {
+    return this._node(this._get(PREVIOUS_SIBLING));
+  }
+
+  get nextNamedSibling() {
+    let node = this.nextSibling;
+    while (node && !node.isNamed) node = node.nextSibling;
+    return node;
+  }
+
+  get previousNamedSibling() {
+    let node = this.previousSibling;
+    while (node && !node.isNamed) node = node.previousSibling;
+    return node;
+  }
+
+  child(index) {
+    return this.children[index] ?? null;
+  }
+
+  namedChild(index) {
+    return this.namedChildren[index] ?? null;
+  }
+
+  childrenForFieldName(fieldName) {
+    const field = this.tree._fields.indexOf(fieldName);
+    if (field < 1) return [];
+    return this.children.filter(
+      (child) => child._get(SYMBOL_AND_FIELD) >>> 16 === field,
+    );
+  }
+
+  childForFieldName(fieldName) {
+    return this.childrenForFieldName(fieldName)[0] ?? null;
+  }
+
+  descendantsOfType(types) {
+    const wanted = new Set(Array.isArray(types) ? types : [types]);
+    const end = this._subtreeEnd();
+    const nodes = [];
+    for (let index = this.id + 1; index < end; index++) {
+      const node = this.tree._node(index);
+      if (wanted.has(node.type)) nodes.push(node);
+    }
+    return nodes;
+  }
+
+  // The row after the last descendant.
+  _subtreeEnd() {
+    for (let node = this; node; node = node.parent) {
+      const next = node._get(NEXT_SIBLING);
+      if (next !== NONE) return next;
+    }
+    return this.tree._table.length / STRIDE;
+  }
+
+  toString() {
+    if (this.isMissing) {
+      return `(MISSING ${this.isNamed ? this.type : JSON.stringify(this.type)})`;
+    }
+    let result = `(${this.type}`;
+    for (let child = this.firstChild; child; child = child.nextSibling) {
+      if (!child.isNamed && !child.isMissing) continue;
+      const field = this.tree._fields[child._get(SYMBOL_AND_FIELD) >>> 16];
+      result += field ? ` ${field}: ${child}` : ` ${child}`;
+    }
+    return result + ")";
+  }
+}
+
+class Tree {
+  constructor(table, source, types, fields) {
+    this._table = table;
+    this._source = source;
+    this._types = types;
+    this._fields = fields;
+    this._nodes = new Array(table.length / STRIDE);
+  }
+
+  _node(index) {
+    return (this._nodes[index] ??= new SyntaxNode(this, index));
+  }
+
+  get rootNode() {
+    return this._node(0);
+  }
+
+  getText(node) {
+    return node.text;
+  }
+}
+
+function abortError(signal) {
+  const reason = signal.reason;
+  if (reason instanceof Error) return reason;
+  const error = new Error("The parse was aborted");
+  error.name = "AbortError";
+  return error;
+}
+
+function bind(binding) {
+  if (typeof binding._startParse !== "function") {
+    const unavailable = () =>
+      Promise.reject(
+        new Error(
+          "tree-sitter-abap was built without the tree-sitter runtime, " +
+            "install tree-sitter and rebuild to use parseAsync",
+        ),
+      );
+    return { parseAsync: unavailable, parseBatchAsync: unavailable };
+  }
+
+  // Parses `source` on the thread pool, resolving with a read-only Tree.
+  // options.signal aborts the parse, options.timeoutMicros bounds it.
+  function parseAsync(source, options = {}) {
+    const { signal, timeoutMicros = 0 } = options;
+    if (signal?.aborted) return Promise.reject(abortError(signal));
+
+    const text = String(source);
+    const { promise, cancel } = binding._startParse(text, timeoutMicros);
+    const onAbort = () => cancel();
+    signal?.addEventListener("abort", onAbort, { once: true });
+    return promise.then(
+      (table) => {
+        signal?.removeEventListener("abort", onAbort);
+        return new Tree(table, text, binding._nodeTypeNames, binding._fieldNames);
+      },
+      (error) => {
+        signal?.removeEventListener("abort", onAbort);
+        throw error.name === "AbortError" && signal ? abortError(signal) : error;
+      },
+    );
+  }
+
+  // Parses all sources, as many at a time as the pool has threads
+  // (UV_THREADPOOL_SIZE). One failure rejects the batch and aborts the rest.
+  function parseBatchAsync(sources, options = {}) {
+    const controller = new AbortController();
+    const onAbort = () => controller.abort(options.signal.reason);
+    if (options.signal?.aborted) {
+      return Promise.reject(abortError(options.signal));
+    }
+    options.signal?.addEventListener("abort", onAbort, { once: true });
+
+    const parses = Array.from(sources, (source) =>
+      parseAsync(source, { ...options, signal: controller.signal }),
+    );
+    return Promise.all(parses).finally(() => {
+      options.signal?.removeEventListener("abort", onAbort);
+      controller.abort();
+    });
+  }
+
+  return { parseAsync, parseBatchAsync };
+}
+
+module.exports = { bind, Tree, SyntaxNode };
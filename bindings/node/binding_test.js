@@ -7,3 +7,115 @@ test("can load grammar", () => {
   const parser = new Parser();
   assert.doesNotThrow(() => parser.setLanguage(require(".")));
 });
+
+const language = require(".");
+const skip =
+  typeof language._startParse === "function"
+    ? false
+    : "built without the tree-sitter runtime";
+
+function unit(index) {
+  return `
+CLASS lcl_feature_${index} DEFINITION FINAL.
+  PUBLIC SECTION.
+    METHODS total IMPORTING it_values TYPE int4_table
+                  RETURNING VALUE(rv) TYPE i.
+ENDCLASS.
+
+CLASS lcl_feature_${index} IMPLEMENTATION.
+  METHOD total.
+    LOOP AT it_values INTO DATA(lv_value).
+      rv = rv + lv_value * ${index}.
+    ENDLOOP.
+    DATA(lv_text) = |Feature { rv } of ${index}|.
+  ENDMETHOD.
+ENDCLASS.
+`;
+}
+
+function report(bytes) {
+  const units = ["REPORT zasync.\n"];
+  let length = units[0].length;
+  for (let i = 0; length < bytes; i++) {
+    units.push(unit(i));
+    length += units[units.length - 1].length;
+  }
+  return units.join("");
+}
+
+test("parseAsync matches Parser.parse", { skip }, async () => {
+  const source = report(64 * 1024) + "\nDATA(lv_ümlaut) = 'ä'.\n";
+  const parser = new Parser();
+  parser.setLanguage(language);
+  const expected = parser.parse(source).rootNode;
+  const actual = (await language.parseAsync(source)).rootNode;
+
+  assert.strictEqual(actual.toString(), expected.toString());
+  assert.strictEqual(actual.endIndex, expected.endIndex);
+  assert.deepStrictEqual(actual.endPosition, expected.endPosition);
+  const last = actual.lastNamedChild;
+  assert.strictEqual(last.text, expected.lastNamedChild.text);
+  assert.strictEqual(last.parent, actual);
+});
+
+test("parseBatchAsync parses every source", { skip }, async () => {
+  const sources = Array.from({ length: 16 }, (_, i) => report(4096 * (i + 1)));
+  const trees = await language.parseBatchAsync(sources);
+  assert.strictEqual(trees.length, sources.length);
+  trees.forEach((tree, i) => {
+    assert.strictEqual(tree.rootNode.endIndex, sources[i].length);
+    assert.strictEqual(tree.rootNode.hasError, false);
+  });
+});
+
+test("parseAsync can be aborted", { skip }, async () => {
+  const controller = new AbortController();
+  const parse = language.parseAsync(report(20 * 1024 * 1024), {
+    signal: controller.signal,
+  });
+  controller.abort();
+  await assert.rejects(parse, { name: "AbortError" });
+});
+
+test("parseAsync times out", { skip }, async () => {
+  const parse = language.parseAsync(report(20 * 1024 * 1024), {
+    timeoutMicros: 1000,
+  });
+  await assert.rejects(parse, { name: "TimeoutError" });
+});
+
+// The point of parseAsync: the event loop keeps running while a large
+// source is parsed, unlike during Parser.parse.
+test("parseAsync keeps the event loop responsive", { skip }, async (t) => {
+  const source = report(20 * 1024 * 1024);
+
+  const parser = new Parser();
+  parser.setLanguage(language);
+  let start = performance.now();
+  parser.parse(source, null, { bufferSize: source.length + 1 });
+  const syncMs = performance.now() - start;
+
+  let last = performance.now();
+  let maxGapMs = 0;
+  const timer = setInterval(() => {
+    const now = performance.now();
+    maxGapMs = Math.max(maxGapMs, now - last);
+    last = now;
+  }, 1);
+  start = performance.now();
+  const tree = await language.parseAsync(source);
+  const asyncMs = performance.now() - start;
+  clearInterval(timer);
+
+  assert.strictEqual(tree.rootNode.endIndex, source.length);
+  t.diagnostic(
+    `sync parse ${syncMs.toFixed(1)} ms, async parse ${asyncMs.toFixed(1)} ms, ` +
+      `longest event loop stall ${maxGapMs.toFixed(1)} ms`,
+  );
+  // Building the result objects still happens on the main thread, but it
+  // is a small fraction of the parse.
+  assert.ok(
+    maxGapMs < syncMs / 4,
+    `event loop stalled for ${maxGapMs} ms of a ${syncMs} ms parse`,
+  );
+});
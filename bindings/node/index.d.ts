@@ -18,9 +18,70 @@ type NodeInfo =
       children: ChildNode[];
     });
 
+type Point = {
+  row: number;
+  column: number;
+};
+
+/** The read-only part of node-tree-sitter's SyntaxNode. */
+interface AsyncSyntaxNode {
+  readonly tree: AsyncTree;
+  readonly id: number;
+  readonly typeId: number;
+  readonly type: string;
+  readonly isNamed: boolean;
+  readonly isMissing: boolean;
+  readonly isExtra: boolean;
+  readonly isError: boolean;
+  readonly hasError: boolean;
+  readonly startIndex: number;
+  readonly endIndex: number;
+  readonly startPosition: Point;
+  readonly endPosition: Point;
+  readonly text: string;
+  readonly parent: AsyncSyntaxNode | null;
+  readonly children: AsyncSyntaxNode[];
+  readonly namedChildren: AsyncSyntaxNode[];
+  readonly childCount: number;
+  readonly namedChildCount: number;
+  readonly firstChild: AsyncSyntaxNode | null;
+  readonly lastChild: AsyncSyntaxNode | null;
+  readonly firstNamedChild: AsyncSyntaxNode | null;
+  readonly lastNamedChild: AsyncSyntaxNode | null;
+  readonly nextSibling: AsyncSyntaxNode | null;
+  readonly previousSibling: AsyncSyntaxNode | null;
+  readonly nextNamedSibling: AsyncSyntaxNode | null;
+  readonly previousNamedSibling: AsyncSyntaxNode | null;
+  child(index: number): AsyncSyntaxNode | null;
+  namedChild(index: number): AsyncSyntaxNode | null;
+  childForFieldName(fieldName: string): AsyncSyntaxNode | null;
+  childrenForFieldName(fieldName: string): AsyncSyntaxNode[];
+  descendantsOfType(types: string | string[]): AsyncSyntaxNode[];
+  toString(): string;
+}
+
+/** The read-only part of node-tree-sitter's Tree. */
+interface AsyncTree {
+  readonly rootNode: AsyncSyntaxNode;
+  getText(node: AsyncSyntaxNode): string;
+}
+
+type ParseAsyncOptions = {
+  /** Aborts the parse, the promise rejects with the abort reason. */
+  signal?: AbortSignal;
+  /** Rejects with a `TimeoutError` once the parse took longer. */
+  timeoutMicros?: number;
+};
+
 type Language = {
   language: unknown;
   nodeTypeInfo: NodeInfo[];
+  /** Parses on the libuv thread pool, see bindings/node/async.js. */
+  parseAsync(source: string, options?: ParseAsyncOptions): Promise<AsyncTree>;
+  parseBatchAsync(
+    sources: Iterable<string>,
+    options?: ParseAsyncOptions,
+  ): Promise<AsyncTree[]>;
 };
 
 declare const language: Language;
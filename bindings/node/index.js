@@ -9,3 +9,7 @@ module.exports =
 try {
   module.exports.nodeTypeInfo = require("../../src/node-types.json");
 } catch (_) {}
+
+const { parseAsync, parseBatchAsync } = require("./async").bind(module.exports);
+module.exports.parseAsync = parseAsync;
+module.exports.parseBatchAsync = parseBatchAsync;
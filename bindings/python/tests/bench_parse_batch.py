@@ -0,0 +1,98 @@
+"""Compares parse_batch against a loop over Parser.parse.
+
+    python bindings/python/tests/bench_parse_batch.py [--threads N] [path...]
+
+Parses every *.abap file below the given paths, or 500 generated reports of
+about 20 KB each, and prints the best of three runs of each approach as JSON.
+The loop keeps each tree only as long as it takes to count its nodes,
+parse_batch builds its node table.
+"""
+
+import json
+import sys
+from argparse import ArgumentParser
+from pathlib import Path
+from time import perf_counter_ns
+
+from tree_sitter import Language, Parser
+import tree_sitter_abap
+
+REPORT_UNIT = """
+CLASS lcl_feature_{0} DEFINITION FINAL.
+  PUBLIC SECTION.
+    METHODS total IMPORTING it_values TYPE int4_table
+                  RETURNING VALUE(rv) TYPE i.
+ENDCLASS.
+
+CLASS lcl_feature_{0} IMPLEMENTATION.
+  METHOD total.
+    LOOP AT it_values INTO DATA(lv_value).
+      rv = rv + lv_value * {0}.
+    ENDLOOP.
+    DATA(lv_text) = |Feature {{ rv }} of {0}|.
+  ENDMETHOD.
+ENDCLASS.
+"""
+
+
+def collect(paths):
+    sources = []
+    for root in paths:
+        root = Path(root)
+        files = [root] if root.is_file() else sorted(root.rglob("*.abap"))
+        sources += [file.read_bytes() for file in files]
+    if not sources:
+        for i in range(500):
+            units = "".join(REPORT_UNIT.format(i * 50 + j) for j in range(50))
+            sources.append(f"REPORT zbatch_{i}.\n{units}".encode())
+    return sources
+
+
+def best_of(runs, function):
+    best = None
+    for _ in range(runs):
+        start = perf_counter_ns()
+        function()
+        elapsed = perf_counter_ns() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    arguments = ArgumentParser(description=__doc__.splitlines()[0])
+    arguments.add_argument("--threads", type=int, default=0)
+    arguments.add_argument("--repeat", type=int, default=3)
+    arguments.add_argument("paths", nargs="*")
+    options = arguments.parse_args()
+
+    sources = collect(options.paths)
+    parser = Parser(Language(tree_sitter_abap.language()))
+
+    def loop():
+        for source in sources:
+            parser.parse(source).root_node.descendant_count
+
+    def batch(**kwargs):
+        return lambda: tree_sitter_abap.parse_batch(
+            sources, threads=options.threads, **kwargs
+        )
+
+    total = sum(len(source) for source in sources)
+    results = {
+        "sources": len(sources),
+        "bytes": total,
+        "parser_loop_ns": best_of(options.repeat, loop),
+        "parse_batch_ns": best_of(options.repeat, batch()),
+        "parse_batch_counts_only_ns": best_of(
+            options.repeat, batch(nodes=False)
+        ),
+    }
+    for key in ("parse_batch_ns", "parse_batch_counts_only_ns"):
+        name = key.replace("_ns", "_speedup")
+        results[name] = round(results["parser_loop_ns"] / results[key], 3)
+    json.dump(results, sys.stdout, indent=2)
+    print()
+
+
+if __name__ == "__main__":
+    main()
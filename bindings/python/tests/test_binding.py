@@ -1,7 +1,26 @@
-from unittest import TestCase
+import struct
+from os import unlink
+from tempfile import NamedTemporaryFile
+from unittest import TestCase, skipIf
 
 from tree_sitter import Language, Parser
 import tree_sitter_abap
+from tree_sitter_abap import cst
+
+
+def _has_parse_batch():
+    try:
+        tree_sitter_abap.parse_batch([])
+    except NotImplementedError:
+        return False
+    return True
+
+
+SOURCES = [
+    b"REPORT ztest.\nDATA lv_count TYPE i.\nlv_count = lv_count + 1.\n",
+    b"CLASS lcl DEFINITION.\n  PUBLIC SECTION.\n    METHODS run.\nENDCLASS.\n",
+    b"DATA lv_text TYPE string\nWRITE lv_text.\n",
+]
 
 
 class TestLanguage(TestCase):
@@ -10,3 +29,121 @@ class TestLanguage(TestCase):
             Parser(Language(tree_sitter_abap.language()))
         except Exception:
             self.fail("Error loading Abap grammar")
+
+
+@skipIf(not _has_parse_batch(), "built without the tree-sitter runtime")
+class TestParseBatch(TestCase):
+    def setUp(self):
+        self.language = Language(tree_sitter_abap.language())
+        self.parser = Parser(self.language)
+
+    def test_matches_parser(self):
+        results = tree_sitter_abap.parse_batch(SOURCES, threads=2)
+        self.assertEqual(len(results), len(SOURCES))
+        for source, result in zip(SOURCES, results):
+            root = self.parser.parse(source).root_node
+            self.assertEqual(result["node_count"], root.descendant_count)
+            self.assertEqual(result["errors"] + result["missing"] > 0,
+                             root.has_error)
+            self.assertEqual(result["bytes"], len(source))
+
+    def test_node_table(self):
+        result = tree_sitter_abap.parse_batch(SOURCES[:1])[0]
+        rows = list(struct.iter_unpack(tree_sitter_abap.NODE_FORMAT,
+                                       result["nodes"]))
+        self.assertEqual(len(rows), result["node_count"])
+
+        parent, start, end, row, column, symbol, flags = rows[0]
+        self.assertEqual(parent, 0xFFFFFFFF)
+        self.assertEqual((start, end), (0, len(SOURCES[0])))
+        self.assertEqual(self.language.node_kind_for_id(symbol), "source")
+        for index, (parent, *_) in enumerate(rows[1:], 1):
+            self.assertLess(parent, index)
+
+    def test_named_only(self):
+        result = tree_sitter_abap.parse_batch(SOURCES, named_only=True)[1]
+        rows = struct.iter_unpack(tree_sitter_abap.NODE_FORMAT,
+                                  result["nodes"])
+        for *_, flags in rows:
+            self.assertTrue(flags & tree_sitter_abap.NODE_NAMED)
+
+    def test_without_nodes(self):
+        results = tree_sitter_abap.parse_batch(SOURCES, nodes=False)
+        full = tree_sitter_abap.parse_batch(SOURCES)
+        for result, expected in zip(results, full):
+            self.assertIsNone(result["nodes"])
+            self.assertEqual(result["errors"], expected["errors"])
+            self.assertEqual(result["missing"], expected["missing"])
+
+    def test_paths(self):
+        with NamedTemporaryFile(suffix=".abap", delete=False) as file:
+            file.write(SOURCES[0])
+        try:
+            from_path, from_bytes = tree_sitter_abap.parse_batch(
+                [file.name, SOURCES[0]]
+            )
+        finally:
+            unlink(file.name)
+        self.assertEqual(from_path["nodes"], from_bytes["nodes"])
+
+    def test_unreadable_path(self):
+        with self.assertRaises(OSError):
+            tree_sitter_abap.parse_batch(["does/not/exist.abap"])
+
+    def test_rejects_other_inputs(self):
+        with self.assertRaises(TypeError):
+            tree_sitter_abap.parse_batch([42])
+
+
+class TestCst(TestCase):
+    def setUp(self):
+        self.language = Language(tree_sitter_abap.language())
+        self.parser = Parser(self.language)
+
+    def test_round_trip(self):
+        source = SOURCES[1]
+        tree = self.parser.parse(source)
+        with cst.Cst(cst.dumps(tree, source)) as loaded:
+            nodes = list(self._preorder(tree.root_node))
+            self.assertEqual(loaded.node_count, len(nodes))
+            for index, node in enumerate(nodes):
+                self.assertEqual(loaded.symbol[index], node.kind_id)
+                self.assertEqual(loaded.start_byte[index], node.start_byte)
+                self.assertEqual(loaded.end_byte[index], node.end_byte)
+                self.assertEqual(loaded.text(index), node.text)
+            self.assertEqual(loaded.parent[0], cst.NONE)
+
+            kind = self.language.id_for_node_kind("class_declaration", True)
+            found = list(loaded.descendants_of_symbol(0, kind))
+            self.assertEqual(
+                found, [i for i, n in enumerate(nodes) if n.kind_id == kind]
+            )
+
+    def test_open_file(self):
+        tree = self.parser.parse(SOURCES[0])
+        with NamedTemporaryFile(suffix=".cst", delete=False) as file:
+            file.write(cst.dumps(tree))
+        try:
+            with cst.Cst.open(file.name) as loaded:
+                self.assertIsNone(loaded.source)
+                node = loaded.descendant_for_byte_range(0, 6)
+                self.assertEqual(loaded.start_byte[node], 0)
+        finally:
+            unlink(file.name)
+
+    def test_rejects_stale_and_foreign_files(self):
+        data = bytearray(cst.dumps(self.parser.parse(SOURCES[0])))
+        stale = bytearray(data)
+        stale[16] ^= 1
+        with self.assertRaises(cst.StaleCstError):
+            cst.Cst(stale)
+        with self.assertRaises(cst.CstError):
+            cst.Cst(b"not a cst file" * 8)
+        with self.assertRaises(cst.CstError):
+            cst.Cst(data[:-1])
+
+    @staticmethod
+    def _preorder(node):
+        yield node
+        for child in node.children:
+            yield from TestCst._preorder(child)
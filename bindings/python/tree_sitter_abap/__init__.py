@@ -4,6 +4,24 @@ from importlib.resources import files as _files
 
 from ._binding import language
 
+try:
+    from ._binding import parse_batch
+except ImportError:
+    def parse_batch(inputs, *, threads=0, nodes=True, named_only=False):
+        raise NotImplementedError(
+            "tree_sitter_abap was built without the tree-sitter runtime, "
+            "see setup.py"
+        )
+
+# One row of the node table returned by parse_batch, for struct.iter_unpack:
+# parent index (0xFFFFFFFF for the root), start byte, end byte, start row,
+# start column, symbol and the NODE_* flags.
+NODE_FORMAT = "=IIIIIHH"
+NODE_NAMED = 1
+NODE_ERROR = 2
+NODE_MISSING = 4
+NODE_EXTRA = 8
+
 
 def _get_query(name, file):
     query = _files(f"{__package__}.queries") / file
@@ -28,6 +46,12 @@ def __getattr__(name):
 
 __all__ = [
     "language",
+    "parse_batch",
+    "NODE_FORMAT",
+    "NODE_NAMED",
+    "NODE_ERROR",
+    "NODE_MISSING",
+    "NODE_EXTRA",
     # "HIGHLIGHTS_QUERY",
     # "INJECTIONS_QUERY",
     # "LOCALS_QUERY",
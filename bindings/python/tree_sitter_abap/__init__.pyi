@@ -1,4 +1,5 @@
-from typing import Final
+from os import PathLike
+from typing import Final, Sequence, TypedDict
 
 # NOTE: uncomment these to include any queries that this grammar contains:
 
@@ -8,3 +9,32 @@ from typing import Final
 # TAGS_QUERY: Final[str]
 
 def language() -> object: ...
+
+class BatchResult(TypedDict):
+    nodes: bytes | None
+    node_count: int
+    errors: int
+    missing: int
+    bytes: int
+    parse_ns: int
+
+NODE_FORMAT: Final[str]
+NODE_NAMED: Final[int]
+NODE_ERROR: Final[int]
+NODE_MISSING: Final[int]
+NODE_EXTRA: Final[int]
+
+def parse_batch(
+    inputs: Sequence[bytes | str | PathLike[str]],
+    *,
+    threads: int = 0,
+    nodes: bool = True,
+    named_only: bool = False,
+) -> list[BatchResult]:
+    """Parse sources (bytes) and files (paths) on native threads.
+
+    The GIL is released while reading and parsing. Each result holds the
+    node table in pre-order, packed as NODE_FORMAT (None with nodes=False),
+    and the ERROR and MISSING node counts. Raises OSError for an unreadable
+    file and NotImplementedError if built without the tree-sitter runtime.
+    """
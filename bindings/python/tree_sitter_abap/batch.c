@@ -0,0 +1,390 @@
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+/**
+ * `parse_batch`, parsing many sources on native threads.
+ *
+ * The inputs are turned into plain buffers and paths while holding the GIL,
+ * then the GIL is released for reading, parsing and flattening the trees on
+ * a pool of threads with one parser each. Only building the result objects
+ * needs it again. Nothing in between touches a Python object, so the same
+ * holds for free-threaded builds.
+ *
+ * Built only when the tree-sitter runtime is available, see setup.py.
+ */
+
+TSLanguage* tree_sitter_abap(void);
+
+enum
+{
+    NODE_NAMED = 1,
+    NODE_ERROR = 2,
+    NODE_MISSING = 4,
+    NODE_EXTRA = 8,
+};
+
+/** One row of the node table, `NODE_FORMAT` in __init__.py. */
+typedef struct
+{
+    uint32_t parent;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    uint32_t start_row;
+    uint32_t start_column;
+    uint16_t symbol;
+    uint16_t flags;
+} BatchNode;
+
+typedef struct
+{
+    /** The bytes object of the source or of the encoded path. */
+    PyObject* owner;
+    const char* data;
+    uint32_t length;
+    const char* path;
+
+    BatchNode* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+    uint32_t errors;
+    uint32_t missing;
+    uint64_t parse_ns;
+    int read_errno;
+} BatchItem;
+
+typedef struct
+{
+    BatchItem* items;
+    uint32_t count;
+    bool nodes;
+    bool named_only;
+    pthread_mutex_t lock;
+    uint32_t next;
+} Batch;
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static char* read_file(const char* path, uint32_t* length, int* error)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        *error = errno;
+        return NULL;
+    }
+    char* data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 &&
+        size < UINT32_MAX && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)size + 1);
+        if (data && fread(data, 1, (size_t)size, file) != (size_t)size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    *error = data ? 0 : (errno ? errno : EIO);
+    fclose(file);
+    *length = data ? (uint32_t)size : 0;
+    return data;
+}
+
+static void push_node(BatchItem* item, TSNode node, uint32_t parent)
+{
+    if (item->node_count == item->node_capacity) {
+        item->node_capacity = item->node_capacity ? item->node_capacity * 2
+                                                  : 256;
+        item->nodes = realloc(item->nodes,
+                              item->node_capacity * sizeof(BatchNode));
+    }
+    TSPoint start = ts_node_start_point(node);
+    item->nodes[item->node_count++] = (BatchNode){
+            .parent = parent,
+            .start_byte = ts_node_start_byte(node),
+            .end_byte = ts_node_end_byte(node),
+            .start_row = start.row,
+            .start_column = start.column,
+            .symbol = ts_node_symbol(node),
+            .flags = (ts_node_is_named(node) ? NODE_NAMED : 0) |
+                     (ts_node_is_error(node) ? NODE_ERROR : 0) |
+                     (ts_node_is_missing(node) ? NODE_MISSING : 0) |
+                     (ts_node_is_extra(node) ? NODE_EXTRA : 0),
+    };
+}
+
+/**
+ * Counts ERROR and MISSING nodes and, if wanted, records the nodes in
+ * pre-order, each with the index of its closest recorded ancestor.
+ */
+static void flatten(const Batch* batch, BatchItem* item, const TSTree* tree)
+{
+    TSNode root = ts_tree_root_node(tree);
+    if (!batch->nodes && !ts_node_has_error(root)) {
+        return;
+    }
+
+    // Index in the table of the node at each depth of the cursor,
+    // UINT32_MAX where the node was left out.
+    uint32_t* indices = malloc(16 * sizeof(uint32_t));
+    uint32_t capacity = 16;
+    uint32_t depth = 0;
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        item->errors += ts_node_is_error(node);
+        item->missing += ts_node_is_missing(node);
+
+        if (depth == capacity) {
+            capacity *= 2;
+            indices = realloc(indices, capacity * sizeof(uint32_t));
+        }
+        indices[depth] = UINT32_MAX;
+        if (batch->nodes && (!batch->named_only || ts_node_is_named(node))) {
+            uint32_t parent = UINT32_MAX;
+            for (uint32_t i = depth; i-- > 0;) {
+                if (indices[i] != UINT32_MAX) {
+                    parent = indices[i];
+                    break;
+                }
+            }
+            indices[depth] = item->node_count;
+            push_node(item, node, parent);
+        }
+
+        // Without a node table only the subtrees containing errors matter.
+        bool descend = batch->nodes || ts_node_has_error(node);
+        if (descend && ts_tree_cursor_goto_first_child(&cursor)) {
+            depth++;
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                free(indices);
+                return;
+            }
+            depth--;
+        }
+    }
+}
+
+static void* run_worker(void* payload)
+{
+    Batch* batch = payload;
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+
+    for (;;) {
+        pthread_mutex_lock(&batch->lock);
+        uint32_t index = batch->next++;
+        pthread_mutex_unlock(&batch->lock);
+        if (index >= batch->count) {
+            break;
+        }
+
+        BatchItem* item = &batch->items[index];
+        char* contents = NULL;
+        if (item->path) {
+            contents = read_file(item->path, &item->length, &item->read_errno);
+            if (!contents) {
+                continue;
+            }
+            item->data = contents;
+        }
+
+        uint64_t start = now_ns();
+        TSTree* tree = ts_parser_parse_string(parser, NULL, item->data,
+                                              item->length);
+        item->parse_ns = now_ns() - start;
+        flatten(batch, item, tree);
+        ts_tree_delete(tree);
+        free(contents);
+    }
+
+    ts_parser_delete(parser);
+    return NULL;
+}
+
+static void run_batch(Batch* batch, uint32_t threads)
+{
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (threads > batch->count) {
+        threads = batch->count;
+    }
+
+    pthread_mutex_init(&batch->lock, NULL);
+    pthread_t* workers = calloc(threads, sizeof(pthread_t));
+    uint32_t started = 0;
+    for (uint32_t i = 1; i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, run_worker, batch) == 0) {
+            started++;
+        }
+    }
+    // The calling thread is one of the workers.
+    run_worker(batch);
+    for (uint32_t i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    pthread_mutex_destroy(&batch->lock);
+}
+
+static bool prepare_item(BatchItem* item, PyObject* input)
+{
+    if (PyBytes_Check(input)) {
+        char* data;
+        Py_ssize_t length;
+        if (PyBytes_AsStringAndSize(input, &data, &length) < 0) {
+            return false;
+        }
+        if ((size_t)length >= UINT32_MAX) {
+            PyErr_SetString(PyExc_ValueError, "source is 4 GiB or larger");
+            return false;
+        }
+        Py_INCREF(input);
+        item->owner = input;
+        item->data = data;
+        item->length = (uint32_t)length;
+        return true;
+    }
+
+    PyObject* path = NULL;
+    if (!PyUnicode_FSConverter(input, &path)) {
+        PyErr_Format(PyExc_TypeError,
+                     "inputs must be bytes sources or paths, not %R",
+                     (PyObject*)Py_TYPE(input));
+        return false;
+    }
+    item->owner = path;
+    item->path = PyBytes_AsString(path);
+    return item->path != NULL;
+}
+
+static PyObject* build_result(const BatchItem* item, bool nodes)
+{
+    PyObject* result = PyDict_New();
+    if (!result) {
+        return NULL;
+    }
+
+    PyObject* table;
+    if (nodes) {
+        Py_ssize_t size = (Py_ssize_t)item->node_count * sizeof(BatchNode);
+        table = PyBytes_FromStringAndSize((const char*)item->nodes, size);
+    } else {
+        table = Py_None;
+        Py_INCREF(table);
+    }
+
+    struct
+    {
+        const char* key;
+        PyObject* value;
+    } fields[] = {
+            {"nodes", table},
+            {"node_count", PyLong_FromUnsignedLong(item->node_count)},
+            {"errors", PyLong_FromUnsignedLong(item->errors)},
+            {"missing", PyLong_FromUnsignedLong(item->missing)},
+            {"bytes", PyLong_FromUnsignedLong(item->length)},
+            {"parse_ns", PyLong_FromUnsignedLongLong(item->parse_ns)},
+    };
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        ok = ok && fields[i].value &&
+             PyDict_SetItemString(result, fields[i].key, fields[i].value) == 0;
+        Py_XDECREF(fields[i].value);
+    }
+    if (!ok) {
+        Py_DECREF(result);
+        return NULL;
+    }
+    return result;
+}
+
+PyObject* _binding_parse_batch(PyObject* Py_UNUSED(self), PyObject* args,
+                               PyObject* kwargs)
+{
+    static char* keywords[] = {"inputs", "threads", "nodes", "named_only",
+                               NULL};
+    PyObject* inputs;
+    unsigned int threads = 0;
+    int nodes = 1;
+    int named_only = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$Ipp", keywords,
+                                     &inputs, &threads, &nodes,
+                                     &named_only)) {
+        return NULL;
+    }
+
+    Py_ssize_t count = PySequence_Size(inputs);
+    if (count < 0) {
+        return NULL;
+    }
+    if ((size_t)count >= UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many inputs");
+        return NULL;
+    }
+
+    Batch batch = {
+            .items = calloc((size_t)count + 1, sizeof(BatchItem)),
+            .nodes = nodes,
+            .named_only = named_only,
+    };
+    PyObject* results = NULL;
+    bool ok = batch.items != NULL;
+    if (!ok) {
+        PyErr_NoMemory();
+    }
+    for (Py_ssize_t i = 0; ok && i < count; i++) {
+        PyObject* input = PySequence_GetItem(inputs, i);
+        ok = input && prepare_item(&batch.items[i], input);
+        Py_XDECREF(input);
+        batch.count += ok;
+    }
+
+    if (ok) {
+        Py_BEGIN_ALLOW_THREADS
+        run_batch(&batch, threads);
+        Py_END_ALLOW_THREADS
+
+        for (uint32_t i = 0; ok && i < batch.count; i++) {
+            const BatchItem* item = &batch.items[i];
+            if (item->read_errno) {
+                errno = item->read_errno;
+                PyErr_SetFromErrnoWithFilename(PyExc_OSError, item->path);
+                ok = false;
+            }
+        }
+        results = ok ? PyList_New(count) : NULL;
+        for (uint32_t i = 0; results && i < batch.count; i++) {
+            PyObject* result = build_result(&batch.items[i], nodes);
+            if (!result) {
+                Py_CLEAR(results);
+                break;
+            }
+            PyList_SetItem(results, i, result);
+        }
+    }
+
+    for (uint32_t i = 0; i < batch.count; i++) {
+        Py_XDECREF(batch.items[i].owner);
+        free(batch.items[i].nodes);
+    }
+    free(batch.items);
+    return results;
+}
@@ -4,6 +4,10 @@ typedef struct TSLanguage TSLanguage;
 
 TSLanguage *tree_sitter_abap(void);
 
+#ifdef TREE_SITTER_ABAP_BATCH
+PyObject* _binding_parse_batch(PyObject *self, PyObject *args, PyObject *kwargs);
+#endif
+
 static PyObject* _binding_language(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(args)) {
     return PyCapsule_New(tree_sitter_abap(), "tree_sitter.Language", NULL);
 }
@@ -18,6 +22,11 @@ static struct PyModuleDef_Slot slots[] = {
 static PyMethodDef methods[] = {
     {"language", _binding_language, METH_NOARGS,
      "Get the tree-sitter language for this grammar."},
+#ifdef TREE_SITTER_ABAP_BATCH
+    {"parse_batch", (PyCFunction)(void (*)(void))_binding_parse_batch,
+     METH_VARARGS | METH_KEYWORDS,
+     "Parse many sources or files on native threads without the GIL."},
+#endif
     {NULL, NULL, 0, NULL}
 };
 
@@ -0,0 +1,293 @@
+"""The CST format, a flat binary form of parse results.
+
+See bindings/c/tree_sitter/tree-sitter-abap-cst.h for the layout. `dumps`
+and `write` serialize a py-tree-sitter tree, `Cst` reads a file in place:
+the columns are memoryviews into the buffer or the memory mapped file, no
+node is copied or created until asked for.
+"""
+
+import mmap
+import struct
+import sys
+from array import array
+from functools import lru_cache
+
+VERSION = 1
+NONE = 0xFFFFFFFF
+MAGIC = b"ABAPCST\0"
+
+NAMED = 1
+ERROR = 2
+MISSING = 4
+EXTRA = 8
+HAS_ERROR = 16
+
+_HEADER = struct.Struct("<8sIIQIIIIQ16x")
+_FLAG_SOURCE = 1
+_COLUMNS = (
+    ("symbol", "H"),
+    ("field", "H"),
+    ("flags", "H"),
+    ("start_byte", "I"),
+    ("end_byte", "I"),
+    ("start_row", "I"),
+    ("start_column", "I"),
+    ("end_row", "I"),
+    ("end_column", "I"),
+    ("parent", "I"),
+    ("first_child", "I"),
+    ("next_sibling", "I"),
+)
+
+
+class CstError(ValueError):
+    """Not a CST file, or written in another version of the format."""
+
+
+class StaleCstError(CstError):
+    """Written with another grammar, the symbol and field ids differ."""
+
+
+def _align8(offset):
+    return (offset + 7) & ~7
+
+
+def _layout(node_count, source_length, embed_source):
+    offsets = []
+    offset = _HEADER.size
+    for _, code in _COLUMNS:
+        offsets.append(offset)
+        offset = _align8(offset + struct.calcsize(code) * node_count)
+    source = offset if embed_source else 0
+    return offsets, source, offset + (source_length if embed_source else 0)
+
+
+def grammar_hash(language):
+    """The hash of the symbol and field tables of a py-tree-sitter Language,
+    the same as tree_sitter_abap_cst_grammar_hash in C."""
+    data = bytearray()
+    for symbol in range(language.node_kind_count):
+        name = language.node_kind_for_id(symbol) or ""
+        flags = (language.node_kind_is_named(symbol)
+                 | language.node_kind_is_visible(symbol) << 1)
+        data += name.encode() + b"\0" + bytes((flags,))
+    data += b"\xff"
+    for field in range(1, language.field_count + 1):
+        data += (language.field_name_for_id(field) or "").encode() + b"\0"
+
+    value = 0xCBF29CE484222325
+    for byte in data:
+        value = ((value ^ byte) * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+@lru_cache(maxsize=None)
+def _abap_grammar_hash():
+    from tree_sitter import Language
+
+    from . import language
+
+    return grammar_hash(Language(language()))
+
+
+def dumps(tree, source=None):
+    """Serialize a py-tree-sitter tree, embedding the source bytes if
+    given."""
+    root = tree.root_node
+    node_count = root.descendant_count
+    columns = {name: array(code, bytes(struct.calcsize(code) * node_count))
+               for name, code in _COLUMNS}
+    symbol, field = columns["symbol"], columns["field"]
+    flags = columns["flags"]
+    start_byte, end_byte = columns["start_byte"], columns["end_byte"]
+    start_row, start_column = columns["start_row"], columns["start_column"]
+    end_row, end_column = columns["end_row"], columns["end_column"]
+    parent, first_child = columns["parent"], columns["first_child"]
+    next_sibling = columns["next_sibling"]
+
+    # The node at each depth of the cursor and its last child so far.
+    path = []
+    cursor = tree.walk()
+    index = 0
+    done = False
+    while not done:
+        node = cursor.node
+        up = path[-1] if path else None
+        symbol[index] = node.kind_id
+        field[index] = cursor.field_id or 0
+        flags[index] = (NAMED * node.is_named | ERROR * node.is_error
+                        | MISSING * node.is_missing | EXTRA * node.is_extra
+                        | HAS_ERROR * node.has_error)
+        start_byte[index], end_byte[index] = node.start_byte, node.end_byte
+        start_row[index], start_column[index] = node.start_point
+        end_row[index], end_column[index] = node.end_point
+        parent[index] = up[0] if up else NONE
+        first_child[index] = next_sibling[index] = NONE
+        if up and up[1] != NONE:
+            next_sibling[up[1]] = index
+        elif up:
+            first_child[up[0]] = index
+        if up:
+            up[1] = index
+
+        if cursor.goto_first_child():
+            path.append([index, NONE])
+        else:
+            while not cursor.goto_next_sibling():
+                if not cursor.goto_parent():
+                    done = True
+                    break
+                path.pop()
+        index += 1
+
+    source_length = len(source) if source is not None else 0
+    offsets, source_offset, size = _layout(node_count, source_length,
+                                           source is not None)
+    header = _HEADER.pack(MAGIC, VERSION, _HEADER.size,
+                          grammar_hash(tree.language), node_count,
+                          source_length,
+                          _FLAG_SOURCE if source is not None else 0, 0, size)
+    out = bytearray(size)
+    out[:len(header)] = header
+    for (name, _), offset in zip(_COLUMNS, offsets):
+        data = columns[name].tobytes()
+        out[offset:offset + len(data)] = data
+    if source is not None:
+        out[source_offset:] = source
+    return bytes(out)
+
+
+def write(path, tree, source=None):
+    """Write a py-tree-sitter tree to a file, see `dumps`."""
+    with open(path, "wb") as file:
+        file.write(dumps(tree, source))
+
+
+class Cst:
+    """A CST file read in place from `bytes`, a `bytearray` or an `mmap`.
+
+    Each column is a memoryview with one entry per node, e.g.
+    `cst.symbol[i]`. Nodes are in pre-order with the root at 0, missing
+    links are NONE. Raises CstError for anything but a valid file written
+    with this grammar, or with `language` if given.
+    """
+
+    def __init__(self, buffer, language=None):
+        if sys.byteorder != "little":
+            raise CstError("the CST format is read on little-endian hosts")
+        self._buffer = buffer
+        self._mmap = None
+        if len(buffer) < _HEADER.size:
+            raise CstError("truncated header")
+        (magic, version, header_size, hash_, node_count, source_length,
+         flags, _, file_size) = _HEADER.unpack_from(buffer)
+        if magic != MAGIC:
+            raise CstError("not a CST file")
+        if version != VERSION:
+            raise CstError(f"format version {version}, expected {VERSION}")
+        expected = (grammar_hash(language) if language is not None
+                    else _abap_grammar_hash())
+        if hash_ != expected:
+            raise StaleCstError("written with another grammar")
+        embed = bool(flags & _FLAG_SOURCE)
+        offsets, source_offset, size = _layout(node_count, source_length,
+                                               embed)
+        if (header_size != _HEADER.size or node_count == 0
+                or file_size != len(buffer) or size != len(buffer)):
+            raise CstError("inconsistent header")
+
+        self.node_count = node_count
+        self._view = memoryview(buffer)
+        self._views = []
+        for (name, code), offset in zip(_COLUMNS, offsets):
+            width = struct.calcsize(code)
+            view = self._view[offset:offset + width * node_count].cast(code)
+            self._views.append(view)
+            setattr(self, name, view)
+        self.source = (self._view[source_offset:size] if embed else None)
+        self._symbol_offset = offsets[0]
+
+    @classmethod
+    def open(cls, path, language=None):
+        """Map the file into memory and read it in place."""
+        with open(path, "rb") as file:
+            mapping = mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ)
+        try:
+            cst = cls(mapping, language)
+        except BaseException:
+            mapping.close()
+            raise
+        cst._mmap = mapping
+        return cst
+
+    def close(self):
+        """Release the columns and unmap the file, if mapped."""
+        for view in self._views:
+            view.release()
+        if self.source is not None:
+            self.source.release()
+        self._view.release()
+        if self._mmap is not None:
+            self._mmap.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        self.close()
+
+    def text(self, node):
+        """The source bytes of the node, if the source is embedded."""
+        if self.source is None:
+            raise CstError("the source is not embedded")
+        return bytes(self.source[self.start_byte[node]:self.end_byte[node]])
+
+    def children(self, node):
+        child = self.first_child[node]
+        while child != NONE:
+            yield child
+            child = self.next_sibling[child]
+
+    def subtree_end(self, node):
+        """The node after the last descendant of `node`."""
+        while node != NONE:
+            if self.next_sibling[node] != NONE:
+                return self.next_sibling[node]
+            node = self.parent[node]
+        return self.node_count
+
+    def find_symbol(self, symbol, start=0, end=None):
+        """The first node of the symbol in [start, end), or NONE. Searches
+        the symbol column of the buffer without unpacking it."""
+        end = self.node_count if end is None else min(end, self.node_count)
+        needle = struct.pack("<H", symbol)
+        base = self._symbol_offset
+        position = base + 2 * start
+        while True:
+            position = self._buffer.find(needle, position, base + 2 * end)
+            if position < 0:
+                return NONE
+            if (position - base) % 2 == 0:
+                return (position - base) // 2
+            position += 1
+
+    def descendants_of_symbol(self, node, symbol):
+        """The nodes of the symbol in the subtree of `node`."""
+        end = self.subtree_end(node)
+        found = self.find_symbol(symbol, node, end)
+        while found != NONE:
+            yield found
+            found = self.find_symbol(symbol, found + 1, end)
+
+    def descendant_for_byte_range(self, start, end):
+        """The smallest node spanning the byte range."""
+        node = 0
+        while True:
+            for child in self.children(node):
+                if (self.start_byte[child] <= start
+                        and end <= self.end_byte[child]
+                        and self.end_byte[child] > self.start_byte[child]):
+                    node = child
+                    break
+            else:
+                return node
@@ -0,0 +1,436 @@
+//! The CST format, a flat binary form of parse results.
+//!
+//! See `bindings/c/tree_sitter/tree-sitter-abap-cst.h` for the layout.
+//! [`serialize`] writes a [`Tree`], [`Cst`] reads the result in place from a
+//! byte slice, e.g. a memory mapped file, without copying any column:
+//!
+//! ```
+//! let code = b"REPORT zdemo.\nWRITE 'Hello'.\n";
+//! let mut parser = tree_sitter::Parser::new();
+//! parser.set_language(&tree_sitter_abap::LANGUAGE.into()).unwrap();
+//! let tree = parser.parse(code, None).unwrap();
+//!
+//! let bytes = tree_sitter_abap::cst::serialize(&tree, Some(code));
+//! let cst = tree_sitter_abap::cst::Cst::new(&bytes).unwrap();
+//! assert_eq!(cst.node_count(), tree.root_node().descendant_count());
+//! assert_eq!(cst.text(0), Some(&code[..]));
+//! ```
+//!
+//! Only little-endian targets are supported, like the C reader.
+
+use std::fmt;
+
+use tree_sitter::{Language, Tree};
+
+/// The version of the format read and written here.
+pub const VERSION: u32 = 1;
+/// A missing parent, child or sibling.
+pub const NONE: u32 = u32::MAX;
+
+/// Bits of the flags column.
+pub const NAMED: u16 = 1;
+pub const ERROR: u16 = 2;
+pub const MISSING: u16 = 4;
+pub const EXTRA: u16 = 8;
+pub const HAS_ERROR: u16 = 16;
+
+const MAGIC: &[u8; 8] = b"ABAPCST\0";
+const HEADER_SIZE: usize = 64;
+const FLAG_SOURCE: u32 = 1;
+const NARROW_COLUMNS: usize = 3;
+const COLUMNS: usize = 12;
+
+/// Why a buffer cannot be read as a CST file.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum Error {
+    /// Not a CST file, or truncated or inconsistent.
+    BadFormat(&'static str),
+    /// Written in another version of the format.
+    BadVersion(u32),
+    /// Written with another grammar, the symbol and field ids differ.
+    Stale,
+}
+
+impl fmt::Display for Error {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::BadFormat(reason) => write!(f, "not a valid CST file: {reason}"),
+            Self::BadVersion(version) => {
+                write!(f, "CST format version {version}, expected {VERSION}")
+            }
+            Self::Stale => write!(f, "CST file written with another grammar"),
+        }
+    }
+}
+
+impl std::error::Error for Error {}
+
+struct Layout {
+    columns: [usize; COLUMNS],
+    source: Option<usize>,
+    size: usize,
+}
+
+fn layout(node_count: usize, source_length: usize, embed_source: bool) -> Layout {
+    let mut columns = [0; COLUMNS];
+    let mut offset = HEADER_SIZE;
+    for (column, start) in columns.iter_mut().enumerate() {
+        let width = if column < NARROW_COLUMNS { 2 } else { 4 };
+        *start = offset;
+        offset = (offset + width * node_count + 7) & !7;
+    }
+    Layout {
+        columns,
+        source: embed_source.then_some(offset),
+        size: offset + if embed_source { source_length } else { 0 },
+    }
+}
+
+/// A hash of the symbol and field tables of the language, the same as
+/// `tree_sitter_abap_cst_grammar_hash` in C.
+pub fn grammar_hash(language: &Language) -> u64 {
+    fn fnv1a(mut hash: u64, bytes: &[u8]) -> u64 {
+        for &byte in bytes {
+            hash = (hash ^ u64::from(byte)).wrapping_mul(0x100000001b3);
+        }
+        hash
+    }
+
+    let mut hash = 0xcbf29ce484222325;
+    for symbol in 0..language.node_kind_count() as u16 {
+        let name = language.node_kind_for_id(symbol).unwrap_or("");
+        let flags = u8::from(language.node_kind_is_named(symbol))
+            | u8::from(language.node_kind_is_visible(symbol)) << 1;
+        hash = fnv1a(hash, name.as_bytes());
+        hash = fnv1a(hash, &[0, flags]);
+    }
+    hash = fnv1a(hash, &[0xff]);
+    for field in 1..=language.field_count() as u16 {
+        let name = language.field_name_for_id(field).unwrap_or("");
+        hash = fnv1a(hash, name.as_bytes());
+        hash = fnv1a(hash, &[0]);
+    }
+    hash
+}
+
+/// Serializes the tree, embedding the source if given.
+pub fn serialize(tree: &Tree, source: Option<&[u8]>) -> Vec<u8> {
+    let node_count = tree.root_node().descendant_count();
+    let source_length = source.map_or(0, <[u8]>::len);
+    let layout = layout(node_count, source_length, source.is_some());
+
+    let mut narrow = vec![vec![0u16; node_count]; NARROW_COLUMNS];
+    let mut wide = vec![vec![0u32; node_count]; COLUMNS - NARROW_COLUMNS];
+    // The node at each depth of the cursor and its last child so far.
+    let mut path: Vec<(u32, u32)> = Vec::new();
+    let mut cursor = tree.walk();
+    let mut index = 0u32;
+    loop {
+        let node = cursor.node();
+        let i = index as usize;
+        let (start, end) = (node.start_position(), node.end_position());
+        narrow[0][i] = node.kind_id();
+        narrow[1][i] = cursor.field_id().map_or(0, |field| field.get());
+        narrow[2][i] = if node.is_named() { NAMED } else { 0 }
+            | if node.is_error() { ERROR } else { 0 }
+            | if node.is_missing() { MISSING } else { 0 }
+            | if node.is_extra() { EXTRA } else { 0 }
+            | if node.has_error() { HAS_ERROR } else { 0 };
+        let row = [
+            node.start_byte() as u32,
+            node.end_byte() as u32,
+            start.row as u32,
+            start.column as u32,
+            end.row as u32,
+            end.column as u32,
+            path.last().map_or(NONE, |&(parent, _)| parent),
+            NONE,
+            NONE,
+        ];
+        for (column, value) in wide.iter_mut().zip(row) {
+            column[i] = value;
+        }
+        if let Some((parent, last)) = path.last_mut() {
+            if *last == NONE {
+                wide[7][*parent as usize] = index;
+            } else {
+                wide[8][*last as usize] = index;
+            }
+            *last = index;
+        }
+
+        index += 1;
+        if cursor.goto_first_child() {
+            path.push((index - 1, NONE));
+            continue;
+        }
+        while !cursor.goto_next_sibling() {
+            if !cursor.goto_parent() {
+                return assemble(tree, source, &layout, node_count, &narrow, &wide);
+            }
+            path.pop();
+        }
+    }
+}
+
+fn assemble(
+    tree: &Tree,
+    source: Option<&[u8]>,
+    layout: &Layout,
+    node_count: usize,
+    narrow: &[Vec<u16>],
+    wide: &[Vec<u32>],
+) -> Vec<u8> {
+    let mut out = vec![0u8; layout.size];
+    out[..8].copy_from_slice(MAGIC);
+    out[8..12].copy_from_slice(&VERSION.to_le_bytes());
+    out[12..16].copy_from_slice(&(HEADER_SIZE as u32).to_le_bytes());
+    out[16..24].copy_from_slice(&grammar_hash(&tree.language()).to_le_bytes());
+    out[24..28].copy_from_slice(&(node_count as u32).to_le_bytes());
+    let source_length = source.map_or(0, <[u8]>::len) as u32;
+    out[28..32].copy_from_slice(&source_length.to_le_bytes());
+    let flags = if source.is_some() { FLAG_SOURCE } else { 0 };
+    out[32..36].copy_from_slice(&flags.to_le_bytes());
+    out[40..48].copy_from_slice(&(layout.size as u64).to_le_bytes());
+
+    for (column, values) in narrow.iter().enumerate() {
+        let start = layout.columns[column];
+        for (chunk, value) in out[start..].chunks_exact_mut(2).zip(values) {
+            chunk.copy_from_slice(&value.to_le_bytes());
+        }
+    }
+    for (column, values) in wide.iter().enumerate() {
+        let start = layout.columns[NARROW_COLUMNS + column];
+        for (chunk, value) in out[start..].chunks_exact_mut(4).zip(values) {
+            chunk.copy_from_slice(&value.to_le_bytes());
+        }
+    }
+    if let (Some(offset), Some(source)) = (layout.source, source) {
+        out[offset..].copy_from_slice(source);
+    }
+    out
+}
+
+/// A CST file read in place. Each column has one entry per node, nodes are
+/// in pre-order with the root at 0, missing links are [`NONE`].
+#[derive(Debug, Clone, Copy)]
+pub struct Cst<'a> {
+    pub symbol: &'a [u16],
+    pub field: &'a [u16],
+    pub flags: &'a [u16],
+    pub start_byte: &'a [u32],
+    pub end_byte: &'a [u32],
+    pub start_row: &'a [u32],
+    pub start_column: &'a [u32],
+    pub end_row: &'a [u32],
+    pub end_column: &'a [u32],
+    pub parent: &'a [u32],
+    pub first_child: &'a [u32],
+    pub next_sibling: &'a [u32],
+    /// The source, if embedded.
+    pub source: Option<&'a [u8]>,
+}
+
+fn read_u32(bytes: &[u8], at: usize) -> u32 {
+    u32::from_le_bytes(bytes[at..at + 4].try_into().unwrap())
+}
+
+fn read_u64(bytes: &[u8], at: usize) -> u64 {
+    u64::from_le_bytes(bytes[at..at + 8].try_into().unwrap())
+}
+
+fn column<T>(bytes: &[u8], start: usize, count: usize) -> &[T] {
+    let bytes = &bytes[start..start + count * std::mem::size_of::<T>()];
+    // SAFETY: the start is a multiple of 8 into a 4 byte aligned buffer,
+    // checked in Cst::with_language, and T is u16 or u32, valid for any bits.
+    unsafe { std::slice::from_raw_parts(bytes.as_ptr().cast(), count) }
+}
+
+impl<'a> Cst<'a> {
+    /// Reads a file written with this grammar.
+    pub fn new(bytes: &'a [u8]) -> Result<Self, Error> {
+        Self::with_language(bytes, &crate::LANGUAGE.into())
+    }
+
+    /// Reads a file written with the given language. The buffer must be
+    /// 4 byte aligned, as a memory mapping or a `Vec<u8>` from the global
+    /// allocator is.
+    pub fn with_language(bytes: &'a [u8], language: &Language) -> Result<Self, Error> {
+        if cfg!(target_endian = "big") {
+            return Err(Error::BadFormat("big-endian targets are not supported"));
+        }
+        if bytes.len() < HEADER_SIZE || bytes.as_ptr() as usize % 4 != 0 {
+            return Err(Error::BadFormat("truncated or unaligned"));
+        }
+        if &bytes[..8] != MAGIC {
+            return Err(Error::BadFormat("bad magic"));
+        }
+        let version = read_u32(bytes, 8);
+        if version != VERSION {
+            return Err(Error::BadVersion(version));
+        }
+        if read_u64(bytes, 16) != grammar_hash(language) {
+            return Err(Error::Stale);
+        }
+        let node_count = read_u32(bytes, 24) as usize;
+        let source_length = read_u32(bytes, 28) as usize;
+        let embed = read_u32(bytes, 32) & FLAG_SOURCE != 0;
+        let layout = layout(node_count, source_length, embed);
+        if read_u32(bytes, 12) as usize != HEADER_SIZE
+            || node_count == 0
+            || read_u64(bytes, 40) != bytes.len() as u64
+            || layout.size != bytes.len()
+        {
+            return Err(Error::BadFormat("inconsistent header"));
+        }
+
+        let at = layout.columns;
+        let cst = Self {
+            symbol: column(bytes, at[0], node_count),
+            field: column(bytes, at[1], node_count),
+            flags: column(bytes, at[2], node_count),
+            start_byte: column(bytes, at[3], node_count),
+            end_byte: column(bytes, at[4], node_count),
+            start_row: column(bytes, at[5], node_count),
+            start_column: column(bytes, at[6], node_count),
+            end_row: column(bytes, at[7], node_count),
+            end_column: column(bytes, at[8], node_count),
+            parent: column(bytes, at[9], node_count),
+            first_child: column(bytes, at[10], node_count),
+            next_sibling: column(bytes, at[11], node_count),
+            source: layout.source.map(|offset| &bytes[offset..]),
+        };
+        if !cst.links_are_valid() {
+            return Err(Error::BadFormat("links out of pre-order"));
+        }
+        Ok(cst)
+    }
+
+    // Every link points the way pre-order requires, so traversals stay
+    // within the columns.
+    fn links_are_valid(&self) -> bool {
+        let count = self.symbol.len();
+        self.parent[0] == NONE
+            && (0..count).all(|i| {
+                let (parent, child, sibling) =
+                    (self.parent[i], self.first_child[i], self.next_sibling[i]);
+                (i == 0 || (parent as usize) < i)
+                    && (child == NONE || child as usize == i + 1)
+                    && (sibling == NONE || (sibling as usize > i && (sibling as usize) < count))
+            })
+    }
+
+    pub fn node_count(&self) -> usize {
+        self.symbol.len()
+    }
+
+    /// The source bytes of the node, if the source is embedded.
+    pub fn text(&self, node: u32) -> Option<&'a [u8]> {
+        let (start, end) = (self.start_byte[node as usize], self.end_byte[node as usize]);
+        self.source
+            .map(|source| &source[start as usize..end as usize])
+    }
+
+    pub fn children(&self, node: u32) -> impl Iterator<Item = u32> + 'a {
+        let next_sibling = self.next_sibling;
+        let first = self.first_child[node as usize];
+        std::iter::successors((first != NONE).then_some(first), move |&child| {
+            let next = next_sibling[child as usize];
+            (next != NONE).then_some(next)
+        })
+    }
+
+    /// The node after the last descendant of `node`.
+    pub fn subtree_end(&self, mut node: u32) -> u32 {
+        while node != NONE {
+            let sibling = self.next_sibling[node as usize];
+            if sibling != NONE {
+                return sibling;
+            }
+            node = self.parent[node as usize];
+        }
+        self.node_count() as u32
+    }
+
+    /// The first node of the symbol in `from..end`, scanning only the
+    /// symbol column.
+    pub fn find_symbol(&self, symbol: u16, from: u32, end: u32) -> Option<u32> {
+        let end = (end as usize).min(self.node_count());
+        let from = (from as usize).min(end);
+        self.symbol[from..end]
+            .iter()
+            .position(|&s| s == symbol)
+            .map(|i| (from + i) as u32)
+    }
+
+    /// The nodes of the symbol in the subtree of `node`.
+    pub fn descendants_of_symbol(&self, node: u32, symbol: u16) -> impl Iterator<Item = u32> + 'a {
+        let cst = *self;
+        let end = self.subtree_end(node);
+        std::iter::successors(cst.find_symbol(symbol, node, end), move |&found| {
+            cst.find_symbol(symbol, found + 1, end)
+        })
+    }
+
+    /// The smallest node spanning the byte range.
+    pub fn descendant_for_byte_range(&self, start: u32, end: u32) -> u32 {
+        let mut node = 0;
+        while let Some(child) = self.children(node).find(|&child| {
+            let (s, e) = (
+                self.start_byte[child as usize],
+                self.end_byte[child as usize],
+            );
+            s <= start && end <= e && e > s
+        }) {
+            node = child;
+        }
+        node
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn parse(code: &[u8]) -> Tree {
+        let mut parser = tree_sitter::Parser::new();
+        parser.set_language(&crate::LANGUAGE.into()).unwrap();
+        parser.parse(code, None).unwrap()
+    }
+
+    #[test]
+    fn test_round_trip() {
+        let code = b"CLASS lcl DEFINITION.\n  PUBLIC SECTION.\n    METHODS run.\nENDCLASS.\n";
+        let tree = parse(code);
+        let bytes = serialize(&tree, Some(code));
+        let cst = Cst::new(&bytes).unwrap();
+
+        let mut cursor = tree.walk();
+        let mut index = 0;
+        loop {
+            let node = cursor.node();
+            assert_eq!(cst.symbol[index], node.kind_id());
+            assert_eq!(cst.start_byte[index] as usize, node.start_byte());
+            assert_eq!(cst.end_byte[index] as usize, node.end_byte());
+            index += 1;
+            if cursor.goto_first_child() {
+                continue;
+            }
+            while !cursor.goto_next_sibling() {
+                if !cursor.goto_parent() {
+                    assert_eq!(index, cst.node_count());
+                    return;
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_rejects_stale_files() {
+        let tree = parse(b"REPORT ztest.\n");
+        let mut bytes = serialize(&tree, None);
+        bytes[16] ^= 1;
+        assert_eq!(Cst::new(&bytes).unwrap_err(), Error::Stale);
+        assert!(matches!(Cst::new(&bytes[..40]), Err(Error::BadFormat(_))));
+    }
+}
@@ -35,10 +35,14 @@ pub const NODE_TYPES: &str = include_str!("../../src/node-types.json");
 // NOTE: uncomment these to include any queries that this grammar contains:
 
 pub const HIGHLIGHTS_QUERY: &str = include_str!("../../queries/highlights.scm");
-// pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
+pub const INJECTIONS_QUERY: &str = include_str!("../../queries/injections.scm");
 // pub const LOCALS_QUERY: &str = include_str!("../../queries/locals.scm");
 // pub const TAGS_QUERY: &str = include_str!("../../queries/tags.scm");
 
+/// The CST format, parse results in a flat binary form read in place.
+#[cfg(feature = "cst")]
+pub mod cst;
+
 #[cfg(test)]
 mod tests {
     #[test]
@@ -24,8 +24,9 @@ module.exports = grammar({
     // A single full-line comment, only external scanner can do column check
     $.line_comment,
 
-    // Repeated full-line comments without a gap.
-    $.multi_line_comment,
+    // Repeated full-line comments without a gap, the scanner splits long
+    // runs into chunks that are grouped by `multi_line_comment`.
+    $._multi_line_comment_start,
 
     $._docstring_continuation,
 
@@ -38,7 +39,35 @@ module.exports = grammar({
      */
     $.message_type,
 
+    $._multi_line_comment_chunk,
+
+    // A keyword used as a name, decided from what follows the word.
+    $._contextual_name,
+
+    // Zero-width end of an event block, before the next event or reserved
+    // statement.
+    $._event_block_end,
+
+    // The SQLScript of an AMDP method, left to an SQL grammar.
+    $.amdp_body,
+
+    // The rest of a SELECT statement, left to the grammar in abapsql/. Only
+    // used when generated with TREE_SITTER_ABAP_COARSE_SQL set, hidden
+    // otherwise so the node types of the full grammar do not list it.
+    gen.coarseSql ? $.sql_body : $._sql_body,
+
+    // The text of an ABAP Doc paragraph across the `"!` of its lines.
+    $._paragraph_text,
+
+    // A keyword used as a name in an operand position, where a following
+    // word makes it a name too, e.g. `SHIFT text LEFT.`
+    $._contextual_operand_name,
+
     $._error_sentinel,
+
+    // Only when generated with TREE_SITTER_ABAP_KEYWORD_SCANNER set, the
+    // scanner depends on these following the sentinel.
+    ...gen.keywordExternals($),
   ],
 
   conflicts: $ => [
@@ -83,8 +112,7 @@ module.exports = grammar({
     $.calculation_expression,
     $.string_expression,
     $.itab_comp,
-    $.sql_operand,
-    $.sql_column_spec,
+    ...(gen.coarseSql ? [] : [$.sql_operand, $.sql_column_spec]),
   ],
 
   word: $ => $.__name,
@@ -342,8 +370,12 @@ module.exports = grammar({
       ),
 
     ...(() => {
-      const root = process.cwd();
-      const exclude = ["node", "generators.js", "grammar.js"];
+      // Relative to this file, the grammar in abapsql/ extends this one.
+      const root = __dirname;
+      const exclude = ["node", "scripts", "generators.js", "grammar.js"];
+      if (gen.coarseSql) {
+        exclude.push("abapsql");
+      }
 
       const rules = fs
         .readdirSync(root, { recursive: true, withFileTypes: true })
@@ -366,6 +398,21 @@ module.exports = grammar({
       return rules;
     })(),
 
+    // With TREE_SITTER_ABAP_COARSE_SQL set, the rules in grammar/abapsql are
+    // left out and the scanner lexes everything up to the period of a
+    // SELECT statement as one token.
+    ...(gen.coarseSql
+      ? {
+          select_statement: $ =>
+            seq(
+              gen.kw("select"),
+              $.sql_body,
+              ".",
+              optional(seq(gen.kw("endselect"), ".")),
+            ),
+        }
+      : {}),
+
     ...gen.kwRules(),
 
     ...gen.declaration_and_spec("data", $ => $.identifier),
@@ -463,7 +510,8 @@ module.exports = grammar({
         $.parenthesized_expression,
       ),
 
-    _contextual_expression: $ => choice($._contextual_identifier, $.expression),
+    _contextual_expression: $ =>
+      choice($._contextual_identifier, $._contextual_operand, $.expression),
 
     // Restricted source forms used in positions where a full expression causes
     // ambiguity or where the ABAP syntax explicitly requires a single operand.
@@ -471,7 +519,11 @@ module.exports = grammar({
       prec(100, choice($._reference_operand, $.literal, $.substring_access)),
 
     _contextual_simple_operand: $ =>
-      choice($._contextual_identifier, $._simple_operand),
+      choice(
+        $._contextual_identifier,
+        $._contextual_operand,
+        $._simple_operand,
+      ),
 
     _reference_operand: $ =>
       prec(
@@ -598,66 +650,14 @@ module.exports = grammar({
 
     identifier: $ => prec(-1, $.__name),
 
-    // ABAP permits keywords as names. Keep this expensive lexical fallback
+    // ABAP permits keywords as names. The scanner only lexes one as a name
+    // where what follows rules out the keyword, e.g. `data = 10.` Keep it
     // scoped to positions where keyword and identifier parses compete.
-    _contextual_identifier: $ =>
-      alias(
-        prec(
-          -1,
-          choice(
-            ...gen.caseInsensitive(
-              "value",
-              "sum",
-              "new",
-              "cond",
-              "switch",
-              "cast",
-              "conv",
-              "ref",
-              "any",
-              "filter",
-              "reduce",
-              "text",
-              "initialization",
-              "class",
-              "method",
-              "data",
-              "types",
-              "constants",
-              "test",
-              "condense",
-              "split",
-              "replace",
-              "call",
-              "if",
-              "case",
-              "include",
-              "perform",
-              "form",
-              "at",
-              "parameters",
-              "check",
-              "return",
-              "continue",
-              "exit",
-              "try",
-              "raise",
-              "tables",
-              "corresponding",
-              "loop",
-              "read",
-              "sort",
-              "insert",
-              "delete",
-              "append",
-              "interfaces",
-              "interface",
-              "methods",
-            ),
-          ),
-        ),
-        $.identifier,
-      ),
+    _contextual_identifier: $ => alias($._contextual_name, $.identifier),
+
+    // Operand positions no statement can start in also take a keyword followed
+    // by another word as a name, e.g. `TRANSLATE text TO UPPER CASE.`
+    _contextual_operand: $ => alias($._contextual_operand_name, $.identifier),
 
     _immediate_identifier: $ =>
       alias(token.immediate(IDENTIFIER_REGEX), $.identifier),
@@ -10,6 +10,14 @@ const state = {
   grammarProxy: null,
 };
 
+// Opt-in keyword pipeline, see scripts/generate-keywords.js. Has to match the
+// TREE_SITTER_ABAP_KEYWORD_SCANNER define the scanner is compiled with.
+const keywordScanner = !!process.env.TREE_SITTER_ABAP_KEYWORD_SCANNER;
+
+// Opt-in coarse ABAP SQL, see abapsql/grammar.js. SELECT statements keep
+// their body as a single `sql_body` token.
+const coarseSql = !!process.env.TREE_SITTER_ABAP_COARSE_SQL;
+
 function kw(keyword) {
   // Optionals are technically choices
   let opt = false;
@@ -130,7 +138,7 @@ function tightParens(rule) {
 }
 
 function extractKeywords() {
-  const root = process.cwd();
+  const root = path.resolve(__dirname, "../..");
 
   const files = fs
     .readdirSync(root, { recursive: true, withFileTypes: true })
@@ -161,6 +169,27 @@ function extractKeywords() {
   return keywords;
 }
 
+/**
+ * The distinct keywords in lower case and sorted, which is the order of their
+ * external tokens when the keyword scanner is enabled.
+ */
+function keywordList() {
+  const keywords = [...extractKeywords()].map(k => k.toLowerCase());
+  return [...new Set(keywords)].sort();
+}
+
+function keywordTokenName(keyword) {
+  return `_kw_token_${keyword.replace(/[^a-z\d]/g, "_")}`;
+}
+
+/**
+ * The external tokens of the keywords when they are recognized by the
+ * scanner rather than by one regex token each, empty otherwise.
+ */
+function keywordExternals($) {
+  return keywordScanner ? keywordList().map(k => $[keywordTokenName(k)]) : [];
+}
+
 /**
  * Extracts all keyword usages across the source files in order to pre-create
  * rules for them. This helps to ensure all occurrences of a keyword use the
@@ -178,6 +207,15 @@ function kwRules() {
     // an increase of 7MB!
     const repr = `_kw_${keyword.toLowerCase().replace("-", "_")}`;
 
+    // The scanner lexes the word once and looks it up in a perfect hash
+    // table, dashes included.
+    if (keywordScanner) {
+      const external = keywordTokenName(keyword.toLowerCase());
+      rules[repr] = $ =>
+        field("keyword", alias($[external], keyword.toLowerCase()));
+      continue;
+    }
+
     // Some of these cause conflicts, not worth the hassle
     if (
       keyword.includes("-") &&
@@ -209,9 +247,12 @@ function kwRules() {
 
 module.exports = {
   state,
+  coarseSql,
   caseInsensitive,
   kwRules,
   extractKeywords,
+  keywordList,
+  keywordExternals,
   kw,
   kws,
   chainable_immediate,
@@ -14,7 +14,11 @@ module.exports = {
       gen.kw("into"),
       field(
         "destination",
-        choice($._contextual_identifier, $._write_target),
+        choice(
+          $._contextual_identifier,
+          $._contextual_operand,
+          $._write_target,
+        ),
       ),
       optional($.maximum_length_spec),
       optional($.actual_length_spec),
@@ -19,9 +19,12 @@ module.exports = {
           $.component_selection,
         ),
       ),
-      optional($.by_database_spec),
-      ".",
-      optional($.method_body),
+      // The body of an AMDP method is not ABAP but e.g. SQLScript, the
+      // scanner lexes it up to the ENDMETHOD as one `amdp_body`.
+      choice(
+        seq(".", optional($.method_body)),
+        seq($.by_database_spec, ".", optional($.amdp_body)),
+      ),
       gen.kw("endmethod"),
     ),
 
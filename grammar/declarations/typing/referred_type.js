@@ -56,6 +56,7 @@ module.exports = {
         choice(
           $.identifier,
           $._contextual_identifier,
+          $._contextual_operand,
           $.component_selection,
           $.dynamic_spec,
         ),
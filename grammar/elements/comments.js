@@ -1,3 +1,15 @@
 module.exports = {
   inline_comment: _ => prec(0, seq('"', /[^\n\r]*/)),
+
+  /**
+   * Repeated full-line comments without a gap.
+   *
+   * Blocks of commented-out code can be thousands of lines long, so the
+   * scanner emits them in bounded chunks rather than one token. That keeps
+   * the cost of an edit inside of the block proportional to the chunk.
+   */
+  multi_line_comment: $ => seq(
+    $._multi_line_comment_start,
+    repeat($._multi_line_comment_chunk),
+  ),
 };
@@ -10,9 +10,9 @@ module.exports = {
    * actually parse said html to produce anything meaningful. The main thing we care about
    * is the non-html features such as linking other components or listing parameters, etc.
    *
-   * TODO:
    * The special characters ", ', <, >, @, {, |, and } can, if necessary, be escaped
-   * using &quot;, &apos;, &lt;, &gt;, &#64;, &#123;, &#124;, and &#125;.
+   * using &quot;, &apos;, &lt;, &gt;, &#64;, &#123;, &#124;, and &#125;. These are
+   * left in the text, `tree_sitter_abap_doc_text` decodes them.
    *
    * @see https://help.sap.com/doc/abapdocu_latest_index_htm/latest/en-US/ABENDOCCOMMENT.html
    *
@@ -44,7 +44,8 @@ module.exports = {
     ),
 
   /**
-   * A paragraph of documentation, within a single line of the docstring.
+   * A paragraph of documentation, up to the next doctag or empty line of the
+   * docstring.
    *
    * Example:
    * ```
@@ -52,28 +53,14 @@ module.exports = {
    *    ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^ ----------------------  ^^^^^^^
    *              text                              doclink           text
    * ```
-   * If the paragraph is continued in the next line of the docstring, it will
-   * be a seperate node. This is due to the intention to avoid making the `"!"`
-   * line start part of the paragraph, which it technically isnt.
-   *
-   * So a docstring such as
+   * The scanner lexes the text across lines, so a docstring such as
    * ```
    * "!  This is the first line of my awesome docstring
    * "!  that continues into this second line for no reason!
    * ```
-   * Is represented as two seperate paragraph nodes, even semantically they are
-   * one paragraph.
+   * is a single paragraph whose text includes the second `"!`. A paragraph
+   * that ends with a doclink ends with its line, the next line starts a new
+   * paragraph.
    */
-  paragraph: $ =>
-    repeat1(
-      choice(
-        // Looks a little intimidating but is pretty straight forward, we
-        // need to make sure the first character isnt a doclink or a doctag
-        // so not @, { or } and then just consume until we hit a newline or a doclink.
-        // Since doctags may only appear at the start, we no longer worry about that.
-        token.immediate(/(?:\\[{}]|[^@{}\n\r])(?:\\[{}]|[^{}\n\r])*/),
-        $.doclink,
-      ),
-    ),
+  paragraph: $ => repeat1(choice($._paragraph_text, $.doclink)),
 };
-
@@ -10,10 +10,8 @@ module.exports = {
    *       FOR {para|selcrit-low|selcrit-high} }
    *   | { ON EXIT-COMMAND }.
    *
-   * Because the body has no clear terminator, this rule is very prone to shift / reduce
-   * conflicts. The only way to actually solve it seems to be using dynamic precenden
-   * and adding the rule to conflicts.
-   *
+   * The body has no terminator, the scanner ends it with `_event_block_end`
+   * like the other event blocks.
    */
   at_selscreen_statement: $ =>
     seq(
@@ -21,6 +19,7 @@ module.exports = {
       optional(field("event", $.__selection_screen_event)),
       ".",
       optional(field("body", $.statement_block)),
+      $._event_block_end,
     ),
 
   __selection_screen_event: $ =>
@@ -18,7 +18,11 @@ module.exports = {
       // data objects (including literals) are possible
       field(
         "subject",
-        choice($._contextual_identifier, $._simple_operand),
+        choice(
+          $._contextual_identifier,
+          $._contextual_operand,
+          $._simple_operand,
+        ),
       ),
       repeat($.__describe_field_addition),
     ),
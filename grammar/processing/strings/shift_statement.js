@@ -18,7 +18,11 @@ module.exports = {
       gen.kw("shift"),
       field(
         "subject",
-        choice($._contextual_identifier, $._modifiable_target),
+        choice(
+          $._contextual_identifier,
+          $._contextual_operand,
+          $._modifiable_target,
+        ),
       ),
       repeat($.__shift_addition),
     ),
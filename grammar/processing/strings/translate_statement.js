@@ -12,7 +12,11 @@ module.exports = {
       gen.kw("translate"),
       field(
         "subject",
-        choice($._contextual_identifier, $._modifiable_target),
+        choice(
+          $._contextual_identifier,
+          $._contextual_operand,
+          $._modifiable_target,
+        ),
       ),
       choice(
         $.to_lower_case_spec,
@@ -14,7 +14,11 @@ module.exports = {
       gen.kw("to"),
       field(
         "destination",
-        choice($._contextual_identifier, $._write_target),
+        choice(
+          $._contextual_identifier,
+          $._contextual_operand,
+          $._write_target,
+        ),
       ),
       repeat($.__format_option),
     ),
@@ -1,3 +1,8 @@
+/**
+ * Event blocks have no closing statement, they end where the next event or
+ * another {@link reserved_statement} begins. The external scanner decides
+ * that from the upcoming word and emits the zero-width `_event_block_end`.
+ */
 module.exports = {
   /**
    * LOAD-OF-PROGRAM.
@@ -11,6 +16,7 @@ module.exports = {
       gen.kw("load-of-program"),
       ".",
       optional(field("body", $.statement_block)),
+      $._event_block_end,
     ),
 
   /**
@@ -25,6 +31,7 @@ module.exports = {
       gen.kw("initialization"),
       ".",
       optional(field("body", $.statement_block)),
+      $._event_block_end,
     ),
 
   /**
@@ -39,5 +46,6 @@ module.exports = {
       gen.kw("start-of-selection"),
       ".",
       optional(field("body", $.statement_block)),
+      $._event_block_end,
     ),
 };
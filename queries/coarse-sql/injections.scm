@@ -0,0 +1,6 @@
+; Only for parsers generated with TREE_SITTER_ABAP_COARSE_SQL, append to
+; injections.scm. The rest of a SELECT statement for the abapsql grammar in
+; this repository. The full grammar has no `sql_body`, so this query does not
+; compile against it.
+((sql_body) @injection.content
+  (#set! injection.language "abapsql"))
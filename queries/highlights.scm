@@ -27,14 +27,90 @@
 ] @keyword.directive
 
 
+; The sets only list the lower case, upper case and capitalized spelling of
+; a name, see scripts/generate-highlight-sets.js.
 (function_call 
   name: (identifier) @function.builtin @function.call
-  (#match? @function.builtin "^([bB][oO][oO][lL][cC]|[bB][oO][oO][lL][xX]|[xX][sS][dB][bB][oO][oO][lL]|[cC][oO][nN][tT][aA][iI][nN][sS]|[cC][oO][nN][tT][aA][iI][nN][sS]_[aA][nN][yY]_[oO][fF]|[cC][oO][nN][tT][aA][iI][nN][sS]_[aA][nN][yY]_[nN][oO][tT]_[oO][fF]|[mM][aA][tT][cC][hH][eE][sS]|[lL][iI][nN][eE]_[eE][xX][iI][sS][tT][sS]|[aA][bB][sS]|[cC][eE][iI][lL]|[fF][lL][oO][oO][rR]|[fF][rR][aA][cC]|[sS][iI][gG][nN]|[tT][rR][uU][nN][cC]|[iI][pP][oO][wW]|[nN][mM][aA][xX]|[nN][mM][iI][nN]|[aA][cC][oO][sS]|[aA][sS][iI][nN]|[aA][tT][aA][nN]|[cC][oO][sS]|[sS][iI][nN]|[tT][aA][nN]|[cC][oO][sS][hH]|[sS][iI][nN][hH]|[tT][aA][nN][hH]|[eE][xX][pP]|[lL][oO][gG]|[lL][oO][gG]10|[sS][qQ][rR][tT]|[rR][oO][uU][nN][dB]|[rR][eE][sS][cC][aA][lL][eE]|[gG][aA][mM][mM][aA]|[lL][oO][gG]_[gG][aA][mM][mM][aA]|[gG][aA][mM][mM][aA]_[lL][oO][wW][eE][rR]|[fF][aA][cC][tT][oO][rR][iI][aA][lL]|[bB][iI][nN][oO][mM][iI][aA][lL]|[eE][rR][fF]|[eE][rR][fF][cC]|[eE][rR][fF]_[iI][nN][vV]|[eE][rR][fF][cC]_[iI][nN][vV]|[cC][hH][aA][rR][lL][eE][nN]|[dD][bB][mM][aA][xX][lL][eE][nN]|[nN][uU][mM][oO][fF][cC][hH][aA][rR]|[sS][tT][rR][lL][eE][nN]|[cC][hH][aA][rR]_[oO][fF][fF]|[cC][mM][aA][xX]|[cC][mM][iI][nN]|[cC][oO][uU][nN][tT]|[cC][oO][uU][nN][tT]_[aA][nN][yY]_[oO][fF]|[cC][oO][uU][nN][tT]_[aA][nN][yY]_[nN][oO][tT]_[oO][fF]|[dD][iI][sS][tT][aA][nN][cC][eE]|[cC][oO][nN][dB][eE][nN][sS][eE]|[cC][oO][nN][cC][aA][tT]_[lL][iI][nN][eE][sS]_[oO][fF]|[eE][sS][cC][aA][pP][eE]|[fF][iI][nN][dB]|[fF][iI][nN][dB]_[eE][nN][dB]|[fF][iI][nN][dB]_[aA][nN][yY]_[oO][fF]|[fF][iI][nN][dB]_[aA][nN][yY]_[nN][oO][tT]_[oO][fF]|[iI][nN][sS][eE][rR][tT]|[mM][aA][tT][cC][hH]|[rR][eE][pP][eE][aA][tT]|[rR][eE][pP][lL][aA][cC][eE]|[rR][eE][vV][eE][rR][sS][eE]|[sS][eE][gG][mM][eE][nN][tT]|[sS][hH][iI][fF][tT]_[lL][eE][fF][tT]|[sS][hH][iI][fF][tT]_[rR][iI][gG][hH][tT]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[aA][fF][tT][eE][rR]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[fF][rR][oO][mM]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[bB][eE][fF][oO][rR][eE]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[tT][oO]|[tT][oO]_[uU][pP][pP][eE][rR]|[tT][oO]_[lL][oO][wW][eE][rR]|[tT][oO]_[mM][iI][xX][eE][dB]|[fF][rR][oO][mM]_[mM][iI][xX][eE][dB]|[tT][rR][aA][nN][sS][lL][aA][tT][eE]|[xX][sS][tT][rR][lL][eE][nN]|[bB][iI][tT]-[sS][eE][tT]|[uU][tT][cC][lL][oO][nN][gG]_[cC][uU][rR][rR][eE][nN][tT]|[uU][tT][cC][lL][oO][nN][gG]_[aA][dB][dB]|[uU][tT][cC][lL][oO][nN][gG]_[dD][iI][fF][fF]|[lL][iI][nN][eE][sS]|[lL][iI][nN][eE]_[iI][nN][dB][eE][xX])$")
+  ; generated: builtin_functions
+  (#any-of? @function.builtin "boolc" "BOOLC" "Boolc" "boolx" "BOOLX" "Boolx"
+    "xsdbool" "XSDBOOL" "Xsdbool" "contains" "CONTAINS" "Contains"
+    "contains_any_of" "CONTAINS_ANY_OF" "Contains_any_of" "contains_any_not_of"
+    "CONTAINS_ANY_NOT_OF" "Contains_any_not_of" "matches" "MATCHES" "Matches"
+    "line_exists" "LINE_EXISTS" "Line_exists" "abs" "ABS" "Abs" "ceil" "CEIL"
+    "Ceil" "floor" "FLOOR" "Floor" "frac" "FRAC" "Frac" "sign" "SIGN" "Sign"
+    "trunc" "TRUNC" "Trunc" "ipow" "IPOW" "Ipow" "nmax" "NMAX" "Nmax" "nmin"
+    "NMIN" "Nmin" "acos" "ACOS" "Acos" "asin" "ASIN" "Asin" "atan" "ATAN" "Atan"
+    "cos" "COS" "Cos" "sin" "SIN" "Sin" "tan" "TAN" "Tan" "cosh" "COSH" "Cosh"
+    "sinh" "SINH" "Sinh" "tanh" "TANH" "Tanh" "exp" "EXP" "Exp" "log" "LOG"
+    "Log" "log10" "LOG10" "Log10" "sqrt" "SQRT" "Sqrt" "round" "ROUND" "Round"
+    "rescale" "RESCALE" "Rescale" "gamma" "GAMMA" "Gamma" "log_gamma"
+    "LOG_GAMMA" "Log_gamma" "gamma_lower" "GAMMA_LOWER" "Gamma_lower"
+    "factorial" "FACTORIAL" "Factorial" "binomial" "BINOMIAL" "Binomial" "erf"
+    "ERF" "Erf" "erfc" "ERFC" "Erfc" "erf_inv" "ERF_INV" "Erf_inv" "erfc_inv"
+    "ERFC_INV" "Erfc_inv" "charlen" "CHARLEN" "Charlen" "dbmaxlen" "DBMAXLEN"
+    "Dbmaxlen" "numofchar" "NUMOFCHAR" "Numofchar" "strlen" "STRLEN" "Strlen"
+    "char_off" "CHAR_OFF" "Char_off" "cmax" "CMAX" "Cmax" "cmin" "CMIN" "Cmin"
+    "count" "COUNT" "Count" "count_any_of" "COUNT_ANY_OF" "Count_any_of"
+    "count_any_not_of" "COUNT_ANY_NOT_OF" "Count_any_not_of" "distance"
+    "DISTANCE" "Distance" "condense" "CONDENSE" "Condense" "concat_lines_of"
+    "CONCAT_LINES_OF" "Concat_lines_of" "escape" "ESCAPE" "Escape" "find" "FIND"
+    "Find" "find_end" "FIND_END" "Find_end" "find_any_of" "FIND_ANY_OF"
+    "Find_any_of" "find_any_not_of" "FIND_ANY_NOT_OF" "Find_any_not_of" "insert"
+    "INSERT" "Insert" "match" "MATCH" "Match" "repeat" "REPEAT" "Repeat"
+    "replace" "REPLACE" "Replace" "reverse" "REVERSE" "Reverse" "segment"
+    "SEGMENT" "Segment" "shift_left" "SHIFT_LEFT" "Shift_left" "shift_right"
+    "SHIFT_RIGHT" "Shift_right" "substring" "SUBSTRING" "Substring"
+    "substring_after" "SUBSTRING_AFTER" "Substring_after" "substring_from"
+    "SUBSTRING_FROM" "Substring_from" "substring_before" "SUBSTRING_BEFORE"
+    "Substring_before" "substring_to" "SUBSTRING_TO" "Substring_to" "to_upper"
+    "TO_UPPER" "To_upper" "to_lower" "TO_LOWER" "To_lower" "to_mixed" "TO_MIXED"
+    "To_mixed" "from_mixed" "FROM_MIXED" "From_mixed" "translate" "TRANSLATE"
+    "Translate" "xstrlen" "XSTRLEN" "Xstrlen" "bit-set" "BIT-SET" "Bit-set"
+    "utclong_current" "UTCLONG_CURRENT" "Utclong_current" "utclong_add"
+    "UTCLONG_ADD" "Utclong_add" "utclong_diff" "UTCLONG_DIFF" "Utclong_diff"
+    "lines" "LINES" "Lines" "line_index" "LINE_INDEX" "Line_index")
 )
 
 (function_call 
   name: (identifier) @function.method @function.method.call
-  (#not-match? @function.method "^([bB][oO][oO][lL][cC]|[bB][oO][oO][lL][xX]|[xX][sS][dB][bB][oO][oO][lL]|[cC][oO][nN][tT][aA][iI][nN][sS]|[cC][oO][nN][tT][aA][iI][nN][sS]_[aA][nN][yY]_[oO][fF]|[cC][oO][nN][tT][aA][iI][nN][sS]_[aA][nN][yY]_[nN][oO][tT]_[oO][fF]|[mM][aA][tT][cC][hH][eE][sS]|[lL][iI][nN][eE]_[eE][xX][iI][sS][tT][sS]|[aA][bB][sS]|[cC][eE][iI][lL]|[fF][lL][oO][oO][rR]|[fF][rR][aA][cC]|[sS][iI][gG][nN]|[tT][rR][uU][nN][cC]|[iI][pP][oO][wW]|[nN][mM][aA][xX]|[nN][mM][iI][nN]|[aA][cC][oO][sS]|[aA][sS][iI][nN]|[aA][tT][aA][nN]|[cC][oO][sS]|[sS][iI][nN]|[tT][aA][nN]|[cC][oO][sS][hH]|[sS][iI][nN][hH]|[tT][aA][nN][hH]|[eE][xX][pP]|[lL][oO][gG]|[lL][oO][gG]10|[sS][qQ][rR][tT]|[rR][oO][uU][nN][dB]|[rR][eE][sS][cC][aA][lL][eE]|[gG][aA][mM][mM][aA]|[lL][oO][gG]_[gG][aA][mM][mM][aA]|[gG][aA][mM][mM][aA]_[lL][oO][wW][eE][rR]|[fF][aA][cC][tT][oO][rR][iI][aA][lL]|[bB][iI][nN][oO][mM][iI][aA][lL]|[eE][rR][fF]|[eE][rR][fF][cC]|[eE][rR][fF]_[iI][nN][vV]|[eE][rR][fF][cC]_[iI][nN][vV]|[cC][hH][aA][rR][lL][eE][nN]|[dD][bB][mM][aA][xX][lL][eE][nN]|[nN][uU][mM][oO][fF][cC][hH][aA][rR]|[sS][tT][rR][lL][eE][nN]|[cC][hH][aA][rR]_[oO][fF][fF]|[cC][mM][aA][xX]|[cC][mM][iI][nN]|[cC][oO][uU][nN][tT]|[cC][oO][uU][nN][tT]_[aA][nN][yY]_[oO][fF]|[cC][oO][uU][nN][tT]_[aA][nN][yY]_[nN][oO][tT]_[oO][fF]|[dD][iI][sS][tT][aA][nN][cC][eE]|[cC][oO][nN][dB][eE][nN][sS][eE]|[cC][oO][nN][cC][aA][tT]_[lL][iI][nN][eE][sS]_[oO][fF]|[eE][sS][cC][aA][pP][eE]|[fF][iI][nN][dB]|[fF][iI][nN][dB]_[eE][nN][dB]|[fF][iI][nN][dB]_[aA][nN][yY]_[oO][fF]|[fF][iI][nN][dB]_[aA][nN][yY]_[nN][oO][tT]_[oO][fF]|[iI][nN][sS][eE][rR][tT]|[mM][aA][tT][cC][hH]|[rR][eE][pP][eE][aA][tT]|[rR][eE][pP][lL][aA][cC][eE]|[rR][eE][vV][eE][rR][sS][eE]|[sS][eE][gG][mM][eE][nN][tT]|[sS][hH][iI][fF][tT]_[lL][eE][fF][tT]|[sS][hH][iI][fF][tT]_[rR][iI][gG][hH][tT]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[aA][fF][tT][eE][rR]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[fF][rR][oO][mM]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[bB][eE][fF][oO][rR][eE]|[sS][uU][bB][sS][tT][rR][iI][nN][gG]_[tT][oO]|[tT][oO]_[uU][pP][pP][eE][rR]|[tT][oO]_[lL][oO][wW][eE][rR]|[tT][oO]_[mM][iI][xX][eE][dB]|[fF][rR][oO][mM]_[mM][iI][xX][eE][dB]|[tT][rR][aA][nN][sS][lL][aA][tT][eE]|[xX][sS][tT][rR][lL][eE][nN]|[bB][iI][tT]-[sS][eE][tT]|[uU][tT][cC][lL][oO][nN][gG]_[cC][uU][rR][rR][eE][nN][tT]|[uU][tT][cC][lL][oO][nN][gG]_[aA][dB][dB]|[uU][tT][cC][lL][oO][nN][gG]_[dD][iI][fF][fF]|[lL][iI][nN][eE][sS]|[lL][iI][nN][eE]_[iI][nN][dB][eE][xX])$")
+  ; generated: builtin_functions
+  (#not-any-of? @function.method "boolc" "BOOLC" "Boolc" "boolx" "BOOLX" "Boolx"
+    "xsdbool" "XSDBOOL" "Xsdbool" "contains" "CONTAINS" "Contains"
+    "contains_any_of" "CONTAINS_ANY_OF" "Contains_any_of" "contains_any_not_of"
+    "CONTAINS_ANY_NOT_OF" "Contains_any_not_of" "matches" "MATCHES" "Matches"
+    "line_exists" "LINE_EXISTS" "Line_exists" "abs" "ABS" "Abs" "ceil" "CEIL"
+    "Ceil" "floor" "FLOOR" "Floor" "frac" "FRAC" "Frac" "sign" "SIGN" "Sign"
+    "trunc" "TRUNC" "Trunc" "ipow" "IPOW" "Ipow" "nmax" "NMAX" "Nmax" "nmin"
+    "NMIN" "Nmin" "acos" "ACOS" "Acos" "asin" "ASIN" "Asin" "atan" "ATAN" "Atan"
+    "cos" "COS" "Cos" "sin" "SIN" "Sin" "tan" "TAN" "Tan" "cosh" "COSH" "Cosh"
+    "sinh" "SINH" "Sinh" "tanh" "TANH" "Tanh" "exp" "EXP" "Exp" "log" "LOG"
+    "Log" "log10" "LOG10" "Log10" "sqrt" "SQRT" "Sqrt" "round" "ROUND" "Round"
+    "rescale" "RESCALE" "Rescale" "gamma" "GAMMA" "Gamma" "log_gamma"
+    "LOG_GAMMA" "Log_gamma" "gamma_lower" "GAMMA_LOWER" "Gamma_lower"
+    "factorial" "FACTORIAL" "Factorial" "binomial" "BINOMIAL" "Binomial" "erf"
+    "ERF" "Erf" "erfc" "ERFC" "Erfc" "erf_inv" "ERF_INV" "Erf_inv" "erfc_inv"
+    "ERFC_INV" "Erfc_inv" "charlen" "CHARLEN" "Charlen" "dbmaxlen" "DBMAXLEN"
+    "Dbmaxlen" "numofchar" "NUMOFCHAR" "Numofchar" "strlen" "STRLEN" "Strlen"
+    "char_off" "CHAR_OFF" "Char_off" "cmax" "CMAX" "Cmax" "cmin" "CMIN" "Cmin"
+    "count" "COUNT" "Count" "count_any_of" "COUNT_ANY_OF" "Count_any_of"
+    "count_any_not_of" "COUNT_ANY_NOT_OF" "Count_any_not_of" "distance"
+    "DISTANCE" "Distance" "condense" "CONDENSE" "Condense" "concat_lines_of"
+    "CONCAT_LINES_OF" "Concat_lines_of" "escape" "ESCAPE" "Escape" "find" "FIND"
+    "Find" "find_end" "FIND_END" "Find_end" "find_any_of" "FIND_ANY_OF"
+    "Find_any_of" "find_any_not_of" "FIND_ANY_NOT_OF" "Find_any_not_of" "insert"
+    "INSERT" "Insert" "match" "MATCH" "Match" "repeat" "REPEAT" "Repeat"
+    "replace" "REPLACE" "Replace" "reverse" "REVERSE" "Reverse" "segment"
+    "SEGMENT" "Segment" "shift_left" "SHIFT_LEFT" "Shift_left" "shift_right"
+    "SHIFT_RIGHT" "Shift_right" "substring" "SUBSTRING" "Substring"
+    "substring_after" "SUBSTRING_AFTER" "Substring_after" "substring_from"
+    "SUBSTRING_FROM" "Substring_from" "substring_before" "SUBSTRING_BEFORE"
+    "Substring_before" "substring_to" "SUBSTRING_TO" "Substring_to" "to_upper"
+    "TO_UPPER" "To_upper" "to_lower" "TO_LOWER" "To_lower" "to_mixed" "TO_MIXED"
+    "To_mixed" "from_mixed" "FROM_MIXED" "From_mixed" "translate" "TRANSLATE"
+    "Translate" "xstrlen" "XSTRLEN" "Xstrlen" "bit-set" "BIT-SET" "Bit-set"
+    "utclong_current" "UTCLONG_CURRENT" "Utclong_current" "utclong_add"
+    "UTCLONG_ADD" "Utclong_add" "utclong_diff" "UTCLONG_DIFF" "Utclong_diff"
+    "lines" "LINES" "Lines" "line_index" "LINE_INDEX" "Line_index")
 )
 
 
@@ -114,7 +190,9 @@
 (_contextual_expression/identifier) @variable
 (_character_position/identifier) @variable
 ((name_reference/identifier) @variable.builtin
-  ( #match? @variable.builtin "^(([mM][eE])|([sS][uU][pP][eE][rR])|([sS][yY]))$"))
+  ; generated: builtin_variables
+  (#any-of? @variable.builtin "me" "ME" "Me" "super" "SUPER" "Super" "sy" "SY"
+    "Sy"))
 
 (assignment (identifier) @variable)
 (calculation_assignment left: (identifier) @variable)
@@ -142,6 +220,7 @@
 (overlay_statement overlay: (identifier) @variable)
 (only_spec mask: (identifier) @variable)
 (translate_statement subject: (identifier) @variable)
+(describe_field_statement subject: (identifier) @variable)
 (set_bit_statement position: (identifier) @variable)
 (set_bit_statement subject: (identifier) @variable)
 (set_bit_statement to: (identifier) @variable)
@@ -150,6 +229,7 @@
 (get_bit_statement into: (identifier) @variable)
 (write_to_statement source: (identifier) @variable)
 (write_to_statement destination: (identifier) @variable)
+(read_dataset_statement destination: (identifier) @variable)
 (format_unit_spec value: (identifier) @variable)
 (get_reference_statement source: (identifier) @variable)
 (tables_declaration (tables_spec name: (identifier) @variable ))
@@ -275,7 +355,8 @@
  (component_selection
   subject: (identifier) @variable.builtin
   selector: "-" )
-  ( #match? @variable.builtin "^([sS][yY])$" )
+  ; generated: system_structure
+  (#any-of? @variable.builtin "sy" "SY" "Sy")
 )
 
 
@@ -311,7 +392,8 @@
 (named_argument
   name: (identifier) @variable.parameter
   value: (string_literal) @string.regexp
-  (#match? @variable.parameter "^([pP][cC][rR][eE]|[rR][eE][gG][eE][xX])$")
+  ; generated: regex_parameters
+  (#any-of? @variable.parameter "pcre" "PCRE" "Pcre" "regex" "REGEX" "Regex")
 )
 
 (implicit_reference name: (identifier) @variable.parameter )
@@ -378,7 +460,10 @@
 
 ; CONSTANTS
 ((name_reference/identifier) @constant.builtin
-  (#match? @constant.builtin "^([aA][bB][aA][pP]_(([tT][rR][uU][eE])|([fF][aA][lL][sS][eE])|([uU][nN][dD][eE][fF][iI][nN][eE][dD]))|([sS][pP][aA][cC][eE]))$" )
+  ; generated: builtin_constants
+  (#any-of? @constant.builtin "abap_true" "ABAP_TRUE" "Abap_true" "abap_false"
+    "ABAP_FALSE" "Abap_false" "abap_undefined" "ABAP_UNDEFINED" "Abap_undefined"
+    "space" "SPACE" "Space")
 )
 (text_symbol
   (string_literal)
@@ -532,7 +617,8 @@
     (parameter
       (implicit_reference 
         name: (identifier) @variable.parameter.builtin
-        ( #match? @variable.parameter.builtin "^[sS][eE][nN][dD][eE][rR]$" )
+        ; generated: event_sender
+        (#any-of? @variable.parameter.builtin "sender" "SENDER" "Sender")
       )
     )
   )
@@ -609,13 +695,23 @@
 (_ typing: (_ object: (identifier) @variable ))
 (_ typing: (_ (identifier) @type !object ))
 (_ typing: (_ (identifier) @type.builtin !object 
-  (#match? @type.builtin "^([bBcCdDfFiInNpPsStTxX]|[dD][eE][cC][fF][lL][oO][aA][tT]16|[dD][eE][cC][fF][lL][oO][aA][tT]34|[iI][nN][tT]8|[sS][tT][rR][iI][nN][gG]|[uU][tT][cC][lL][oO][nN][gG]|[xX][sS][tT][rR][iI][nN][gG]|[aA][nN][yY])$")
+  ; generated: builtin_types
+  (#any-of? @type.builtin "b" "B" "c" "C" "d" "D" "f" "F" "i" "I" "n" "N" "p"
+    "P" "s" "S" "t" "T" "x" "X" "decfloat16" "DECFLOAT16" "Decfloat16"
+    "decfloat34" "DECFLOAT34" "Decfloat34" "int8" "INT8" "Int8" "string"
+    "STRING" "String" "utclong" "UTCLONG" "Utclong" "xstring" "XSTRING"
+    "Xstring" "any" "ANY" "Any")
 ))
 
 ; Constructor results
 (_ [ result_type: (identifier) base_type: (identifier) ] @type )
 (_ [ result_type: (identifier) base_type: (identifier) ] @type.builtin
-  (#match? @type.builtin "^([bBcCdDfFiInNpPsStTxX]|[dD][eE][cC][fF][lL][oO][aA][tT]16|[dD][eE][cC][fF][lL][oO][aA][tT]34|[iI][nN][tT]8|[sS][tT][rR][iI][nN][gG]|[uU][tT][cC][lL][oO][nN][gG]|[xX][sS][tT][rR][iI][nN][gG]|[aA][nN][yY])$")
+  ; generated: builtin_types
+  (#any-of? @type.builtin "b" "B" "c" "C" "d" "D" "f" "F" "i" "I" "n" "N" "p"
+    "P" "s" "S" "t" "T" "x" "X" "decfloat16" "DECFLOAT16" "Decfloat16"
+    "decfloat34" "DECFLOAT34" "Decfloat34" "int8" "INT8" "Int8" "string"
+    "STRING" "String" "utclong" "UTCLONG" "Utclong" "xstring" "XSTRING"
+    "Xstring" "any" "ANY" "Any")
 )
 
 
@@ -846,6 +942,8 @@
 
 
 ; ABAP SQL
+; Parsers generated with TREE_SITTER_ABAP_COARSE_SQL have none of these
+; nodes, see grammar/readme.md. abapsql/queries/highlights.scm has a copy.
 (from_database_source_spec (identifier) @type )
 (sql_function_call name: (identifier) @function.call)
 (sql_cast_type name: (identifier) @type.builtin)
@@ -0,0 +1,5 @@
+; The body of an AMDP method is SQLScript (LANGUAGE SQLSCRIPT) or plain SQL,
+; lexed as a single `amdp_body` token. Hosts parse it with their SQL grammar
+; only when they need it, e.g. when it is visible.
+((amdp_body) @injection.content
+  (#set! injection.language "sql"))
@@ -0,0 +1,143 @@
+#!/usr/bin/env node
+/**
+ * Checks `block_start_keywords` in src/scanner.c against the grammar.
+ *
+ * An event block ends in front of a word of the list, so it has to hold the
+ * first keyword of every `reserved_statement` alternative. A keyword missing
+ * from it keeps the statement in the body of the event before it, a word too
+ * many ends the body early. `block_start_prefixes` and
+ * `BLOCK_WORD_MAX_LENGTH` are derived from the list and checked as well.
+ *
+ * The first keywords are read from src/grammar.json, so generate first after
+ * changing the grammar. Exits with 1 and prints the differences on drift.
+ *
+ * Run from the repository root:
+ *
+ *   node scripts/check-block-start-keywords.js [grammar.json] [scanner.c]
+ */
+const fs = require("fs");
+const path = require("path");
+
+const grammarFile = process.argv[2] ?? path.join("src", "grammar.json");
+const scannerFile = process.argv[3] ?? path.join("src", "scanner.c");
+
+const rules = JSON.parse(fs.readFileSync(grammarFile, "utf8")).rules;
+
+/** The keyword a `_kw_*` rule stands for, e.g. `class-data`. */
+function keywordOf(name) {
+  return name.replace(/^_+kw_/, "").replace(/_/g, "-");
+}
+
+const firstCache = new Map();
+
+/**
+ * The keywords a rule can start with and whether it can be empty. Anything
+ * but a keyword that can come first is an error, the scanner only looks at
+ * words.
+ */
+function first(rule) {
+  switch (rule.type) {
+    case "SYMBOL": {
+      if (/^_+kw_/.test(rule.name)) {
+        return { keywords: new Set([keywordOf(rule.name)]), empty: false };
+      }
+      if (!firstCache.has(rule.name)) {
+        // Left recursion adds nothing to the first keywords.
+        firstCache.set(rule.name, { keywords: new Set(), empty: false });
+        firstCache.set(rule.name, first(rules[rule.name]));
+      }
+      return firstCache.get(rule.name);
+    }
+    case "SEQ": {
+      const keywords = new Set();
+      for (const member of rule.members) {
+        const result = first(member);
+        result.keywords.forEach(k => keywords.add(k));
+        if (!result.empty) {
+          return { keywords, empty: false };
+        }
+      }
+      return { keywords, empty: true };
+    }
+    case "CHOICE": {
+      const keywords = new Set();
+      let empty = false;
+      for (const member of rule.members) {
+        const result = first(member);
+        result.keywords.forEach(k => keywords.add(k));
+        empty ||= result.empty;
+      }
+      return { keywords, empty };
+    }
+    case "REPEAT":
+      return { keywords: first(rule.content).keywords, empty: true };
+    case "BLANK":
+      return { keywords: new Set(), empty: true };
+    case "REPEAT1":
+    case "FIELD":
+    case "ALIAS":
+    case "PREC":
+    case "PREC_LEFT":
+    case "PREC_RIGHT":
+    case "PREC_DYNAMIC":
+      return first(rule.content);
+    default:
+      throw new Error(
+        `${JSON.stringify(rule).slice(0, 80)} can start a reserved_statement`,
+      );
+  }
+}
+
+/** The strings of a `static const char* const <name>[]` array. */
+function scannerList(source, name) {
+  const match = source.match(
+    new RegExp(`static const char\\* const ${name}\\[\\] = \\{([^}]*)\\}`),
+  );
+  if (!match) {
+    throw new Error(`${name} not found in ${scannerFile}`);
+  }
+  return [...match[1].matchAll(/"([^"]*)"/g)].map(m => m[1]);
+}
+
+const expected = [...first(rules.reserved_statement).keywords].sort();
+
+const source = fs.readFileSync(scannerFile, "utf8");
+const keywords = scannerList(source, "block_start_keywords");
+const prefixes = scannerList(source, "block_start_prefixes");
+const maxLength = Number(
+  source.match(/#define BLOCK_WORD_MAX_LENGTH (\d+)/)?.[1],
+);
+
+const expectedPrefixes = [
+  ...new Set(
+    expected.flatMap(k =>
+      [...k.matchAll(/-/g)].map(m => k.slice(0, m.index)),
+    ),
+  ),
+].sort();
+const expectedMaxLength = Math.max(...expected.map(k => k.length));
+
+const errors = [];
+const missing = expected.filter(k => !keywords.includes(k));
+const extra = keywords.filter(k => !expected.includes(k));
+if (missing.length > 0) {
+  errors.push(`block_start_keywords misses ${missing.join(", ")}`);
+}
+if (extra.length > 0) {
+  errors.push(`block_start_keywords has ${extra.join(", ")} too many`);
+}
+if (missing.length === 0 && keywords.join() !== expected.join()) {
+  errors.push("block_start_keywords is not sorted");
+}
+if (prefixes.join() !== expectedPrefixes.join()) {
+  errors.push(`block_start_prefixes should be ${expectedPrefixes.join(", ")}`);
+}
+if (maxLength !== expectedMaxLength) {
+  errors.push(`BLOCK_WORD_MAX_LENGTH should be ${expectedMaxLength}`);
+}
+
+if (errors.length > 0) {
+  errors.forEach(e => console.error(`${scannerFile}: ${e}`));
+  process.exit(1);
+}
+console.log(`${keywords.length} block start keywords match reserved_statement`);
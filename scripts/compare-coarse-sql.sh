@@ -0,0 +1,99 @@
+#!/bin/sh
+
+# Compares the full grammar with the coarse ABAP SQL split
+# (TREE_SITTER_ABAP_COARSE_SQL) on the size of the main parser, its compile
+# time and compiled size and parse throughput. The coarse variant also
+# reports the size of the abapsql parser, which hosts only load to parse a
+# `sql_body` on demand.
+#
+#   scripts/compare-coarse-sql.sh [input...]
+#
+# The inputs are passed to abap-bench-throughput and default to
+# test/corpus/abapsql and a 4 MB synthetic report. An input of the form
+# synthetic:KIND[:AMOUNT] is generated. Both variants are generated in
+# temporary copies of the working tree, the checkout itself is left
+# untouched. Requires the tree-sitter CLI and the runtime through
+# pkg-config, see bench/readme.md.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+tree_sitter=${TREE_SITTER_BIN:-tree-sitter}
+cc=${CC:-cc}
+if [ $# -eq 0 ]; then
+  set -- test/corpus/abapsql synthetic:report:4m
+fi
+
+work=$(mktemp -d "${TMPDIR:-/tmp}/tree-sitter-abap-coarse-sql.XXXXXX")
+trap 'rm -rf "$work"' EXIT HUP INT TERM
+
+now_ns() {
+  date +%s%N
+}
+
+define_value() {
+  sed -n "s/^#define $1 \([0-9]*\)$/\1/p" "$2"
+}
+
+# parser_size <name> <parser.c> <object>
+parser_size() {
+  printf '"%s":{"state_count":%s,"symbol_count":%s,' \
+    "$1" "$(define_value STATE_COUNT "$2")" "$(define_value SYMBOL_COUNT "$2")"
+  printf '"generated_parser_bytes":%s,"compile_ns":%s,"compiled_parser_bytes":%s}' \
+    "$(wc -c < "$2" | tr -d ' ')" "$compile_ns" "$(wc -c < "$3" | tr -d ' ')"
+}
+
+# measure <name> <coarse sql: 0|1> <inputs...>
+measure() {
+  name=$1
+  coarse=$2
+  shift 2
+  dir="$work/$name"
+  mkdir -p "$dir"
+  (cd "$root" && git ls-files -z --cached --others --exclude-standard |
+    xargs -0 tar -cf - 2>/dev/null) | tar -xf - -C "$dir"
+
+  cd "$dir"
+  if [ "$coarse" = 1 ]; then
+    TREE_SITTER_ABAP_COARSE_SQL=1 "$tree_sitter" generate >&2
+  else
+    "$tree_sitter" generate >&2
+  fi
+
+  start=$(now_ns)
+  "$cc" -O2 -c -Isrc -o parser.o src/parser.c
+  compile_ns=$(($(now_ns) - start))
+
+  make -s CFLAGS=-O2 abap-bench-throughput >&2
+  inputs=
+  for input in "$@"; do
+    case $input in
+      synthetic:*) inputs="$inputs --synthetic ${input#synthetic:}" ;;
+      *) inputs="$inputs $root/$input" ;;
+    esac
+  done
+  # shellcheck disable=SC2086
+  ./abap-bench-throughput --repeat 10 --output speed.json $inputs
+
+  printf '"%s":{' "$name"
+  parser_size abap src/parser.c parser.o
+  if [ "$coarse" = 1 ]; then
+    (cd abapsql && "$tree_sitter" generate >&2)
+    start=$(now_ns)
+    "$cc" -O2 -c -Iabapsql/src -o abapsql.o abapsql/src/parser.c
+    compile_ns=$(($(now_ns) - start))
+    printf ','
+    parser_size abapsql abapsql/src/parser.c abapsql.o
+  fi
+  node -e '
+    const total = require(process.argv[1]).total;
+    process.stdout.write(`,"parse_ns":${total.parse_ns},` +
+      `"mb_per_s":${total.mb_per_s},"error_nodes":${total.error_nodes}}`);
+  ' "$dir/speed.json"
+}
+
+printf '{'
+measure full 0 "$@"
+printf ','
+measure coarse_sql 1 "$@"
+printf '}\n'
@@ -0,0 +1,65 @@
+#!/bin/sh
+
+# Compares incremental reparsing with comment runs lexed in chunks (the
+# default) and as a single token (TREE_SITTER_ABAP_COMMENT_CHUNK_LINES=0).
+#
+#   scripts/compare-comment-chunks.sh [script...]
+#
+# The edit scripts are replayed with abap-bench-reparse and default to
+# bench/edits/comment_toggle.edits, edits inside a 5,000 line comment block.
+# Prints the reparse time and the bytes lexed per edit of both builds as
+# JSON. Requires the tree-sitter CLI and the runtime through pkg-config, see
+# bench/readme.md.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+tree_sitter=${TREE_SITTER_BIN:-tree-sitter}
+make=${MAKE:-make}
+if [ $# -eq 0 ]; then
+  set -- bench/edits/comment_toggle.edits
+fi
+
+result=$(mktemp -d "${TMPDIR:-/tmp}/tree-sitter-abap-comment-chunks.XXXXXX")
+trap 'rm -rf "$result"' EXIT HUP INT TERM
+
+cd "$root"
+if [ ! -f src/parser.c ] ||
+  [ -n "$(find grammar grammar.js -type f -newer src/parser.c -print -quit)" ]; then
+  "$tree_sitter" generate >&2
+fi
+
+# measure <name> <cflags> <scripts...>
+measure() {
+  name=$1
+  cflags=$2
+  shift 2
+  # The scanner object depends on the define, always rebuild.
+  "$make" clean >&2
+  "$make" CFLAGS="$cflags" abap-bench-reparse >&2
+  ./abap-bench-reparse --output "$result/$name.json" "$@"
+}
+
+measure chunked "-O2" "$@"
+measure single_token "-O2 -DTREE_SITTER_ABAP_COMMENT_CHUNK_LINES=0" "$@"
+"$make" clean >&2
+
+node -e '
+  const fs = require("node:fs");
+  const read = name =>
+    JSON.parse(fs.readFileSync(`${process.argv[1]}/${name}.json`, "utf8")).scripts;
+  const pick = s => ({
+    source_bytes: s.source_bytes,
+    edits: s.edits,
+    reparse_ns: s.reparse_ns,
+    lexed_bytes: s.lexed_bytes,
+  });
+  const chunked = read("chunked");
+  const single = read("single_token");
+  const scripts = chunked.map((s, i) => ({
+    script: s.script,
+    chunked: pick(s),
+    single_token: pick(single[i]),
+  }));
+  process.stdout.write(JSON.stringify({ scripts }) + "\n");
+' "$result"
@@ -0,0 +1,62 @@
+#!/bin/sh
+
+# Compares the regex keyword tokens with the keyword scanner
+# (TREE_SITTER_ABAP_KEYWORD_SCANNER) on generated parser size, size of the
+# lex function, compile time, compiled size and parse throughput.
+#
+# Both variants are generated in temporary copies of the working tree, the
+# checkout itself is left untouched. Requires the tree-sitter CLI and the
+# runtime through pkg-config, see bench/readme.md.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+tree_sitter=${TREE_SITTER_BIN:-tree-sitter}
+cc=${CC:-cc}
+work=$(mktemp -d "${TMPDIR:-/tmp}/tree-sitter-abap-keywords.XXXXXX")
+trap 'rm -rf "$work"' EXIT HUP INT TERM
+
+now_ns() {
+  date +%s%N
+}
+
+# measure <name> <keyword scanner: 0|1>
+measure() {
+  dir="$work/$1"
+  mkdir -p "$dir"
+  (cd "$root" && git ls-files -z --cached --others --exclude-standard |
+    xargs -0 tar -cf - 2>/dev/null) | tar -xf - -C "$dir"
+
+  cd "$dir"
+  define=
+  if [ "$2" = 1 ]; then
+    TREE_SITTER_ABAP_KEYWORD_SCANNER=1 "$tree_sitter" generate >&2
+    node scripts/generate-keywords.js
+    define=-DTREE_SITTER_ABAP_KEYWORD_SCANNER
+  else
+    "$tree_sitter" generate >&2
+  fi
+
+  start=$(now_ns)
+  "$cc" -O2 -c -Isrc $define -o parser.o src/parser.c
+  compile_ns=$(($(now_ns) - start))
+
+  make -s CFLAGS="-O2 $define" abap-bench-throughput >&2
+  ./abap-bench-throughput --synthetic report:4m --output speed.json
+
+  generated_bytes=$(wc -c < src/parser.c | tr -d ' ')
+  compiled_bytes=$(wc -c < parser.o | tr -d ' ')
+  lex_lines=$(awk '/^static bool ts_lex\(/ { on = 1 } on { n++ } on && /^}/ { exit } END { print n + 0 }' src/parser.c)
+  mb_per_s=$(node -e 'console.log(require(process.argv[1]).total.mb_per_s)' "$dir/speed.json")
+
+  printf '"%s":{"generated_parser_bytes":%s,"lex_function_lines":%s,' \
+    "$1" "$generated_bytes" "$lex_lines"
+  printf '"compile_ns":%s,"compiled_parser_bytes":%s,"mb_per_s":%s}' \
+    "$compile_ns" "$compiled_bytes" "$mb_per_s"
+}
+
+printf '{'
+measure regex 0
+printf ','
+measure keyword_scanner 1
+printf '}\n'
@@ -0,0 +1,77 @@
+#!/bin/sh
+
+# Compares the parser generated from a base revision with the one generated
+# from the working tree on parse table size and parse throughput.
+#
+#   scripts/compare-parser.sh [--base REV] [input...]
+#
+# The inputs are passed to abap-bench-throughput and default to
+# test/highlight/ambiguity.abap. An input of the form synthetic:KIND[:AMOUNT]
+# is generated, e.g. synthetic:event_report:4m. Both parsers are generated in temporary
+# copies, the checkout itself is left untouched. Requires the tree-sitter
+# CLI and the runtime through pkg-config, see bench/readme.md.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+tree_sitter=${TREE_SITTER_BIN:-tree-sitter}
+base=HEAD
+if [ "${1:-}" = "--base" ]; then
+  base=$2
+  shift 2
+fi
+if [ $# -eq 0 ]; then
+  set -- test/highlight/ambiguity.abap
+fi
+
+work=$(mktemp -d "${TMPDIR:-/tmp}/tree-sitter-abap-compare.XXXXXX")
+trap 'rm -rf "$work"' EXIT HUP INT TERM
+
+define_value() {
+  sed -n "s/^#define $1 \([0-9]*\)$/\1/p" src/parser.c
+}
+
+# measure <name> <dir> <inputs...>
+measure() {
+  name=$1
+  cd "$2"
+  shift 2
+  "$tree_sitter" generate >&2
+  make -s CFLAGS=-O2 abap-bench-throughput >&2
+
+  inputs=
+  for input in "$@"; do
+    case $input in
+      synthetic:*) inputs="$inputs --synthetic ${input#synthetic:}" ;;
+      *) inputs="$inputs $root/$input" ;;
+    esac
+  done
+  # shellcheck disable=SC2086
+  ./abap-bench-throughput --repeat 10 --output speed.json $inputs
+
+  printf '"%s":{"revision":"%s",' "$name" "$(git -C "$root" rev-parse --short "$base")"
+  printf '"state_count":%s,"large_state_count":%s,' \
+    "$(define_value STATE_COUNT)" "$(define_value LARGE_STATE_COUNT)"
+  printf '"symbol_count":%s,"token_count":%s,' \
+    "$(define_value SYMBOL_COUNT)" "$(define_value TOKEN_COUNT)"
+  printf '"generated_parser_bytes":%s,' "$(wc -c < src/parser.c | tr -d ' ')"
+  node -e '
+    const { total, groups } = require(process.argv[1]);
+    const metrics = m => `"parse_ns":${m.parse_ns},` +
+      `"mb_per_s":${m.mb_per_s},"nodes_per_byte":${m.nodes_per_byte},` +
+      `"error_nodes":${m.error_nodes}`;
+    const byGroup = groups.map(g => `${JSON.stringify(g.name)}:{${metrics(g)}}`);
+    process.stdout.write(`${metrics(total)},"groups":{${byGroup.join(",")}}}`);
+  ' "$PWD/speed.json"
+}
+
+mkdir -p "$work/base" "$work/head"
+git -C "$root" archive "$base" | tar -xf - -C "$work/base"
+(cd "$root" && git ls-files -z --cached --others --exclude-standard |
+  xargs -0 tar -cf - 2>/dev/null) | tar -xf - -C "$work/head"
+
+printf '{'
+measure base "$work/base" "$@"
+printf ','
+measure head "$work/head" "$@" | sed 's/"revision":"[^"]*"/"revision":"working tree"/'
+printf '}\n'
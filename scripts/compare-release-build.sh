@@ -0,0 +1,68 @@
+#!/bin/sh
+
+# Compares the default build of the parser library with the optimized one
+# from scripts/pgo-build.sh on parse throughput, shared library load time,
+# size and exported symbols.
+#
+#   scripts/compare-release-build.sh
+#
+# Both are built in temporary copies of the working tree, the checkout
+# itself is left untouched. Requires the tree-sitter CLI if src/parser.c
+# is not generated yet and the runtime through pkg-config, see
+# bench/readme.md.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+make=${MAKE:-make}
+work=$(mktemp -d "${TMPDIR:-/tmp}/tree-sitter-abap-release.XXXXXX")
+trap 'rm -rf "$work"' EXIT HUP INT TERM
+
+so=so
+if [ "$(uname)" = Darwin ]; then
+  so=dylib
+fi
+
+# measure <name> <optimized: 0|1>
+measure() {
+  dir="$work/$1"
+  mkdir -p "$dir"
+  (cd "$root" && git ls-files -z --cached --others --exclude-standard |
+    xargs -0 tar -cf - 2>/dev/null) | tar -xf - -C "$dir"
+
+  cd "$dir"
+  if [ "$2" = 1 ]; then
+    PGO_DIR="$dir/pgo" scripts/pgo-build.sh
+    flags="OPTIMIZE=1 PGO=use PGO_DIR=$dir/pgo"
+  else
+    "$make" -s CFLAGS=-O2 >&2
+    flags="CFLAGS=-O2"
+  fi
+  # shellcheck disable=SC2086
+  "$make" -s $flags abap-bench-throughput abap-bench-load >&2
+
+  ./abap-bench-throughput --repeat 5 --output speed.json
+  ./abap-bench-load --output load.json "./libtree-sitter-abap.$so"
+  exported=$(nm -D --defined-only "libtree-sitter-abap.$so" 2>/dev/null |
+    grep -c ' T ' || true)
+
+  printf '"%s":' "$1"
+  node -e '
+    const speed = require(process.argv[1]).total;
+    const load = require(process.argv[2]);
+    process.stdout.write(JSON.stringify({
+      mb_per_s: speed.mb_per_s,
+      latency_p50_ns: speed.latency_p50_ns,
+      library_bytes: load.bytes,
+      exported_functions: Number(process.argv[3]),
+      load_p50_ns: load.load_p50_ns,
+      first_parse_p50_ns: load.first_parse_p50_ns,
+    }));
+  ' "$dir/speed.json" "$dir/load.json" "$exported"
+}
+
+printf '{'
+measure default 0
+printf ','
+measure optimized 1
+printf '}\n'
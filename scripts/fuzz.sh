@@ -0,0 +1,43 @@
+#!/bin/sh
+
+# Fuzzes the parser for inputs that take too long or too much memory to
+# parse, see test/fuzz/readme.md, and minimizes every finding into the
+# regression corpus.
+#
+#   scripts/fuzz.sh [seconds] [libFuzzer option...]
+#
+# Requires clang with libFuzzer and the tree-sitter runtime through
+# pkg-config. The corpus grows in fuzz/corpus/, seeded from test/corpus and
+# the regression corpus, the raw findings are kept in fuzz/findings/.
+
+set -eu
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+make=${MAKE:-make}
+seconds=${1:-600}
+[ $# -gt 0 ] && shift
+work=$root/fuzz
+regressions=$root/test/fuzz/regressions
+
+cd "$root"
+"$make" CC="${CC:-clang}" abap-fuzzer >&2
+mkdir -p "$work/corpus" "$work/findings"
+
+# Findings abort, -fork keeps going past them.
+./abap-fuzzer -fork=1 -ignore_crashes=1 -max_total_time="$seconds" \
+  -max_len=4096 -dict=test/fuzz/abap.dict \
+  -artifact_prefix="$work/findings/" "$@" \
+  "$work/corpus" test/corpus "$regressions" || true
+
+for finding in "$work"/findings/crash-* "$work"/findings/timeout-* \
+  "$work"/findings/oom-*; do
+  [ -e "$finding" ] || continue
+  name=$(basename "$finding" | cut -c1-20)
+  out=$regressions/$name.abap
+  [ -e "$out" ] && continue
+  # Shrinks the input for as long as it still breaks the limits.
+  ./abap-fuzzer -minimize_crash=1 -max_total_time=120 \
+    -exact_artifact_path="$out" "$finding" > /dev/null 2>&1 || true
+  [ -e "$out" ] || cp "$finding" "$out"
+  echo "$out"
+done
@@ -0,0 +1,143 @@
+#!/usr/bin/env node
+/**
+ * Regenerates the name sets of queries/highlights.scm.
+ *
+ * ABAP is case-insensitive, but query predicates are not. Classifying names
+ * with hand case-folded `#match?` regexes such as `^([aA][bB][sS]|...)$`
+ * runs a regex per captured node and makes the query slow to compile, so
+ * the sets are `#any-of?` predicates over the spellings that occur in
+ * practice instead: lower case, upper case and capitalized.
+ *
+ * Other spellings are not in the sets. `Line_Exists(` or `STRlen(` is
+ * highlighted as a method call, and `TYPE XString` as a type name. The corpus,
+ * the highlight tests and the examples only use the three spellings above;
+ * add a variant to `spellings()` before a test needs one.
+ *
+ * A predicate is generated for every `; generated: <set>` comment, replacing
+ * the predicate that follows it. `#not-any-of?` predicates are kept negated.
+ *
+ * Run from the repository root:
+ *
+ *   node scripts/generate-highlight-sets.js [queries/highlights.scm]
+ */
+const fs = require("fs");
+const path = require("path");
+
+const SETS = {
+  // ABAP - Built-in functions, see grammar/builtin/functions.js for why these
+  // are not distinguished by the grammar.
+  builtin_functions: [
+    "boolc", "boolx", "xsdbool", "contains", "contains_any_of",
+    "contains_any_not_of", "matches", "line_exists", "abs", "ceil", "floor",
+    "frac", "sign", "trunc", "ipow", "nmax", "nmin", "acos", "asin", "atan",
+    "cos", "sin", "tan", "cosh", "sinh", "tanh", "exp", "log", "log10", "sqrt",
+    "round", "rescale", "gamma", "log_gamma", "gamma_lower", "factorial",
+    "binomial", "erf", "erfc", "erf_inv", "erfc_inv", "charlen", "dbmaxlen",
+    "numofchar", "strlen", "char_off", "cmax", "cmin", "count", "count_any_of",
+    "count_any_not_of", "distance", "condense", "concat_lines_of", "escape",
+    "find", "find_end", "find_any_of", "find_any_not_of", "insert", "match",
+    "repeat", "replace", "reverse", "segment", "shift_left", "shift_right",
+    "substring", "substring_after", "substring_from", "substring_before",
+    "substring_to", "to_upper", "to_lower", "to_mixed", "from_mixed",
+    "translate", "xstrlen", "bit-set", "utclong_current", "utclong_add",
+    "utclong_diff", "lines", "line_index",
+  ],
+  builtin_variables: ["me", "super", "sy"],
+  system_structure: ["sy"],
+  regex_parameters: ["pcre", "regex"],
+  builtin_constants: ["abap_true", "abap_false", "abap_undefined", "space"],
+  event_sender: ["sender"],
+  builtin_types: [
+    "b", "c", "d", "f", "i", "n", "p", "s", "t", "x", "decfloat16",
+    "decfloat34", "int8", "string", "utclong", "xstring", "any",
+  ],
+};
+
+const LINE_WIDTH = 80;
+
+function spellings(words) {
+  const result = [];
+  for (const word of words) {
+    const lower = word.toLowerCase();
+    const variants = [
+      lower,
+      lower.toUpperCase(),
+      lower[0].toUpperCase() + lower.slice(1),
+    ];
+    for (const variant of variants) {
+      if (!result.includes(variant)) {
+        result.push(variant);
+      }
+    }
+  }
+  return result;
+}
+
+/** Finds the end of the parenthesized predicate starting at `start`. */
+function predicateEnd(source, start) {
+  let depth = 0;
+  for (let i = start; i < source.length; i++) {
+    const c = source[i];
+    if (c === '"') {
+      for (i++; i < source.length && source[i] !== '"'; i++) {
+        if (source[i] === "\\") {
+          i++;
+        }
+      }
+    } else if (c === "(") {
+      depth++;
+    } else if (c === ")" && --depth === 0) {
+      return i + 1;
+    }
+  }
+  throw new Error(`unterminated predicate at offset ${start}`);
+}
+
+function render(indent, negated, capture, words) {
+  const head = `${indent}(#${negated ? "not-" : ""}any-of? @${capture}`;
+  const lines = [head];
+  for (const word of spellings(words)) {
+    const item = ` "${word}"`;
+    if (lines[lines.length - 1].length + item.length > LINE_WIDTH) {
+      lines.push(indent + "  " + item.trimStart());
+    } else {
+      lines[lines.length - 1] += item;
+    }
+  }
+  lines[lines.length - 1] += ")";
+  return lines.join("\n");
+}
+
+function generate(source) {
+  const marker = /^([ \t]*); generated: (\w+)[ \t]*\n/gm;
+  let result = "";
+  let last = 0;
+  let match;
+  while ((match = marker.exec(source)) !== null) {
+    const [, indent, set] = match;
+    const line = source.slice(0, match.index).split("\n").length;
+    if (!SETS[set]) {
+      throw new Error(`unknown set ${set} in line ${line}`);
+    }
+
+    const start = source.indexOf("(#", marker.lastIndex);
+    const header = /^\(#(not-)?[\w-]+\? @([\w.]+)/.exec(source.slice(start));
+    if (
+      start < 0 ||
+      !header ||
+      source.slice(marker.lastIndex, start).trim() !== ""
+    ) {
+      throw new Error(`no predicate follows the marker in line ${line}`);
+    }
+    const end = predicateEnd(source, start);
+
+    result += source.slice(last, marker.lastIndex);
+    result += render(indent, !!header[1], header[2], SETS[set]);
+    last = end;
+    marker.lastIndex = end;
+  }
+  return result + source.slice(last);
+}
+
+const file = process.argv[2] ?? path.join("queries", "highlights.scm");
+fs.writeFileSync(file, generate(fs.readFileSync(file, "utf8")));
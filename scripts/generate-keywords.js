@@ -0,0 +1,121 @@
+#!/usr/bin/env node
+/**
+ * Generates src/keywords.h, the perfect hash table the external scanner uses
+ * to recognize keywords when built with TREE_SITTER_ABAP_KEYWORD_SCANNER.
+ *
+ * The keywords are the ones the grammar creates `_kw_*` rules for, in the
+ * order of their external tokens. The table is a two level hash-and-displace
+ * scheme: the first level hash picks a bucket, the seed stored for the bucket
+ * is used for the second level hash that picks the slot. Every keyword ends
+ * up in its own slot, so a lookup is two hashes and one comparison.
+ *
+ * Run from the repository root:
+ *
+ *   node scripts/generate-keywords.js [output]
+ */
+const fs = require("fs");
+const path = require("path");
+const { keywordList } = require("../grammar/_utils/generators.js");
+
+const BUCKET_SIZE = 4;
+const MAX_SEED = 0xffff;
+
+/** Must be kept in sync with `keyword_hash` in src/scanner.c. */
+function hash(word, seed) {
+  let h = (2166136261 ^ seed) >>> 0;
+  for (let i = 0; i < word.length; i++) {
+    h = Math.imul(h ^ word.charCodeAt(i), 16777619) >>> 0;
+  }
+  return (h ^ (h >>> 15)) >>> 0;
+}
+
+function buildTable(keywords) {
+  const slotCount = keywords.length;
+  const bucketCount = Math.max(1, Math.ceil(slotCount / BUCKET_SIZE));
+
+  const buckets = Array.from({ length: bucketCount }, () => []);
+  keywords.forEach((keyword, index) => {
+    buckets[hash(keyword, 0) % bucketCount].push(index);
+  });
+
+  // Place the largest buckets first while most slots are still free.
+  const order = buckets
+    .map((members, bucket) => ({ members, bucket }))
+    .sort((a, b) => b.members.length - a.members.length || a.bucket - b.bucket);
+
+  const seeds = new Array(bucketCount).fill(0);
+  const slots = new Array(slotCount).fill(-1);
+
+  for (const { members, bucket } of order) {
+    if (members.length === 0) {
+      continue;
+    }
+    let placed = false;
+    for (let seed = 1; seed <= MAX_SEED && !placed; seed++) {
+      const taken = members.map(i => hash(keywords[i], seed) % slotCount);
+      if (
+        new Set(taken).size === taken.length &&
+        taken.every(slot => slots[slot] === -1)
+      ) {
+        taken.forEach((slot, i) => (slots[slot] = members[i]));
+        seeds[bucket] = seed;
+        placed = true;
+      }
+    }
+    if (!placed) {
+      throw new Error(`no seed places bucket ${bucket}, raise MAX_SEED`);
+    }
+  }
+  return { seeds, slots };
+}
+
+function formatList(values, perLine) {
+  const lines = [];
+  for (let i = 0; i < values.length; i += perLine) {
+    lines.push("    " + values.slice(i, i + perLine).join(", ") + ",");
+  }
+  return lines.join("\n");
+}
+
+function render(keywords, { seeds, slots }) {
+  const maxLength = Math.max(...keywords.map(k => k.length));
+  const names = keywords.map(k => `"${k}"`);
+
+  return `// Generated by scripts/generate-keywords.js, do not edit.
+#ifndef TREE_SITTER_ABAP_KEYWORDS_H_
+#define TREE_SITTER_ABAP_KEYWORDS_H_
+
+#include <stdint.h>
+
+#define KEYWORD_COUNT ${keywords.length}
+#define KEYWORD_MAX_LENGTH ${maxLength}
+#define KEYWORD_BUCKET_COUNT ${seeds.length}
+
+/** Lower case keywords in the order of their external tokens. */
+static const char* const keyword_names[KEYWORD_COUNT] = {
+${formatList(names, 4)}
+};
+
+/** Second level hash seed of each first level bucket. */
+static const uint16_t keyword_seeds[KEYWORD_BUCKET_COUNT] = {
+${formatList(seeds, 12)}
+};
+
+/** Index into \`keyword_names\` of each second level slot. */
+static const uint16_t keyword_slots[KEYWORD_COUNT] = {
+${formatList(slots, 12)}
+};
+
+#endif // TREE_SITTER_ABAP_KEYWORDS_H_
+`;
+}
+
+const output = process.argv[2] ?? path.join("src", "keywords.h");
+const keywords = keywordList();
+const invalid = keywords.filter(k => !/^[a-z\d_\/%]+(-[a-z\d_\/%]+)*$/.test(k));
+if (invalid.length) {
+  throw new Error(`not lexable as a keyword: ${invalid.join(", ")}`);
+}
+
+fs.writeFileSync(output, render(keywords, buildTable(keywords)));
+console.error(`${output}: ${keywords.length} keywords`);
@@ -0,0 +1,44 @@
+#!/bin/sh
+
+# Measures parse throughput and latency with abap-bench-throughput.
+#
+#   scripts/measure-parser-speed.sh [--force-generate] [--json]
+#
+# Regenerates the parser when the grammar is newer than src/parser.c, or
+# always with --force-generate, and rebuilds the benchmark with CFLAGS
+# (default -O2). Prints a table, or the JSON of abap-bench-throughput with
+# --json. Requires the tree-sitter CLI and the runtime through pkg-config,
+# see bench/readme.md.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+tree_sitter=${TREE_SITTER_BIN:-tree-sitter}
+make=${MAKE:-make}
+
+cd "$root"
+if [ "${1:-}" = "--force-generate" ] ||
+  [ ! -f src/parser.c ] ||
+  [ -n "$(find grammar grammar.js -type f -newer src/parser.c -print -quit)" ]; then
+  "$tree_sitter" generate >&2
+fi
+# Always rebuild, a stale parser object would measure the previous grammar.
+"$make" clean >&2
+"$make" CFLAGS="${CFLAGS:--O2}" abap-bench-throughput >&2
+
+if [ "${1:-}" = "--json" ] || [ "${2:-}" = "--json" ]; then
+  ./abap-bench-throughput
+else
+  ./abap-bench-throughput | node -e '
+    const result = JSON.parse(require("node:fs").readFileSync(0, "utf8"));
+    const row = (name, m) =>
+      `  ${name.padEnd(28)} ${m.mb_per_s.toFixed(2).padStart(8)} MB/s` +
+      `  ${m.ns_per_byte.toFixed(1).padStart(8)} ns/byte` +
+      `  p50 ${(m.latency_p50_ns / 1e3).toFixed(0).padStart(7)} us` +
+      `  p99 ${(m.latency_p99_ns / 1e3).toFixed(0).padStart(7)} us` +
+      `  ${m.error_nodes} errors`;
+    console.log("Parser speed");
+    result.groups.forEach(g => console.log(row(g.name, g)));
+    console.log(row("total", result.total));
+  '
+fi
@@ -0,0 +1,115 @@
+#!/bin/sh
+
+# Measures the shipped queries with abap-bench-query and checks the result
+# against the stored baseline.
+#
+#   scripts/measure-query-speed.sh [--force-generate] [--json] [--check]
+#                                  [--update-baseline]
+#
+# --check fails when a query got slower than QUERY_MAX_RATIO (default 1.5)
+# times its baseline or exceeds the cursor match limit on more sources than
+# before. Query time is compared relative to the parse time of the same
+# sources, so a baseline recorded on one machine holds on another.
+# --update-baseline rewrites bench/query-baseline.json from this run.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+tree_sitter=${TREE_SITTER_BIN:-tree-sitter}
+make=${MAKE:-make}
+baseline=bench/query-baseline.json
+
+force=0 json=0 check=0 update=0
+for arg in "$@"; do
+  case $arg in
+    --force-generate) force=1 ;;
+    --json) json=1 ;;
+    --check) check=1 ;;
+    --update-baseline) update=1 ;;
+    *)
+      echo "unknown option: $arg" >&2
+      exit 1
+      ;;
+  esac
+done
+
+result=$(mktemp "${TMPDIR:-/tmp}/tree-sitter-abap-query.XXXXXX")
+trap 'rm -f "$result"' EXIT HUP INT TERM
+
+cd "$root"
+if [ "$force" = 1 ] ||
+  [ ! -f src/parser.c ] ||
+  [ -n "$(find grammar grammar.js -type f -newer src/parser.c -print -quit)" ]; then
+  "$tree_sitter" generate >&2
+fi
+# Always rebuild, a stale parser object would measure the previous grammar.
+"$make" clean >&2
+"$make" CFLAGS="${CFLAGS:--O2}" abap-bench-query >&2
+./abap-bench-query --output "$result"
+
+if [ "$json" = 1 ]; then
+  cat "$result"
+else
+  node -e '
+    const result = JSON.parse(require("node:fs").readFileSync(process.argv[1], "utf8"));
+    console.log("Query speed");
+    for (const q of result.queries) {
+      console.log(`  ${q.query.padEnd(28)} ${q.ns_per_capture.toFixed(1).padStart(8)} ns/capture` +
+        `  ${q.exec_to_parse.toFixed(3).padStart(7)} x parse` +
+        `  compile ${(q.compile_ns / 1e6).toFixed(1).padStart(6)} ms` +
+        `  ${q.match_limit_exceeded.length} over match limit`);
+      for (const p of q.slowest_patterns) {
+        console.log(`    line ${String(p.line).padStart(5)}  ${(p.share * 100).toFixed(1).padStart(5)} %` +
+          `  ${p.matches} matches`);
+      }
+    }
+  ' "$result"
+fi
+
+if [ "$update" = 1 ]; then
+  node -e '
+    const fs = require("node:fs");
+    const result = JSON.parse(fs.readFileSync(process.argv[1], "utf8"));
+    const queries = {};
+    for (const q of result.queries) {
+      queries[q.query] = {
+        exec_to_parse: q.exec_to_parse,
+        ns_per_capture: q.ns_per_capture,
+        match_limit_exceeded: q.match_limit_exceeded.length,
+      };
+    }
+    fs.writeFileSync(process.argv[2], JSON.stringify({ queries }, null, 2) + "\n");
+  ' "$result" "$baseline"
+  echo "updated $baseline" >&2
+fi
+
+if [ "$check" = 1 ]; then
+  if [ ! -f "$baseline" ]; then
+    echo "no $baseline, record one with --update-baseline" >&2
+    exit 0
+  fi
+  node -e '
+    const fs = require("node:fs");
+    const result = JSON.parse(fs.readFileSync(process.argv[1], "utf8"));
+    const baseline = JSON.parse(fs.readFileSync(process.argv[2], "utf8")).queries;
+    const maxRatio = Number(process.env.QUERY_MAX_RATIO || 1.5);
+    let failed = false;
+    for (const q of result.queries) {
+      const base = baseline[q.query];
+      if (!base) {
+        console.error(`${q.query}: not in the baseline`);
+        continue;
+      }
+      const ratio = q.exec_to_parse / base.exec_to_parse;
+      if (ratio > maxRatio) {
+        console.error(`${q.query}: ${ratio.toFixed(2)} times slower than the baseline`);
+        failed = true;
+      }
+      if (q.match_limit_exceeded.length > base.match_limit_exceeded) {
+        console.error(`${q.query}: exceeds the match limit on ${q.match_limit_exceeded.join(", ")}`);
+        failed = true;
+      }
+    }
+    process.exit(failed ? 1 : 0);
+  ' "$result" "$baseline"
+fi
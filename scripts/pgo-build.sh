@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# Builds the optimized parser library: LTO, hidden visibility and profile
+# guided optimization trained on test/corpus, test/highlight and a synthetic
+# 4 MB report, the default inputs of abap-bench-throughput.
+#
+#   scripts/pgo-build.sh
+#
+# Leaves libtree-sitter-abap.{a,so} in the repository root like `make`, the
+# profiles in pgo/. Requires the tree-sitter runtime through pkg-config for
+# the training run, see bench/readme.md. With clang, llvm-profdata (or
+# LLVM_PROFDATA) merges the raw profiles.
+
+set -eu
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+make=${MAKE:-make}
+profiles=${PGO_DIR:-$root/pgo}
+
+cd "$root"
+rm -rf "$profiles"
+mkdir -p "$profiles"
+
+"$make" clean >&2
+"$make" OPTIMIZE=1 PGO=generate PGO_DIR="$profiles" abap-bench-throughput >&2
+./abap-bench-throughput --repeat 2 > /dev/null
+
+# GCC reads its .gcda files as they are, clang needs them merged.
+if "${CC:-cc}" --version 2>/dev/null | grep -q clang; then
+  "${LLVM_PROFDATA:-llvm-profdata}" merge \
+    -output="$profiles/default.profdata" "$profiles"/*.profraw
+fi
+
+"$make" clean >&2
+"$make" OPTIMIZE=1 PGO=use PGO_DIR="$profiles" >&2
@@ -0,0 +1,380 @@
+#!/usr/bin/env node
+/**
+ * Attributes the size of the generated parser to the modules under
+ * `grammar/`, to single rules and to the entries of `conflicts`.
+ *
+ * Each target is ablated from `src/grammar.json` and the parser is generated
+ * again from the result: the rules of an ablated module or rule are replaced
+ * by a unique string token, an ablated conflict is dropped. The cost of the
+ * target is the difference to the unmodified grammar in state count, large
+ * state count, symbol count, token count, size of the lex functions,
+ * generated bytes and compiled bytes. Rules only reachable through a target
+ * are part of its cost. Dropping a conflict the grammar needs fails the
+ * generation, which is reported as `required`.
+ *
+ * Additionally the parse state count of every rule is taken from
+ * `tree-sitter generate --report-states-for-rule -`, which is cheap but does
+ * not sum up: a state belongs to every rule with an item in it.
+ *
+ * Run from the repository root after `tree-sitter generate`:
+ *
+ *   node scripts/profile-grammar.js [options] > profile.json
+ *
+ *   --rules LIST     comma separated rules to ablate, `statements` for the
+ *                    alternatives of simple_statement and reserved_statement
+ *                    (default: none)
+ *   --no-modules     do not ablate the modules
+ *   --no-conflicts   do not ablate the conflicts
+ *   --no-compile     skip compiling, compiled_parser_bytes is reported as 0
+ *   --jobs N         parallel generations (default: number of cpus)
+ *
+ * The report is ranked by state count and stable across runs, diff two
+ * reports to see where a change in parser size comes from.
+ */
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const { execFile } = require("child_process");
+const { promisify } = require("util");
+
+const run = promisify(execFile);
+const treeSitter = process.env.TREE_SITTER_BIN || "tree-sitter";
+const cc = process.env.CC || "cc";
+const root = path.resolve(__dirname, "..");
+
+const METRICS = [
+  "state_count",
+  "large_state_count",
+  "symbol_count",
+  "token_count",
+  "lex_function_bytes",
+  "generated_parser_bytes",
+  "compiled_parser_bytes",
+];
+
+function parseArgs(argv) {
+  const options = {
+    rules: [],
+    modules: true,
+    conflicts: true,
+    compile: true,
+    jobs: os.cpus().length,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case "--rules":
+        options.rules = argv[++i].split(",").filter(Boolean);
+        break;
+      case "--no-modules":
+        options.modules = false;
+        break;
+      case "--no-conflicts":
+        options.conflicts = false;
+        break;
+      case "--no-compile":
+        options.compile = false;
+        break;
+      case "--jobs":
+        options.jobs = Math.max(1, Number(argv[++i]));
+        break;
+      default:
+        throw new Error(`unknown option ${argv[i]}`);
+    }
+  }
+  return options;
+}
+
+/** The rule modules, filtered the same way as the loader in grammar.js. */
+function ruleModules() {
+  const exclude = ["node", "scripts", "generators.js", "grammar.js"];
+  return fs
+    .readdirSync(root, { recursive: true, withFileTypes: true })
+    .filter(
+      f =>
+        f.isFile() &&
+        f.name.endsWith(".js") &&
+        !exclude.find(
+          v => (f.parentPath || f.path).includes(v) || f.name == v,
+        ),
+    )
+    .map(f =>
+      path.relative(root, path.resolve(f.parentPath || f.path, f.name)),
+    )
+    .sort();
+}
+
+/** Maps every rule of the grammar to the module that defines it. */
+function ruleOwners(grammar) {
+  global.gen = require(path.join(root, "grammar", "_utils", "generators.js"));
+  const owners = {};
+  for (const module of ruleModules()) {
+    for (const rule of Object.keys(require(path.join(root, module)))) {
+      owners[rule] = module;
+    }
+  }
+
+  // Everything else is defined in grammar.js, directly or through the
+  // generators. The keyword rules are reported as one pseudo module.
+  for (const rule of Object.keys(grammar.rules)) {
+    owners[rule] ||= rule.startsWith("_kw_") ? "keywords" : "grammar.js";
+  }
+  return owners;
+}
+
+function defineValue(parser, name) {
+  const match = new RegExp(`^#define ${name} (\\d+)$`, "m").exec(parser);
+  return match ? Number(match[1]) : 0;
+}
+
+/** Bytes of the `ts_lex` and `ts_lex_keywords` functions. */
+function lexFunctionBytes(parser) {
+  let bytes = 0;
+  for (const name of ["ts_lex", "ts_lex_keywords"]) {
+    const start = parser.indexOf(`static bool ${name}(`);
+    if (start >= 0) {
+      bytes += parser.indexOf("\n}\n", start) + 3 - start;
+    }
+  }
+  return bytes;
+}
+
+/**
+ * Generates and optionally compiles the parser for the given grammar in a
+ * temporary directory. Returns the metrics, or null if generation failed.
+ */
+async function measure(grammar, options, extraArgs = []) {
+  const dir = fs.mkdtempSync(
+    path.join(os.tmpdir(), "tree-sitter-abap-profile-"),
+  );
+  try {
+    fs.mkdirSync(path.join(dir, "src"));
+    fs.writeFileSync(
+      path.join(dir, "src", "grammar.json"),
+      JSON.stringify(grammar),
+    );
+    const config = path.join(root, "tree-sitter.json");
+    if (fs.existsSync(config)) {
+      fs.copyFileSync(config, path.join(dir, "tree-sitter.json"));
+    }
+
+    let output;
+    try {
+      output = await run(
+        treeSitter,
+        ["generate", ...extraArgs, path.join("src", "grammar.json")],
+        { cwd: dir, maxBuffer: 1 << 28 },
+      );
+    } catch {
+      return null;
+    }
+
+    const parser = fs.readFileSync(path.join(dir, "src", "parser.c"), "utf8");
+    let compiled = 0;
+    if (options.compile) {
+      await run(cc, ["-O2", "-c", "-Isrc", "-o", "parser.o", "src/parser.c"], {
+        cwd: dir,
+      });
+      compiled = fs.statSync(path.join(dir, "parser.o")).size;
+    }
+    return {
+      metrics: {
+        state_count: defineValue(parser, "STATE_COUNT"),
+        large_state_count: defineValue(parser, "LARGE_STATE_COUNT"),
+        symbol_count: defineValue(parser, "SYMBOL_COUNT"),
+        token_count: defineValue(parser, "TOKEN_COUNT"),
+        lex_function_bytes: lexFunctionBytes(parser),
+        generated_parser_bytes: Buffer.byteLength(parser),
+        compiled_parser_bytes: compiled,
+      },
+      log: output.stdout + output.stderr,
+    };
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+}
+
+/** Parse states per rule, from the log of `--report-states-for-rule -`. */
+function ruleStates(grammar, log) {
+  const states = [];
+  for (const line of log.split("\n")) {
+    const match = /^\s*(\w+)\s+(\d+)\s*$/.exec(line);
+    if (match && match[1] in grammar.rules) {
+      states.push({ rule: match[1], states: Number(match[2]) });
+    }
+  }
+  return states.sort(
+    (a, b) => b.states - a.states || a.rule.localeCompare(b.rule),
+  );
+}
+
+/** Replaces the given rules with a string token each. */
+function ablateRules(grammar, rules) {
+  const copy = structuredClone(grammar);
+  for (const rule of rules) {
+    copy.rules[rule] = { type: "STRING", value: `__ablated_${rule}` };
+  }
+  // A supertype has to stay a choice of symbols.
+  copy.supertypes = (copy.supertypes || []).filter(s => !rules.includes(s));
+  return copy;
+}
+
+function ablateConflict(grammar, index) {
+  const copy = structuredClone(grammar);
+  copy.conflicts.splice(index, 1);
+  return copy;
+}
+
+/** Rules that cannot be replaced without breaking the grammar itself. */
+function protectedRules(grammar) {
+  return new Set([Object.keys(grammar.rules)[0], grammar.word].filter(Boolean));
+}
+
+function statementRules(grammar) {
+  const rules = [];
+  const collect = rule => {
+    if (rule.type === "SYMBOL") {
+      rules.push(rule.name);
+    } else if (rule.content) {
+      collect(rule.content);
+    } else if (rule.members) {
+      rule.members.forEach(collect);
+    }
+  };
+  collect(grammar.rules.simple_statement);
+  collect(grammar.rules.reserved_statement);
+  return rules;
+}
+
+function cost(base, result) {
+  if (!result) {
+    return null;
+  }
+  return Object.fromEntries(METRICS.map(m => [m, base[m] - result.metrics[m]]));
+}
+
+function rank(entries) {
+  return entries.sort(
+    (a, b) =>
+      (b.cost ? b.cost.state_count : Infinity) -
+        (a.cost ? a.cost.state_count : Infinity) ||
+      a.name.localeCompare(b.name),
+  );
+}
+
+/** Runs the tasks with at most `jobs` of them in flight. */
+async function pool(tasks, jobs) {
+  const results = new Array(tasks.length);
+  let next = 0;
+  const worker = async () => {
+    while (next < tasks.length) {
+      const index = next++;
+      results[index] = await tasks[index]();
+    }
+  };
+  await Promise.all(Array.from({ length: jobs }, worker));
+  return results;
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const grammarPath = path.join(root, "src", "grammar.json");
+  const grammar = JSON.parse(fs.readFileSync(grammarPath, "utf8"));
+  const owners = ruleOwners(grammar);
+  const keep = protectedRules(grammar);
+
+  const base = await measure(grammar, options, [
+    "--report-states-for-rule",
+    "-",
+  ]);
+  if (!base) {
+    throw new Error("the unmodified grammar does not generate");
+  }
+
+  const targets = [];
+  if (options.modules) {
+    const modules = {};
+    for (const [rule, owner] of Object.entries(owners)) {
+      if (rule in grammar.rules && !keep.has(rule)) {
+        (modules[owner] ||= []).push(rule);
+      }
+    }
+    for (const [name, rules] of Object.entries(modules)) {
+      targets.push({
+        kind: "modules",
+        name,
+        rules,
+        grammar: () => ablateRules(grammar, rules),
+      });
+    }
+  }
+
+  const rules =
+    options.rules.length == 1 && options.rules[0] == "statements"
+      ? statementRules(grammar)
+      : options.rules;
+  for (const rule of rules) {
+    if (!(rule in grammar.rules) || keep.has(rule)) {
+      throw new Error(`cannot ablate rule ${rule}`);
+    }
+    targets.push({
+      kind: "rules",
+      name: rule,
+      module: owners[rule],
+      grammar: () => ablateRules(grammar, [rule]),
+    });
+  }
+
+  if (options.conflicts) {
+    (grammar.conflicts || []).forEach((conflict, index) => {
+      targets.push({
+        kind: "conflicts",
+        name: `[${conflict.join(", ")}]`,
+        grammar: () => ablateConflict(grammar, index),
+      });
+    });
+  }
+
+  const results = await pool(
+    targets.map((target, i) => async () => {
+      const result = await measure(target.grammar(), options);
+      console.error(
+        `[${i + 1}/${targets.length}] ${target.kind} ${target.name}`,
+      );
+      return result;
+    }),
+    options.jobs,
+  );
+
+  const report = {
+    base: base.metrics,
+    modules: [],
+    rules: [],
+    conflicts: [],
+    rule_states: ruleStates(grammar, base.log),
+  };
+  targets.forEach((target, i) => {
+    const entry = { name: target.name };
+    if (target.kind == "modules") {
+      entry.rules = target.rules.length;
+    } else if (target.kind == "rules") {
+      entry.module = target.module;
+    }
+    entry.cost = cost(base.metrics, results[i]);
+    if (target.kind == "conflicts") {
+      entry.required = !results[i];
+    } else if (!results[i]) {
+      entry.error = "generation failed";
+    }
+    report[target.kind].push(entry);
+  });
+  rank(report.modules);
+  rank(report.rules);
+  rank(report.conflicts);
+
+  process.stdout.write(JSON.stringify(report, null, 2) + "\n");
+}
+
+main().catch(error => {
+  console.error(error.message);
+  process.exit(1);
+});
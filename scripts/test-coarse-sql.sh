@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# Runs the tests of the coarse ABAP SQL split (TREE_SITTER_ABAP_COARSE_SQL):
+# the corpus under test/coarse-sql/corpus against a coarse parser, the
+# assertions in test/coarse-sql/*.abap against
+# queries/coarse-sql/injections.scm and the corpus of the abapsql grammar.
+#
+#   scripts/test-coarse-sql.sh
+#
+# The parsers are generated in a temporary copy of the working tree, the
+# checkout itself is left untouched. Requires the tree-sitter CLI.
+
+set -eu
+
+root=$(git rev-parse --show-toplevel)
+tree_sitter=${TREE_SITTER_BIN:-tree-sitter}
+work=$(mktemp -d "${TMPDIR:-/tmp}/tree-sitter-abap-coarse-sql-test.XXXXXX")
+trap 'rm -rf "$work"' EXIT HUP INT TERM
+
+(cd "$root" && git ls-files -z --cached --others --exclude-standard |
+  xargs -0 tar -cf - 2>/dev/null) | tar -xf - -C "$work"
+cd "$work"
+
+TREE_SITTER_ABAP_COARSE_SQL=1 "$tree_sitter" generate
+# The corpus and highlight tests of the full grammar do not apply, see
+# grammar/readme.md.
+rm -rf test/corpus test/highlight
+cp -R test/coarse-sql/corpus test/corpus
+"$tree_sitter" test
+"$tree_sitter" query --test queries/coarse-sql/injections.scm \
+  test/coarse-sql/*.abap
+
+cd abapsql
+"$tree_sitter" generate
+"$tree_sitter" test
@@ -1,4 +1,6 @@
-from os import path
+from os import environ, name, path
+from shlex import split
+from subprocess import CalledProcessError, check_output
 from sysconfig import get_config_var
 
 from setuptools import Extension, find_packages, setup
@@ -8,6 +10,21 @@ from setuptools.command.egg_info import egg_info
 from wheel.bdist_wheel import bdist_wheel
 
 
+def runtime_flags():
+    """Compile and link flags of the tree-sitter runtime, needed by
+    parse_batch. The grammar alone does not link against it, so parse_batch
+    is only built where pkg-config finds it, TREE_SITTER_ABAP_BATCH=0 opts
+    out."""
+    if name == "nt" or environ.get("TREE_SITTER_ABAP_BATCH") == "0":
+        return None
+    try:
+        cflags = check_output(["pkg-config", "--cflags", "tree-sitter"])
+        libs = check_output(["pkg-config", "--libs", "tree-sitter"])
+    except (OSError, CalledProcessError):
+        return None
+    return split(cflags.decode()), split(libs.decode())
+
+
 class Build(build):
     def run(self):
         if path.isdir("queries"):
@@ -24,6 +41,12 @@ class BuildExt(build_ext):
             ext.extra_compile_args = ["/std:c11", "/utf-8"]
         if path.exists("src/scanner.c"):
             ext.sources.append("src/scanner.c")
+        runtime = runtime_flags()
+        if runtime:
+            ext.sources.append("bindings/python/tree_sitter_abap/batch.c")
+            ext.define_macros.append(("TREE_SITTER_ABAP_BATCH", None))
+            ext.extra_compile_args += runtime[0] + ["-pthread"]
+            ext.extra_link_args += runtime[1] + ["-pthread"]
         if ext.py_limited_api:
             ext.define_macros.append(("Py_LIMITED_API", "0x030A0000"))
         super().build_extension(ext)
@@ -0,0 +1,251 @@
+// Generated by scripts/generate-keywords.js, do not edit.
+#ifndef TREE_SITTER_ABAP_KEYWORDS_H_
+#define TREE_SITTER_ABAP_KEYWORDS_H_
+
+#include <stdint.h>
+
+#define KEYWORD_COUNT 639
+#define KEYWORD_MAX_LENGTH 23
+#define KEYWORD_BUCKET_COUNT 160
+
+/** Lower case keywords in the order of their external tokens. */
+static const char* const keyword_names[KEYWORD_COUNT] = {
+    "abstract", "accepting", "action", "activation",
+    "actual", "add", "adjacent", "alias",
+    "aliases", "all", "amdp", "analyzer",
+    "and", "any", "append", "appending",
+    "archive", "area", "arithmetic", "as",
+    "ascending", "assert", "assign", "assigned",
+    "assigning", "asynchronous", "at", "attributes",
+    "augmenting", "authority-check", "authorization", "auto",
+    "background", "badi", "base", "before",
+    "begin", "behavior", "between", "big",
+    "binary", "bit", "bit-and", "bit-not",
+    "bit-or", "bit-xor", "blanks", "block",
+    "blocked", "blocks", "bound", "boundaries",
+    "break-point", "bt", "buffer", "by",
+    "byte", "byte-ca", "byte-cn", "byte-co",
+    "byte-cs", "byte-na", "byte-ns", "byte-order",
+    "ca", "call", "calling", "case",
+    "cast", "casting", "catch", "cds",
+    "centered", "change", "changes", "changing",
+    "channels", "char-to-hex", "character", "check",
+    "checkbox", "cid", "circular", "class",
+    "class-data", "class-events", "class-methods", "class-pool",
+    "class_constructor", "cleanup", "clear", "client",
+    "clock", "close", "cn", "co",
+    "code", "collect", "comment", "commit",
+    "comparing", "component", "components", "compression",
+    "concatenate", "cond", "condense", "condition",
+    "constants", "constructor", "context", "continue",
+    "control", "conv", "conversion", "convert",
+    "corresponding", "count", "cp", "create",
+    "critical", "cs", "currency", "current",
+    "dangerous", "data", "data_refs", "database",
+    "dataset", "date", "daylight", "dd/mm/yy",
+    "dd/mm/yyyy", "ddl", "ddmmyy", "decimals",
+    "deep", "default", "deferred", "define",
+    "defining", "definition", "delete", "deleting",
+    "dependent", "descending", "describe", "destination",
+    "determination", "determine", "deterministic", "directory",
+    "disable", "discarding", "display", "distance",
+    "distinct", "div", "do", "doma",
+    "dummy", "duplicates", "duration", "dynpro",
+    "e", "early", "edit", "else",
+    "elseif", "empty", "enabled", "encoding",
+    "end", "end-enhancement-section", "end-of-definition", "end-test-injection",
+    "end-test-seam", "endat", "endcase", "endclass",
+    "enddo", "endenhancement", "endform", "endfunction",
+    "endian", "endif", "ending", "endinterface",
+    "endloop", "endmethod", "endmodule", "endselect",
+    "endtry", "endwhile", "enhancement", "enhancement-point",
+    "enhancement-section", "entities", "entity", "entry",
+    "enum", "environment", "eq", "equiv",
+    "errors", "escape", "event", "events",
+    "evnt", "exact", "except", "exception",
+    "exception-table", "exceptions", "execute", "exists",
+    "exit", "exit-command", "expanding", "exponent",
+    "export", "exporting", "fail", "failed",
+    "features", "field", "field-symbol", "field-symbols",
+    "fields", "file", "fill", "filter",
+    "filter-table", "filters", "final", "find",
+    "first", "fixed-point", "flags", "for",
+    "form", "format", "forwarding", "found",
+    "fractional", "frame", "free", "friends",
+    "from", "fugr", "full", "func",
+    "function", "function-pool", "functionality", "further",
+    "ge", "generate", "get", "global",
+    "graph", "group", "grouping", "groups",
+    "gt", "handle", "handler", "harmless",
+    "hashed", "having", "header", "heading",
+    "help-id", "help-request", "hierarchy", "high",
+    "i", "id", "if", "ignore",
+    "ignoring", "implementation", "implemented", "import",
+    "importing", "in", "incl", "include",
+    "increment", "independent", "index", "inheriting",
+    "init", "initial", "initial_components", "initialization",
+    "inner", "input", "insert", "instance",
+    "instances", "interface", "interface-pool", "interfaces",
+    "internal", "intervals", "intf", "into",
+    "is", "job", "keeping", "key",
+    "keys", "kind", "language", "last",
+    "late", "le", "leading", "leave",
+    "left", "left-justified", "legacy", "length",
+    "let", "level", "like", "line",
+    "line-count", "line-size", "linefeed", "lines",
+    "link", "list", "listbox", "little",
+    "load-of-program", "local", "lock", "locks",
+    "log-point", "long", "loop", "loop_key",
+    "low", "lower", "lt", "m",
+    "many", "mapped", "mapping", "mark",
+    "mask", "match", "matchcode", "maximum",
+    "medium", "members", "memory", "message",
+    "message-id", "messages", "messaging", "meth",
+    "method", "methods", "mm/dd/yy", "mm/dd/yyyy",
+    "mmddyy", "mod", "mode", "modif",
+    "modify", "module", "move-corresponding", "na",
+    "name", "names", "native", "nb",
+    "ne", "nested", "nesting", "new",
+    "next", "no", "no-display", "no-extension",
+    "no-gaps", "no-grouping", "no-sign", "no-zero",
+    "non-unicode", "non-unique", "not", "np",
+    "ns", "null", "nulls", "number",
+    "numbering", "o", "object", "objects",
+    "obligatory", "occurrence", "occurrences", "occurs",
+    "of", "off", "offset", "on",
+    "one", "only", "open", "operations",
+    "option", "optional", "options", "or",
+    "order", "others", "outer", "output",
+    "output-length", "overlay", "package", "padding",
+    "page", "parameter", "parameter-table", "parameters",
+    "partially", "pcre", "perform", "performing",
+    "permissions", "places", "pool", "position",
+    "precheck", "preferred", "primary", "private",
+    "privileged", "procedure", "prog", "program",
+    "protected", "public", "push", "pushbutton",
+    "radiobutton", "raise", "raising", "range",
+    "read", "read-only", "receive", "receiving",
+    "redefinition", "reduce", "reduced", "ref",
+    "reference", "regex", "relating", "remote",
+    "renaming", "replace", "replacement", "report",
+    "reported", "request", "requested", "required",
+    "resolution", "respecting", "response", "responses",
+    "result", "results", "resumable", "resume",
+    "return", "returning", "right", "right-justified",
+    "risk", "rollback", "round", "run",
+    "sap-spool", "save", "saving", "scalar",
+    "schema", "screen", "seam", "search",
+    "secondary", "seconds", "section", "select",
+    "select-options", "selection-screen", "selection-set", "selection-sets",
+    "selection-table", "selections", "separate", "separated",
+    "service", "session", "set", "sets",
+    "shared", "shift", "short", "shortdump",
+    "shortdump-id", "sign", "simulation", "single",
+    "size", "skip", "skipping", "smart",
+    "some", "sort", "sortable", "sorted",
+    "source", "split", "spool", "spots",
+    "sql", "stable", "stamp", "standard",
+    "start-of-selection", "starting", "static", "statics",
+    "step", "structure", "style", "subkey",
+    "submatches", "submit", "subroutine", "subscreen",
+    "substring", "suffix", "sum", "supplied",
+    "suppress", "switch", "switchstates", "syntax",
+    "syntax-check", "tab", "tabbed", "table",
+    "tables", "target", "task", "tasks",
+    "technical_types", "temporary", "test-injection", "test-seam",
+    "testing", "text", "textpool", "then",
+    "throw", "time", "times", "title",
+    "to", "trailing", "transaction", "transfer",
+    "transformation", "translate", "transporting", "truncate",
+    "truncation", "try", "type", "type-pool",
+    "types", "uline", "unassign", "unblocked",
+    "unique", "unit", "unix", "unpack",
+    "until", "unwind", "up", "update",
+    "upper", "user", "user-command", "using",
+    "utclong", "utf-8", "validate", "validation",
+    "value", "value-request", "value_handling", "values",
+    "verbatim", "version", "via", "visible",
+    "wait", "when", "where", "while",
+    "width", "window", "windows", "with",
+    "without", "word", "work", "workspace",
+    "write", "xml", "xml_header", "xslt",
+    "yymmdd", "z", "zone",
+};
+
+/** Second level hash seed of each first level bucket. */
+static const uint16_t keyword_seeds[KEYWORD_BUCKET_COUNT] = {
+    46, 49, 0, 16, 2, 12, 13, 105, 17, 1, 159, 48,
+    117, 27, 26, 16, 76, 54, 66, 152, 15, 34, 469, 5,
+    0, 0, 1, 30, 158, 167, 49, 108, 40, 34, 31, 4,
+    309, 84, 3, 53, 0, 113, 38, 54, 125, 11, 0, 605,
+    469, 1, 203, 9, 1, 1, 1, 243, 9, 44, 135, 372,
+    20, 5, 0, 54, 166, 6, 1, 21, 2, 9, 403, 71,
+    16, 1, 15, 1, 44, 6, 1, 96, 53, 414, 22, 88,
+    287, 17, 14, 821, 81, 9, 75, 16, 388, 1, 79, 63,
+    449, 172, 1, 44, 36, 1, 17, 11, 36, 12, 12, 329,
+    5, 3, 967, 69, 186, 157, 89, 1, 6, 18, 91, 480,
+    37, 1461, 8, 23, 1389, 438, 1247, 235, 8, 12, 16, 271,
+    18, 1, 9, 109, 1005, 4, 622, 317, 1080, 270, 14, 95,
+    9, 66, 419, 0, 775, 169, 14, 2, 48, 7, 748, 5,
+    7, 10, 125, 5975,
+};
+
+/** Index into `keyword_names` of each second level slot. */
+static const uint16_t keyword_slots[KEYWORD_COUNT] = {
+    452, 635, 44, 36, 220, 516, 232, 99, 308, 381, 313, 207,
+    527, 391, 272, 634, 86, 68, 289, 150, 476, 430, 96, 245,
+    386, 288, 507, 16, 374, 126, 227, 18, 255, 477, 453, 533,
+    382, 103, 184, 589, 135, 483, 619, 356, 300, 164, 434, 427,
+    87, 445, 591, 11, 566, 77, 57, 78, 408, 315, 95, 467,
+    139, 410, 306, 404, 33, 323, 217, 402, 360, 570, 222, 317,
+    426, 187, 229, 169, 121, 195, 35, 573, 577, 91, 161, 309,
+    346, 587, 540, 361, 109, 611, 581, 339, 509, 520, 583, 163,
+    326, 395, 120, 501, 262, 274, 413, 387, 69, 214, 526, 66,
+    224, 560, 49, 267, 136, 250, 134, 287, 377, 447, 125, 622,
+    349, 88, 337, 612, 320, 230, 271, 555, 130, 283, 13, 7,
+    233, 277, 531, 179, 422, 3, 342, 193, 504, 618, 388, 362,
+    554, 41, 480, 39, 37, 603, 247, 556, 270, 6, 65, 334,
+    421, 502, 461, 70, 219, 631, 279, 369, 56, 371, 537, 503,
+    75, 22, 325, 596, 535, 357, 147, 168, 367, 296, 178, 399,
+    221, 90, 242, 365, 158, 368, 351, 307, 257, 354, 366, 63,
+    175, 162, 597, 305, 208, 280, 579, 246, 98, 364, 372, 385,
+    355, 340, 304, 53, 157, 218, 140, 145, 159, 605, 67, 201,
+    202, 638, 536, 248, 524, 1, 256, 515, 469, 189, 630, 143,
+    571, 598, 341, 101, 137, 513, 89, 102, 260, 180, 330, 119,
+    572, 239, 606, 397, 290, 389, 390, 512, 286, 511, 532, 472,
+    45, 176, 565, 170, 240, 345, 396, 569, 71, 474, 5, 15,
+    487, 236, 373, 416, 514, 174, 627, 252, 580, 629, 226, 48,
+    200, 621, 411, 335, 28, 437, 486, 55, 432, 76, 552, 234,
+    471, 400, 319, 72, 23, 481, 85, 258, 105, 490, 268, 576,
+    617, 111, 115, 336, 237, 117, 414, 610, 148, 79, 155, 12,
+    112, 463, 251, 393, 465, 273, 295, 466, 431, 482, 582, 142,
+    489, 575, 231, 428, 578, 73, 444, 460, 46, 210, 58, 204,
+    82, 294, 359, 196, 458, 293, 14, 118, 10, 623, 93, 614,
+    213, 81, 628, 446, 183, 276, 172, 370, 550, 303, 266, 194,
+    197, 182, 563, 8, 74, 156, 206, 595, 553, 316, 261, 602,
+    153, 584, 534, 314, 401, 61, 478, 191, 198, 433, 561, 379,
+    265, 321, 500, 123, 505, 54, 568, 329, 440, 564, 215, 21,
+    407, 2, 464, 363, 442, 608, 525, 29, 441, 559, 607, 241,
+    449, 0, 259, 152, 249, 457, 141, 462, 378, 203, 146, 417,
+    523, 17, 548, 52, 192, 348, 269, 225, 558, 616, 620, 38,
+    353, 419, 133, 435, 544, 151, 4, 455, 599, 493, 456, 423,
+    282, 19, 632, 439, 92, 567, 100, 344, 238, 34, 131, 488,
+    301, 376, 551, 64, 129, 122, 25, 485, 557, 600, 299, 264,
+    506, 543, 636, 144, 328, 624, 116, 185, 470, 149, 590, 104,
+    50, 318, 528, 547, 352, 199, 32, 244, 418, 521, 626, 275,
+    154, 223, 398, 171, 20, 358, 615, 165, 312, 97, 510, 216,
+    9, 311, 40, 479, 124, 83, 491, 519, 392, 297, 394, 59,
+    438, 110, 302, 594, 338, 604, 529, 518, 127, 517, 508, 106,
+    549, 94, 253, 108, 588, 114, 420, 285, 343, 350, 235, 132,
+    473, 263, 475, 138, 347, 601, 27, 545, 107, 327, 228, 585,
+    468, 406, 637, 403, 43, 459, 205, 278, 188, 212, 494, 113,
+    324, 181, 177, 538, 495, 613, 281, 633, 498, 186, 625, 211,
+    60, 546, 291, 30, 51, 541, 284, 26, 80, 190, 574, 31,
+    539, 448, 405, 383, 62, 243, 424, 542, 380, 409, 592, 84,
+    310, 128, 454, 47, 42, 173, 24, 450, 160, 322, 425, 415,
+    499, 609, 496, 166, 492, 593, 484, 331, 436, 451, 586, 298,
+    375, 562, 497, 209, 292, 530, 332, 254, 384, 443, 522, 333,
+    167, 429, 412,
+};
+
+#endif // TREE_SITTER_ABAP_KEYWORDS_H_
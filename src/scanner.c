@@ -1,13 +1,27 @@
 #include "tree_sitter/parser.h"
 #include "tree_sitter/alloc.h"
 #include "tree_sitter/array.h"
-#include <wctype.h>
+
+#include <string.h>
+
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+    #include "keywords.h"
+#endif
+
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+    #include "../bindings/c/tree_sitter/tree-sitter-abap-scanner-stats.h"
+#endif
 
 enum Token
 {
     LINE_COMMENT,
 
-    MULTI_LINE_COMMENT,
+    /**
+     * The first lines of a run of full-line comments, the rest of the run
+     * follows as MULTI_LINE_COMMENT_CHUNK tokens and the grammar groups them
+     * into a single `multi_line_comment` node.
+     */
+    MULTI_LINE_COMMENT_START,
 
     DOCSTRING_CONTINUATION,
 
@@ -20,14 +34,332 @@ enum Token
      */
     MESSAGE_TYPE,
 
-    ERROR_SENTINEL
+    MULTI_LINE_COMMENT_CHUNK,
+
+    /**
+     * A keyword that is used as a name, e.g. `data = 10.` The decision is
+     * made from what follows the word, see `scan_contextual_name`.
+     */
+    CONTEXTUAL_NAME,
+
+    /**
+     * Zero-width end of an event block such as `START-OF-SELECTION.`, which
+     * has no closing statement. Emitted in front of the next event or
+     * reserved statement, see `scan_event_block_end`.
+     */
+    EVENT_BLOCK_END,
+
+    /**
+     * The SQLScript of an AMDP method up to its `ENDMETHOD.`, which the
+     * grammar does not parse, see `scan_amdp_body`.
+     */
+    AMDP_BODY,
+
+    /**
+     * What follows the SELECT of a statement up to its period, only lexed by
+     * parsers generated with TREE_SITTER_ABAP_COARSE_SQL set, see
+     * `scan_sql_body`.
+     */
+    SQL_BODY,
+
+    /**
+     * The text of an ABAP Doc paragraph, continued over the `"!` of the
+     * following lines, see `scan_paragraph_text`.
+     */
+    PARAGRAPH_TEXT,
+
+    /**
+     * A contextual name in an operand position that no statement starts
+     * in, e.g. `SHIFT text LEFT.` Unlike CONTEXTUAL_NAME, a word after it
+     * makes it a name as well, see `is_followed_by_word`.
+     */
+    CONTEXTUAL_OPERAND_NAME,
+
+    ERROR_SENTINEL,
+
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+    /**
+     * The first of the KEYWORD_COUNT keyword tokens, in the order of
+     * `keyword_names`. Only exists in parsers generated with the
+     * TREE_SITTER_ABAP_KEYWORD_SCANNER environment variable set.
+     */
+    KEYWORD_START,
+#endif
 };
 
+/**
+ * Maximum number of lines in a single comment token, 0 lexes every run of
+ * full-line comments as one token regardless of its length.
+ *
+ * Commented-out legacy code can easily be thousands of lines long. As one
+ * token, every keystroke inside of it re-lexes the whole run and the result
+ * is a single leaf that can not be partially reused.
+ */
+#ifndef TREE_SITTER_ABAP_COMMENT_CHUNK_LINES
+    #define TREE_SITTER_ABAP_COMMENT_CHUNK_LINES 64
+#endif
+
+/**
+ * Chunks end early on a line whose content hash matches this mask, once
+ * they have at least a quarter of the maximum lines. Boundaries that depend
+ * on the content rather than the line count keep the chunks after an
+ * inserted or deleted line aligned with the previous ones, so they can
+ * still be reused.
+ */
+#define COMMENT_CHUNK_BOUNDARY_MASK 0x7
+
 typedef struct
 {
-    bool placeholder;
+    /**
+     * Whether the last comment token ended at a chunk boundary while the
+     * run of comment lines continues on the next line.
+     *
+     * Being part of the serialized state matters for incremental parsing:
+     * a chunk is only reused if the state before it is unchanged, so an
+     * edit that ends the run (e.g. an inserted blank line) can not leave a
+     * stale continuation chunk behind.
+     */
+    bool comment_run_open;
 } Scanner;
 
+enum CharClass
+{
+    CHAR_BLANK = 1 << 0,
+    CHAR_NEWLINE = 1 << 1,
+    CHAR_ALPHA = 1 << 2,
+    CHAR_DIGIT = 1 << 3,
+
+    // the characters of a name besides letters and digits
+    CHAR_NAME = 1 << 4,
+};
+
+/**
+ * Character classes of the ASCII range, everything outside of it has none.
+ *
+ * The scanner runs in front of almost every token, so it avoids the wide
+ * character functions of <wctype.h>. Those depend on the locale of the host
+ * process and are a function call per character.
+ */
+#define _ 0
+#define B CHAR_BLANK
+#define N CHAR_NEWLINE
+#define A CHAR_ALPHA
+#define D CHAR_DIGIT
+#define W CHAR_NAME
+static const uint8_t char_classes[128] = {
+        _, _, _, _, _, _, _, _, _, B, N, B, B, N, _, _, // 0x00
+        _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _, // 0x10
+        B, _, _, _, _, W, _, _, _, _, _, _, _, _, _, W, // 0x20
+        D, D, D, D, D, D, D, D, D, D, _, _, _, _, _, _, // 0x30
+        _, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A, // 0x40
+        A, A, A, A, A, A, A, A, A, A, A, _, _, _, _, W, // 0x50
+        _, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A, // 0x60
+        A, A, A, A, A, A, A, A, A, A, A, _, _, _, _, _, // 0x70
+};
+#undef _
+#undef B
+#undef N
+#undef A
+#undef D
+#undef W
+
+static inline bool is_char_class(int32_t c, uint8_t classes)
+{
+    return c >= 0 && c < 128 && (char_classes[c] & classes) != 0;
+}
+
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+_Static_assert(ERROR_SENTINEL <= TREE_SITTER_ABAP_SCANNER_KEYWORD_BIT,
+               "the valid set masks need a bit per token before the sentinel");
+
+static _Thread_local TSAbapScannerStats stats;
+
+// The branch entered last by the current call.
+static _Thread_local uint32_t stats_branch;
+
+    #define STATS_BRANCH(branch)                                            \
+        (stats_branch = TREE_SITTER_ABAP_SCANNER_BRANCH_##branch,           \
+         stats.branches[stats_branch].calls++)
+#else
+    #define STATS_BRANCH(branch) ((void)0)
+#endif
+
+static inline void advance(TSLexer* lexer, bool skip)
+{
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+    if (!lexer->eof(lexer)) {
+        int32_t c = lexer->lookahead;
+        uint32_t bytes = c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        stats.branches[stats_branch].bytes += bytes;
+        stats.total.bytes += bytes;
+    }
+#endif
+    lexer->advance(lexer, skip);
+}
+
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+/** Must be kept in sync with `hash` in scripts/generate-keywords.js. */
+static inline uint32_t keyword_hash(const char* word, uint32_t length,
+                                    uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)word[i]) * 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+/**
+ * Looks up a lower case word in the perfect hash table of keywords.
+ *
+ * @returns the index of the keyword or -1 if the word is none.
+ */
+static int32_t keyword_lookup(const char* word, uint32_t length)
+{
+    uint32_t bucket = keyword_hash(word, length, 0) % KEYWORD_BUCKET_COUNT;
+    uint32_t slot = keyword_hash(word, length, keyword_seeds[bucket]) %
+                    KEYWORD_COUNT;
+    uint16_t index = keyword_slots[slot];
+    const char* keyword = keyword_names[index];
+    if (strncmp(keyword, word, length) != 0 || keyword[length] != '\0') {
+        return -1;
+    }
+    return index;
+}
+
+/**
+ * Lexes the longest valid keyword at the lexer, with `length` characters of
+ * the word already consumed into `word`. Dashed keywords such as
+ * `end-of-definition` are tried at every dash, so the token ends after the
+ * last part that still forms a valid keyword.
+ */
+static bool scan_keyword(TSLexer* lexer, const bool* valid_symbols,
+                         char* word, uint32_t length)
+{
+    bool found = false;
+    STATS_BRANCH(KEYWORD);
+    for (;;) {
+        while (is_char_class(lexer->lookahead,
+                             CHAR_ALPHA | CHAR_DIGIT | CHAR_NAME)) {
+            if (length == KEYWORD_MAX_LENGTH) {
+                // longer than any keyword, so are all its dashed extensions
+                return found;
+            }
+            int32_t c = lexer->lookahead;
+            word[length++] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+            advance(lexer, false);
+        }
+
+        if (length == 0) {
+            return false;
+        }
+        int32_t index = keyword_lookup(word, length);
+        if (index >= 0 && valid_symbols[KEYWORD_START + index]) {
+            lexer->mark_end(lexer);
+            lexer->result_symbol = KEYWORD_START + index;
+            found = true;
+        }
+        if (lexer->lookahead != '-' || length == KEYWORD_MAX_LENGTH) {
+            return found;
+        }
+        word[length++] = '-';
+        advance(lexer, false);
+    }
+}
+#endif
+
+/**
+ * What is known about the column of the lexer. It follows from the skipped
+ * characters, so `get_column` - which walks back to the start of the line
+ * and is linear in the length of it - is only needed when nothing was
+ * skipped.
+ */
+typedef enum
+{
+    COLUMN_UNKNOWN,
+    COLUMN_ZERO,
+    COLUMN_NONZERO,
+} ColumnState;
+
+/**
+ * Keywords that may be used as names where the grammar accepts a
+ * `_contextual_identifier`, sorted. Words not listed here are left to the
+ * lexer, which produces an identifier wherever the keyword is not valid.
+ */
+static const char* const contextual_names[] = {
+        "any", "append", "at", "call", "case", "cast", "check", "class", "cond",
+        "condense", "constants", "continue", "conv", "corresponding", "data",
+        "delete", "exit", "filter", "form", "if", "include", "initialization",
+        "insert", "interface", "interfaces", "loop", "method", "methods", "new",
+        "parameters", "perform", "raise", "read", "reduce", "ref", "replace",
+        "return", "sort", "split", "sum", "switch", "tables", "test", "text",
+        "try", "types", "value",
+};
+
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+    #define WORD_MAX_LENGTH KEYWORD_MAX_LENGTH
+#else
+    // the longest of the contextual names
+    #define WORD_MAX_LENGTH 14
+#endif
+
+/**
+ * Contextual names that also start dashed keywords, e.g. `class-data` or
+ * `read-only`, so a dash after them does not make them a name.
+ */
+static const char* const dashed_keyword_prefixes[] = {
+        "class", "exit", "interface", "new", "read", "test", "value",
+};
+
+/**
+ * Contextual names that form a complete statement on their own, e.g.
+ * `RETURN.`, so a terminator after them does not make them a name.
+ */
+static const char* const statement_keywords[] = {
+        "continue", "exit", "initialization", "loop",
+        "return", "sort", "sum", "try",
+};
+
+/**
+ * The words that start a `reserved_statement`, sorted. They can not be part
+ * of an event block, so the block ends in front of them. `at` stands for
+ * `AT SELECTION-SCREEN` and the events of list processing, the group
+ * statements `AT NEW` etc. only occur inside of a loop.
+ *
+ * Checked against the grammar by scripts/check-block-start-keywords.js.
+ */
+static const char* const block_start_keywords[] = {
+        "at",
+        "class",
+        "class-data",
+        "class-events",
+        "class-methods",
+        "define",
+        "events",
+        "form",
+        "function",
+        "initialization",
+        "interface",
+        "interfaces",
+        "load-of-program",
+        "method",
+        "methods",
+        "module",
+        "parameters",
+        "select-options",
+        "selection-screen",
+        "start-of-selection",
+        "tables",
+};
+
+/** The words in `block_start_keywords` that are followed by a dash. */
+static const char* const block_start_prefixes[] = {
+        "class", "load", "load-of", "select", "selection", "start", "start-of",
+};
+
+// the longest of the block start keywords
+#define BLOCK_WORD_MAX_LENGTH 18
+
 // i: information message
 // s: status message
 // e: error message
@@ -39,11 +371,10 @@ static const char* valid_message_types = "isewaxISEWAX";
 int32_t advance_whitespaces(TSLexer* lexer, bool include)
 {
     int32_t consumed = 0;
-    while (lexer->lookahead == ' ' || lexer->lookahead == '\v' ||
-           lexer->lookahead == '\f' || lexer->lookahead == '\t') {
+    while (is_char_class(lexer->lookahead, CHAR_BLANK)) {
         // The whitespaces need to be part of the token for docstrings,
         // otherwise it gets cut into little parts.
-        lexer->advance(lexer, !include);
+        advance(lexer, !include);
         consumed++;
     }
     return consumed;
@@ -52,14 +383,14 @@ int32_t advance_whitespaces(TSLexer* lexer, bool include)
 bool consume_end_of_line(TSLexer* lexer, bool include)
 {
     if (lexer->lookahead == '\n') {
-        lexer->advance(lexer, !include);
+        advance(lexer, !include);
         return true;
     }
 
     if (lexer->lookahead == '\r') {
-        lexer->advance(lexer, !include);
+        advance(lexer, !include);
         if (lexer->lookahead == '\n') {
-            lexer->advance(lexer, !include);
+            advance(lexer, !include);
         }
         return true;
     }
@@ -71,17 +402,68 @@ bool consume_docstring_start(TSLexer* lexer, bool include)
     if (lexer->lookahead != '"') {
         return false;
     }
-    lexer->advance(lexer, !include);
+    advance(lexer, !include);
     if (lexer->lookahead != '!') {
         return false;
     }
-    lexer->advance(lexer, !include);
+    advance(lexer, !include);
     return true;
 }
 
-bool is_at_line_comment_start(TSLexer* lexer)
+bool is_at_line_comment_start(TSLexer* lexer, ColumnState column)
+{
+    // `*` is also the multiplication and the select list wildcard, but those
+    // are preceded by a blank, so the column is rarely asked for.
+    if (lexer->lookahead != '*' || column == COLUMN_NONZERO) {
+        return false;
+    }
+    return column == COLUMN_ZERO || lexer->get_column(lexer) == 0;
+}
+
+bool is_end_of_line(TSLexer* lexer)
+{
+    return is_char_class(lexer->lookahead, CHAR_NEWLINE) || lexer->eof(lexer);
+}
+
+/**
+ * Consumes full-line comments starting at the `*` in column 0 up to the end
+ * of a chunk or the run. The token always ends at the last non-blank
+ * character of its last line, blanks and lines after it are left out.
+ *
+ * @returns the number of lines consumed.
+ */
+uint32_t scan_comment_lines(Scanner* scanner, TSLexer* lexer)
 {
-    return lexer->get_column(lexer) == 0 && lexer->lookahead == '*';
+    uint32_t lines = 0;
+    scanner->comment_run_open = false;
+
+    for (;;) {
+        uint32_t hash = 2166136261u;
+        while (!is_end_of_line(lexer)) {
+            int32_t c = lexer->lookahead;
+            hash = (hash ^ (uint32_t)c) * 16777619u;
+            advance(lexer, false);
+            if (!is_char_class(c, CHAR_BLANK)) {
+                lexer->mark_end(lexer);
+            }
+        }
+        lines++;
+
+        if (lexer->eof(lexer) || !consume_end_of_line(lexer, true) ||
+            lexer->lookahead != '*') {
+            return lines;
+        }
+
+        // The next line continues the run, decide whether it also continues
+        // this token.
+        uint32_t limit = TREE_SITTER_ABAP_COMMENT_CHUNK_LINES;
+        if (limit != 0 &&
+            (lines >= limit || (lines >= limit / 4 &&
+                                (hash & COMMENT_CHUNK_BOUNDARY_MASK) == 0))) {
+            scanner->comment_run_open = true;
+            return lines;
+        }
+    }
 }
 
 // We must make whitespaces an inline regex in the extras to avoid it
@@ -91,35 +473,649 @@ bool is_at_line_comment_start(TSLexer* lexer)
 // failure to check whether a line comment is starting at any
 // opportunity. Due to the 'magical' nature of the scanner, im still not
 // fully sure what is actually going on.
-void advance_whitespaces_and_newlines(TSLexer* lexer, bool include)
+ColumnState skip_whitespaces_and_newlines(TSLexer* lexer, ColumnState column)
+{
+    for (;;) {
+        if (advance_whitespaces(lexer, false) > 0) {
+            column = COLUMN_NONZERO;
+        } else if (consume_end_of_line(lexer, false)) {
+            column = COLUMN_ZERO;
+        } else {
+            return column;
+        }
+    }
+}
+
+static bool word_in(const char* word, const char* const* words, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(words[i], word) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_contextual_name(const char* word)
+{
+    size_t low = 0;
+    size_t high = sizeof(contextual_names) / sizeof(contextual_names[0]);
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        int order = strcmp(contextual_names[middle], word);
+        if (order == 0) {
+            return true;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
+
+/**
+ * Contextual names and the word after them that continue them as keywords
+ * in an operand position, e.g. `TYPE ANY TABLE` or `TYPE REF TO`.
+ */
+static const char* const keyword_sequences[][2] = {
+        {"any", "table"},
+        {"ref", "to"},
+};
+
+/**
+ * Whether a word follows that makes the contextual name in front of it a
+ * name, e.g. `LEFT` in `SHIFT text LEFT.` A type name directly followed by
+ * a parenthesis is the type of a constructor expression such as
+ * `CONV string( ... )`, the words of `keyword_sequences` continue the
+ * keyword.
+ */
+static bool is_followed_by_word(TSLexer* lexer, const char* word)
+{
+    if (!is_char_class(lexer->lookahead, CHAR_ALPHA)) {
+        return false;
+    }
+
+    char next[6];
+    uint32_t length = 0;
+    while (is_char_class(lexer->lookahead,
+                         CHAR_ALPHA | CHAR_DIGIT | CHAR_NAME)) {
+        if (length < sizeof(next) - 1) {
+            int32_t c = lexer->lookahead;
+            next[length] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+        }
+        length++;
+        advance(lexer, false);
+    }
+    next[length < sizeof(next) - 1 ? length : sizeof(next) - 1] = '\0';
+
+    if (lexer->lookahead == '(') {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(keyword_sequences) / sizeof(char* [2]);
+         i++) {
+        if (length < sizeof(next) &&
+            strcmp(keyword_sequences[i][0], word) == 0 &&
+            strcmp(keyword_sequences[i][1], next) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Decides from what follows a contextual name whether it is a name. Only
+ * contexts that no keyword can be followed by count, anything else is left
+ * to the lexer:
+ *
+ * - a component or attribute access: `data-comp`, `data->attr`, `data=>attr`
+ * - a table expression: `data[ 1 ]`
+ * - an assignment: `data = 1`, `data ?= ref`, `data += 1`
+ * - a terminator: `WRITE data.`, unless the keyword is a statement itself
+ * - where CONTEXTUAL_OPERAND_NAME is valid, a word, see `is_followed_by_word`
+ *
+ * @returns the token to lex the name as, or -1 if it is the keyword. The
+ * contexts but the word are lexed as CONTEXTUAL_NAME where it is valid.
+ */
+static int32_t name_token(TSLexer* lexer, const bool* valid_symbols,
+                          const char* word)
+{
+    int32_t name = valid_symbols[CONTEXTUAL_NAME] ? CONTEXTUAL_NAME
+                                                  : CONTEXTUAL_OPERAND_NAME;
+    if (lexer->lookahead == '-') {
+        if (word_in(word, dashed_keyword_prefixes,
+                    sizeof(dashed_keyword_prefixes) / sizeof(char*))) {
+            return -1;
+        }
+        advance(lexer, false);
+        bool access = lexer->lookahead == '>' ||
+                      is_char_class(lexer->lookahead,
+                                    CHAR_ALPHA | CHAR_DIGIT | CHAR_NAME);
+        return access ? name : -1;
+    }
+    if (lexer->lookahead == '[') {
+        return name;
+    }
+
+    // The end of the name is marked already, skipping would move the start
+    // of the token behind it.
+    bool blank = advance_whitespaces(lexer, true) > 0;
+    bool is_name = false;
+    switch (lexer->lookahead) {
+        case '=':
+            advance(lexer, false);
+            is_name = blank ? lexer->lookahead != '>'
+                            : lexer->lookahead == '>';
+            break;
+        case '?':
+        case '+':
+        case '-':
+        case '*':
+        case '/':
+            advance(lexer, false);
+            is_name = blank && lexer->lookahead == '=';
+            break;
+        case '.':
+        case ',':
+        case ')':
+        case ']':
+            is_name = !word_in(word, statement_keywords,
+                               sizeof(statement_keywords) / sizeof(char*));
+            break;
+        default:
+            if (blank && valid_symbols[CONTEXTUAL_OPERAND_NAME] &&
+                is_followed_by_word(lexer, word)) {
+                return CONTEXTUAL_OPERAND_NAME;
+            }
+            return -1;
+    }
+    return is_name ? name : -1;
+}
+
+/**
+ * Reads a word of name characters in lower case. A dash ends it.
+ *
+ * @returns the length of the word, or -1 if it is longer than `max_length`.
+ */
+static int32_t read_word(TSLexer* lexer, char* word, uint32_t max_length)
+{
+    uint32_t length = 0;
+    while (is_char_class(lexer->lookahead,
+                         CHAR_ALPHA | CHAR_DIGIT | CHAR_NAME)) {
+        if (length == max_length) {
+            return -1;
+        }
+        int32_t c = lexer->lookahead;
+        word[length++] = (char)(c >= 'A' && c <= 'Z' ? c + 32 : c);
+        advance(lexer, false);
+    }
+    word[length] = '\0';
+    return (int32_t)length;
+}
+
+/**
+ * Decides a word read at the lexer, with nothing after it consumed yet,
+ * between a contextual name and the keyword.
+ */
+static bool scan_word_as_name(TSLexer* lexer, const bool* valid_symbols,
+                              char* word, uint32_t length)
+{
+    lexer->mark_end(lexer);
+
+    bool name_valid = valid_symbols[CONTEXTUAL_NAME] ||
+                      valid_symbols[CONTEXTUAL_OPERAND_NAME];
+
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+    // The lexer can not produce keywords in this mode, continue with the
+    // keyword unless the context has been consumed already.
+    if (!name_valid || !is_contextual_name(word) ||
+        (lexer->lookahead == '-' &&
+         word_in(word, dashed_keyword_prefixes,
+                 sizeof(dashed_keyword_prefixes) / sizeof(char*)))) {
+        return scan_keyword(lexer, valid_symbols, word, length);
+    }
+    int32_t name = name_token(lexer, valid_symbols, word);
+    if (name >= 0) {
+        lexer->result_symbol = name;
+        return true;
+    }
+    int32_t index = keyword_lookup(word, length);
+    if (index >= 0 && valid_symbols[KEYWORD_START + index]) {
+        lexer->result_symbol = KEYWORD_START + index;
+        return true;
+    }
+    return false;
+#else
+    (void)length;
+    if (!name_valid || !is_contextual_name(word)) {
+        return false;
+    }
+    int32_t name = name_token(lexer, valid_symbols, word);
+    if (name < 0) {
+        return false;
+    }
+    lexer->result_symbol = name;
+    return true;
+#endif
+}
+
+/**
+ * Lexes a keyword that is used as a name, replacing a case-insensitive
+ * regex alternative per keyword in the lexer.
+ */
+static bool scan_contextual_name(TSLexer* lexer, const bool* valid_symbols)
+{
+    char word[WORD_MAX_LENGTH + 1];
+    int32_t length = read_word(lexer, word, WORD_MAX_LENGTH);
+    if (length < 0) {
+        return false;
+    }
+    return scan_word_as_name(lexer, valid_symbols, word, (uint32_t)length);
+}
+
+/**
+ * Ends an event block in front of the end of the input or a word of
+ * `block_start_keywords` that is not used as a name. Any other word is
+ * lexed as it would be without the event block around it.
+ *
+ * The end token is zero-width, so the end of it is marked before the word
+ * is read. Where the word turns out to be a name after all, the end can no
+ * longer be moved behind it and the word is left to the lexer. It produces
+ * an identifier there, as the keywords of reserved statements are not valid
+ * inside of an event block.
+ */
+static bool scan_event_block_end(TSLexer* lexer, const bool* valid_symbols)
+{
+    lexer->mark_end(lexer);
+    if (lexer->eof(lexer)) {
+        lexer->result_symbol = EVENT_BLOCK_END;
+        return true;
+    }
+
+    // room for the whole keyword in case the word continues as one
+    char word[WORD_MAX_LENGTH + BLOCK_WORD_MAX_LENGTH + 1];
+    int32_t length = read_word(lexer, word, WORD_MAX_LENGTH);
+    if (length < 0) {
+        return false;
+    }
+
+    bool dashed = false;
+    while (lexer->lookahead == '-' &&
+           word_in(word, block_start_prefixes,
+                   sizeof(block_start_prefixes) / sizeof(char*))) {
+        // e.g. `start-of-selection`, the word is read as far as it can still
+        // become one of the block start keywords
+        word[length++] = '-';
+        advance(lexer, false);
+        int32_t part = read_word(lexer, word + length,
+                                 BLOCK_WORD_MAX_LENGTH - (uint32_t)length);
+        if (part < 0) {
+            return false;
+        }
+        length += part;
+        dashed = true;
+    }
+
+    if (word_in(word, block_start_keywords,
+                sizeof(block_start_keywords) / sizeof(char*))) {
+        if (lexer->lookahead == '-' ||
+            (!dashed && is_contextual_name(word) &&
+             name_token(lexer, valid_symbols, word) >= 0)) {
+            return false;
+        }
+        lexer->result_symbol = EVENT_BLOCK_END;
+        return true;
+    }
+
+    if (dashed) {
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+        return scan_keyword(lexer, valid_symbols, word, (uint32_t)length);
+#else
+        return false;
+#endif
+    }
+    return scan_word_as_name(lexer, valid_symbols, word, (uint32_t)length);
+}
+
+static bool is_sql_word_char(int32_t c)
+{
+    return is_char_class(c, CHAR_ALPHA | CHAR_DIGIT) || c == '_';
+}
+
+/** Consumes up to the end of the line, the line break excluded. */
+static void skip_to_end_of_line(TSLexer* lexer)
+{
+    while (!is_end_of_line(lexer)) {
+        advance(lexer, false);
+    }
+}
+
+/**
+ * Consumes a literal or quoted name from its opening to its closing quote.
+ * A doubled quote inside of it is an escaped one.
+ */
+static void skip_quoted(TSLexer* lexer, int32_t quote)
+{
+    advance(lexer, false);
+    while (!lexer->eof(lexer)) {
+        if (lexer->lookahead != quote) {
+            advance(lexer, false);
+            continue;
+        }
+        advance(lexer, false);
+        if (lexer->lookahead != quote) {
+            return;
+        }
+        advance(lexer, false);
+    }
+}
+
+/**
+ * Lexes the body of a method implemented `BY DATABASE PROCEDURE|FUNCTION`
+ * as a single token. It is SQLScript, which the grammar would only parse
+ * through error recovery, and is left to an SQL grammar through an
+ * injection instead.
+ *
+ * The body ends in front of the `ENDMETHOD` that is followed by a period.
+ * SQL string literals, quoted names, line and block comments and ABAP
+ * full-line comments are skipped as a whole, so an `ENDMETHOD.` inside of
+ * them does not end it. An empty body is no token, the `ENDMETHOD` is left
+ * to the lexer.
+ */
+static bool scan_amdp_body(TSLexer* lexer, const bool* valid_symbols)
+{
+    static const char endmethod[] = "endmethod";
+    ColumnState column = COLUMN_UNKNOWN;
+    bool content = false;
+
+    while (!lexer->eof(lexer)) {
+        int32_t c = lexer->lookahead;
+        if (is_char_class(c, CHAR_BLANK | CHAR_NEWLINE)) {
+            column = is_char_class(c, CHAR_NEWLINE) ? COLUMN_ZERO
+                                                    : COLUMN_NONZERO;
+            // the blanks in front of the body are not part of it
+            advance(lexer, !content);
+            continue;
+        }
+
+        if (is_char_class(c, CHAR_ALPHA | CHAR_DIGIT)) {
+            uint32_t length = 0;
+            bool matches = true;
+            while (is_sql_word_char(lexer->lookahead)) {
+                c = lexer->lookahead;
+                int32_t lower = c >= 'A' && c <= 'Z' ? c + 32 : c;
+                matches = matches && length < sizeof(endmethod) - 1 &&
+                          lower == endmethod[length];
+                length++;
+                advance(lexer, false);
+            }
+            if (matches && length == sizeof(endmethod) - 1) {
+                if (!content) {
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+                    lexer->mark_end(lexer);
+                    char word[KEYWORD_MAX_LENGTH] = "endmethod";
+                    int32_t index = keyword_lookup(word, length);
+                    if (index >= 0 && valid_symbols[KEYWORD_START + index]) {
+                        lexer->result_symbol = KEYWORD_START + index;
+                        return true;
+                    }
+#else
+                    (void)valid_symbols;
+#endif
+                    return false;
+                }
+                // The end of the body is marked already, the blanks are
+                // consumed without skipping to keep its start.
+                while (is_char_class(lexer->lookahead,
+                                     CHAR_BLANK | CHAR_NEWLINE)) {
+                    advance(lexer, false);
+                }
+                if (lexer->lookahead == '.') {
+                    lexer->result_symbol = AMDP_BODY;
+                    return true;
+                }
+            }
+        } else if (c == '\'' || c == '"') {
+            skip_quoted(lexer, c);
+        } else if (c == '-' || c == '/') {
+            advance(lexer, false);
+            if (c == '-' && lexer->lookahead == '-') {
+                skip_to_end_of_line(lexer);
+            } else if (c == '/' && lexer->lookahead == '*') {
+                advance(lexer, false);
+                int32_t previous = 0;
+                while (!lexer->eof(lexer) &&
+                       !(previous == '*' && lexer->lookahead == '/')) {
+                    previous = lexer->lookahead;
+                    advance(lexer, false);
+                }
+                advance(lexer, false);
+            }
+        } else if (is_at_line_comment_start(lexer, column)) {
+            skip_to_end_of_line(lexer);
+        } else {
+            advance(lexer, false);
+        }
+        lexer->mark_end(lexer);
+        column = COLUMN_NONZERO;
+        content = true;
+    }
+
+    // no ENDMETHOD before the end of the input, the body is all there is
+    lexer->result_symbol = AMDP_BODY;
+    return content;
+}
+
+/**
+ * Consumes a string template from its opening to its closing `|`. A
+ * backslash escapes the character after it.
+ */
+static void skip_string_template(TSLexer* lexer)
+{
+    advance(lexer, false);
+    while (!lexer->eof(lexer) && lexer->lookahead != '|') {
+        if (lexer->lookahead == '\\') {
+            advance(lexer, false);
+        }
+        advance(lexer, false);
+    }
+    advance(lexer, false);
+}
+
+/**
+ * Lexes the rest of a SELECT statement up to its period as a single token.
+ * Only parsers generated with TREE_SITTER_ABAP_COARSE_SQL set ask for it,
+ * the grammar in `abapsql/` parses the token when a host needs its tree.
+ *
+ * Like any ABAP statement, it ends at a period followed by a blank, a line
+ * break, a comment or the end of the input. Literals, string templates and
+ * comments are skipped as a whole, so a period inside of them does not end
+ * it. Host expressions are ABAP and can hold any of them.
+ */
+static bool scan_sql_body(TSLexer* lexer)
+{
+    ColumnState column = COLUMN_UNKNOWN;
+    bool content = false;
+
+    while (!lexer->eof(lexer)) {
+        int32_t c = lexer->lookahead;
+        if (is_char_class(c, CHAR_BLANK | CHAR_NEWLINE)) {
+            column = is_char_class(c, CHAR_NEWLINE) ? COLUMN_ZERO
+                                                    : COLUMN_NONZERO;
+            // the blanks in front of the body are not part of it
+            advance(lexer, !content);
+            continue;
+        }
+
+        if (c == '.') {
+            advance(lexer, false);
+            c = lexer->lookahead;
+            if (lexer->eof(lexer) || c == '"' ||
+                is_char_class(c, CHAR_BLANK | CHAR_NEWLINE)) {
+                break;
+            }
+        } else if (c == '\'' || c == '`') {
+            skip_quoted(lexer, c);
+        } else if (c == '|') {
+            skip_string_template(lexer);
+        } else if (c == '"' || is_at_line_comment_start(lexer, column)) {
+            skip_to_end_of_line(lexer);
+        } else {
+            advance(lexer, false);
+        }
+        lexer->mark_end(lexer);
+        column = COLUMN_NONZERO;
+        content = true;
+    }
+
+    lexer->result_symbol = SQL_BODY;
+    return content;
+}
+
+/**
+ * Lexes the text of an ABAP Doc paragraph up to a doclink, a line that
+ * starts with a doctag, an empty `"!` line or the end of the docstring.
+ * The `"!` of the lines in between and the blanks around them are part of
+ * the token, so a paragraph of prose is a single token instead of a
+ * DOCSTRING_CONTINUATION and a text token per line.
+ *
+ * Like the doctag, the text may not start with an `@`, and `{` and `}`
+ * only occur escaped as `\{` and `\}` outside of a doclink. A paragraph
+ * that ends with a doclink ends with its line.
+ */
+static bool scan_paragraph_text(TSLexer* lexer)
 {
-    while (advance_whitespaces(lexer, include) > 0 ||
-           consume_end_of_line(lexer, include)) {
+    bool content = false;
+
+    advance_whitespaces(lexer, false);
+    if (lexer->lookahead == '@') {
+        return false;
+    }
+
+    while (!lexer->eof(lexer)) {
+        int32_t c = lexer->lookahead;
+        if (is_char_class(c, CHAR_NEWLINE)) {
+            if (!content) {
+                return false;
+            }
+            // the token ends with this line unless the next one continues it
+            consume_end_of_line(lexer, true);
+            advance_whitespaces(lexer, true);
+            if (!consume_docstring_start(lexer, true)) {
+                break;
+            }
+            advance_whitespaces(lexer, true);
+            if (lexer->lookahead == '@' || is_end_of_line(lexer)) {
+                break;
+            }
+            lexer->mark_end(lexer);
+            continue;
+        }
+
+        if (c == '{' || c == '}') {
+            break;
+        }
+        advance(lexer, false);
+        if (c == '\\' &&
+            (lexer->lookahead == '{' || lexer->lookahead == '}')) {
+            advance(lexer, false);
+        }
+        lexer->mark_end(lexer);
+        content = true;
     }
+
+    lexer->result_symbol = PARAGRAPH_TEXT;
+    return content;
 }
 
 /**
- * Hook to implement our scanner logic in.
+ * Tries the branches of the scanner in order.
  *
  * @returns true if a token was found, false otherwise.
  */
-bool tree_sitter_abap_external_scanner_scan(void* payload, TSLexer* lexer,
-                                            const bool* valid_symbols)
+static bool scan(Scanner* scanner, TSLexer* lexer, const bool* valid_symbols)
 {
+    ColumnState column = COLUMN_UNKNOWN;
+
     if (valid_symbols[ERROR_SENTINEL]) {
+        STATS_BRANCH(ERROR_RECOVERY);
         return false;
     }
 
+    if (!valid_symbols[MULTI_LINE_COMMENT_CHUNK]) {
+        scanner->comment_run_open = false;
+    } else if (scanner->comment_run_open) {
+        STATS_BRANCH(COMMENT_CHUNK);
+        // The previous chunk ended with the last non-blank character of
+        // its line, the next line must start with the `*` for the run to
+        // continue.
+        advance_whitespaces(lexer, false);
+        consume_end_of_line(lexer, false);
+        if (lexer->lookahead == '*') {
+            scan_comment_lines(scanner, lexer);
+            lexer->result_symbol = MULTI_LINE_COMMENT_CHUNK;
+            return true;
+        }
+        scanner->comment_run_open = false;
+    }
+
+    if (valid_symbols[AMDP_BODY]) {
+        STATS_BRANCH(AMDP_BODY);
+        return scan_amdp_body(lexer, valid_symbols);
+    }
+
+    if (valid_symbols[SQL_BODY]) {
+        STATS_BRANCH(SQL_BODY);
+        return scan_sql_body(lexer);
+    }
+
+    if (valid_symbols[PARAGRAPH_TEXT] && !is_end_of_line(lexer)) {
+        STATS_BRANCH(PARAGRAPH_TEXT);
+        if (scan_paragraph_text(lexer)) {
+            return true;
+        }
+    }
+
+    if (valid_symbols[EVENT_BLOCK_END]) {
+        STATS_BRANCH(EVENT_BLOCK_END);
+        column = skip_whitespaces_and_newlines(lexer, column);
+        if (lexer->eof(lexer) || is_char_class(lexer->lookahead, CHAR_ALPHA)) {
+            return scan_event_block_end(lexer, valid_symbols);
+        }
+    }
+
+    if ((valid_symbols[CONTEXTUAL_NAME] ||
+         valid_symbols[CONTEXTUAL_OPERAND_NAME]) &&
+        !valid_symbols[MESSAGE_TYPE]) {
+        STATS_BRANCH(CONTEXTUAL_NAME);
+        column = skip_whitespaces_and_newlines(lexer, column);
+        if (is_char_class(lexer->lookahead, CHAR_ALPHA)) {
+            return scan_contextual_name(lexer, valid_symbols);
+        }
+    }
+
     if (valid_symbols[MESSAGE_TYPE]) {
-        advance_whitespaces_and_newlines(lexer, false);
+        STATS_BRANCH(MESSAGE_TYPE);
+        column = skip_whitespaces_and_newlines(lexer, column);
 
         // For now, literally just allow any character to be more permissive.
         // The restrictive logic is there if we need it..
-        if (iswalpha(lexer->lookahead)) {
-            lexer->advance(lexer, false);
+        if (is_char_class(lexer->lookahead, CHAR_ALPHA)) {
+            int32_t first = lexer->lookahead;
+            advance(lexer, false);
             lexer->mark_end(lexer);
-            if (!iswdigit(lexer->lookahead)) {
+            if (!is_char_class(lexer->lookahead, CHAR_DIGIT)) {
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+                // no message type, but possibly a keyword such as `ID`
+                char word[KEYWORD_MAX_LENGTH] = {
+                        (char)(first >= 'A' && first <= 'Z' ? first + 32
+                                                             : first)};
+                return scan_keyword(lexer, valid_symbols, word, 1);
+#else
+                (void)first;
                 return false;
+#endif
             }
             lexer->result_symbol = MESSAGE_TYPE;
             return true;
@@ -127,6 +1123,7 @@ bool tree_sitter_abap_external_scanner_scan(void* payload, TSLexer* lexer,
     }
 
     if (valid_symbols[DOCSTRING_CONTINUATION]) {
+        STATS_BRANCH(DOCSTRING_CONTINUATION);
         consume_end_of_line(lexer, false);
 
         // start of the next line, "! must appear
@@ -135,17 +1132,20 @@ bool tree_sitter_abap_external_scanner_scan(void* payload, TSLexer* lexer,
             lexer->result_symbol = DOCSTRING_CONTINUATION;
             return true;
         }
+#ifndef TREE_SITTER_ABAP_KEYWORD_SCANNER
         return false;
+#endif
     }
 
     if (valid_symbols[DOCTAG_TEXT]) {
+        STATS_BRANCH(DOCTAG_TEXT);
         bool start_capture = false;
 
         // simply walk up to the end of the line or until the @ symbol.
         while (!lexer->eof(lexer) && lexer->lookahead != '\r' &&
                lexer->lookahead != '\n' && lexer->lookahead != '@') {
             start_capture |= lexer->lookahead != ' ';
-            lexer->advance(lexer, !start_capture);
+            advance(lexer, !start_capture);
         }
         if (start_capture) {
             lexer->result_symbol = DOCTAG_TEXT;
@@ -154,26 +1154,209 @@ bool tree_sitter_abap_external_scanner_scan(void* payload, TSLexer* lexer,
     }
 
     if (valid_symbols[LINE_COMMENT]) {
-        uint32_t lines = 0;
+        STATS_BRANCH(LINE_COMMENT);
         // make sure the advanced whitespaces and newlines are not included
         // in the range.
-        advance_whitespaces_and_newlines(lexer, false);
-        while (is_at_line_comment_start(lexer)) {
-            do {
-                lexer->advance(lexer, false);
-                if (lexer->lookahead != ' ') {
-                    lexer->mark_end(lexer);
-                }
-            } while (!lexer->eof(lexer) && !consume_end_of_line(lexer, true));
-            lines++;
-        }
-        if (lines != 0) {
+        column = skip_whitespaces_and_newlines(lexer, column);
+        if (is_at_line_comment_start(lexer, column)) {
+            uint32_t lines = scan_comment_lines(scanner, lexer);
             lexer->result_symbol =
-                    lines > 1 ? MULTI_LINE_COMMENT : LINE_COMMENT;
+                    lines > 1 || scanner->comment_run_open
+                            ? MULTI_LINE_COMMENT_START
+                            : LINE_COMMENT;
             return true;
         }
     }
+
+#ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+    // Keywords are external tokens in this mode, the internal lexer can no
+    // longer produce them.
+    skip_whitespaces_and_newlines(lexer, column);
+    char word[KEYWORD_MAX_LENGTH];
+    return scan_keyword(lexer, valid_symbols, word, 0);
+#else
     return false;
+#endif
+}
+
+
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+static const char* const branch_names[TREE_SITTER_ABAP_SCANNER_BRANCH_COUNT] = {
+        "error_recovery",
+        "comment_chunk",
+        "amdp_body",
+        "sql_body",
+        "paragraph_text",
+        "event_block_end",
+        "contextual_name",
+        "message_type",
+        "docstring_continuation",
+        "doctag_text",
+        "line_comment",
+        "keyword",
+        "none",
+};
+
+/** The names of the bits of a valid set, the tokens in `enum Token`. */
+static const char* const valid_set_names[] = {
+        "line_comment",
+        "multi_line_comment_start",
+        "docstring_continuation",
+        "doctag_text",
+        "message_type",
+        "multi_line_comment_chunk",
+        "contextual_name",
+        "event_block_end",
+        "amdp_body",
+        "sql_body",
+        "paragraph_text",
+        "contextual_operand_name",
+        "keyword",
+};
+
+static bool scan_counted(Scanner* scanner, TSLexer* lexer,
+                         const bool* valid_symbols)
+{
+    uint32_t set = 0;
+    for (uint32_t i = 0; i < ERROR_SENTINEL; i++) {
+        set |= (uint32_t)valid_symbols[i] << i;
+    }
+    #ifdef TREE_SITTER_ABAP_KEYWORD_SCANNER
+    for (uint32_t i = 0; i < KEYWORD_COUNT; i++) {
+        if (valid_symbols[KEYWORD_START + i]) {
+            set |= 1u << TREE_SITTER_ABAP_SCANNER_KEYWORD_BIT;
+            break;
+        }
+    }
+    #endif
+
+    stats_branch = TREE_SITTER_ABAP_SCANNER_BRANCH_NONE;
+    bool found = scan(scanner, lexer, valid_symbols);
+    TSAbapScannerCounter* branch = &stats.branches[stats_branch];
+    if (stats_branch == TREE_SITTER_ABAP_SCANNER_BRANCH_NONE) {
+        branch->calls++;
+    }
+    stats.total.calls++;
+    stats.total.tokens += found;
+    stats.total.rejected += !found;
+    branch->tokens += found;
+    branch->rejected += !found;
+    stats.valid_set_calls[set]++;
+    stats.valid_set_tokens[set] += found;
+    return found;
+}
+
+const TSAbapScannerStats* tree_sitter_abap_scanner_stats(void)
+{
+    return &stats;
+}
+
+void tree_sitter_abap_scanner_stats_reset(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+static void add_counter(TSAbapScannerCounter* self,
+                        const TSAbapScannerCounter* other)
+{
+    self->calls += other->calls;
+    self->tokens += other->tokens;
+    self->rejected += other->rejected;
+    self->bytes += other->bytes;
+}
+
+void tree_sitter_abap_scanner_stats_add(TSAbapScannerStats* self,
+                                        const TSAbapScannerStats* other)
+{
+    add_counter(&self->total, &other->total);
+    for (uint32_t i = 0; i < TREE_SITTER_ABAP_SCANNER_BRANCH_COUNT; i++) {
+        add_counter(&self->branches[i], &other->branches[i]);
+    }
+    for (uint32_t i = 0; i < TREE_SITTER_ABAP_SCANNER_VALID_SET_COUNT; i++) {
+        self->valid_set_calls[i] += other->valid_set_calls[i];
+        self->valid_set_tokens[i] += other->valid_set_tokens[i];
+    }
+}
+
+static void write_counter(const TSAbapScannerCounter* counter, FILE* out)
+{
+    fprintf(out,
+            "\"calls\": %llu, \"tokens\": %llu, \"rejected\": %llu, "
+            "\"bytes\": %llu",
+            (unsigned long long)counter->calls,
+            (unsigned long long)counter->tokens,
+            (unsigned long long)counter->rejected,
+            (unsigned long long)counter->bytes);
+}
+
+void tree_sitter_abap_scanner_stats_write_json(const TSAbapScannerStats* self,
+                                               FILE* out)
+{
+    fprintf(out, "{");
+    write_counter(&self->total, out);
+
+    fprintf(out, ", \"branches\": {");
+    bool first = true;
+    for (uint32_t i = 0; i < TREE_SITTER_ABAP_SCANNER_BRANCH_COUNT; i++) {
+        if (self->branches[i].calls == 0) {
+            continue;
+        }
+        fprintf(out, "%s\"%s\": {", first ? "" : ", ", branch_names[i]);
+        write_counter(&self->branches[i], out);
+        fprintf(out, "}");
+        first = false;
+    }
+
+    // Few of the sets ever occur, an insertion sort of those is enough.
+    uint16_t sets[TREE_SITTER_ABAP_SCANNER_VALID_SET_COUNT];
+    uint32_t count = 0;
+    for (uint32_t set = 0; set < TREE_SITTER_ABAP_SCANNER_VALID_SET_COUNT;
+         set++) {
+        uint64_t calls = self->valid_set_calls[set];
+        if (calls == 0) {
+            continue;
+        }
+        uint32_t i = count++;
+        for (; i > 0 && self->valid_set_calls[sets[i - 1]] < calls; i--) {
+            sets[i] = sets[i - 1];
+        }
+        sets[i] = (uint16_t)set;
+    }
+
+    fprintf(out, "}, \"valid_sets\": [");
+    for (uint32_t i = 0; i < count; i++) {
+        fprintf(out, "%s{\"valid\": [", i ? ", " : "");
+        first = true;
+        for (uint32_t bit = 0; bit <= TREE_SITTER_ABAP_SCANNER_KEYWORD_BIT;
+             bit++) {
+            if (sets[i] & (1u << bit)) {
+                fprintf(out, "%s\"%s\"", first ? "" : ", ",
+                        valid_set_names[bit]);
+                first = false;
+            }
+        }
+        fprintf(out, "], \"calls\": %llu, \"tokens\": %llu}",
+                (unsigned long long)self->valid_set_calls[sets[i]],
+                (unsigned long long)self->valid_set_tokens[sets[i]]);
+    }
+    fprintf(out, "]}");
+}
+#endif
+
+/**
+ * Hook to implement our scanner logic in, counted when built with
+ * TREE_SITTER_ABAP_SCANNER_STATS.
+ *
+ * @returns true if a token was found, false otherwise.
+ */
+bool tree_sitter_abap_external_scanner_scan(void* payload, TSLexer* lexer,
+                                            const bool* valid_symbols)
+{
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+    return scan_counted((Scanner*)payload, lexer, valid_symbols);
+#else
+    return scan((Scanner*)payload, lexer, valid_symbols);
+#endif
 }
 
 
@@ -213,7 +1396,7 @@ unsigned tree_sitter_abap_external_scanner_serialize(void* payload,
                                                      char* buffer)
 {
     Scanner* scanner = (Scanner*)payload;
-    buffer[0] = (char)scanner->placeholder;
+    buffer[0] = (char)scanner->comment_run_open;
     return 1;
 }
 
@@ -227,7 +1410,5 @@ void tree_sitter_abap_external_scanner_deserialize(void* payload,
                                                    unsigned length)
 {
     Scanner* scanner = (Scanner*)payload;
-    if (length > 0) {
-        scanner->placeholder = buffer[0];
-    }
+    scanner->comment_run_open = length > 0 && buffer[0];
 }
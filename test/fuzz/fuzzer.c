@@ -0,0 +1,219 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "fuzzer.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+
+/**
+ * The libFuzzer target, see fuzzer.h for what counts as a finding. A
+ * finding is reported on stderr and aborts, so that libFuzzer keeps the
+ * input as a crash and `-minimize_crash=1` can shrink it while it still
+ * breaks the limits.
+ */
+
+// Sizes are kept in front of every block, aligned for any type.
+#define HEADER 16
+
+static TSParser* parser;
+static size_t live_bytes;
+static size_t peak_bytes;
+static AbapFuzzLimits limits;
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static void* counted(char* block, size_t size)
+{
+    if (!block) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size));
+    live_bytes += size;
+    if (live_bytes > peak_bytes) {
+        peak_bytes = live_bytes;
+    }
+    return block + HEADER;
+}
+
+static size_t block_size(void* pointer)
+{
+    size_t size;
+    memcpy(&size, (char*)pointer - HEADER, sizeof(size));
+    return size;
+}
+
+static void* counting_malloc(size_t size)
+{
+    return counted(malloc(size + HEADER), size);
+}
+
+static void* counting_calloc(size_t count, size_t size)
+{
+    return counted(calloc(1, count * size + HEADER), count * size);
+}
+
+static void* counting_realloc(void* pointer, size_t size)
+{
+    if (!pointer) {
+        return counting_malloc(size);
+    }
+    size_t old_size = block_size(pointer);
+    char* block = realloc((char*)pointer - HEADER, size + HEADER);
+    if (!block) {
+        return NULL;
+    }
+    live_bytes -= old_size;
+    return counted(block, size);
+}
+
+static void counting_free(void* pointer)
+{
+    if (pointer) {
+        live_bytes -= block_size(pointer);
+        free((char*)pointer - HEADER);
+    }
+}
+
+void abap_fuzz_init(void)
+{
+    ts_set_allocator(counting_malloc, counting_calloc, counting_realloc,
+                     counting_free);
+    parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+}
+
+static double env_number(const char* name, double fallback)
+{
+    const char* value = getenv(name);
+    if (!value || !*value) {
+        return fallback;
+    }
+    char* end;
+    double number = strtod(value, &end);
+    return *end ? fallback : number;
+}
+
+AbapFuzzLimits abap_fuzz_limits(void)
+{
+    // Tree-sitter parses tens of MB/s, a few times less with sanitizers.
+    // The defaults are far beyond that, a finding is not a slow machine.
+    return (AbapFuzzLimits){
+            .ns_per_byte = env_number("ABAP_FUZZ_NS_PER_BYTE", 5000),
+            .min_ns = (uint64_t)(env_number("ABAP_FUZZ_MIN_MS", 50) * 1e6),
+            .bytes_per_byte = env_number("ABAP_FUZZ_BYTES_PER_BYTE", 4096),
+            .min_bytes = (uint64_t)(env_number("ABAP_FUZZ_MIN_MB", 16) *
+                                    1024 * 1024),
+            .growth = env_number("ABAP_FUZZ_GROWTH", 3.0),
+            .growth_min_ns =
+                    (uint64_t)(env_number("ABAP_FUZZ_GROWTH_MIN_US", 1000) *
+                               1e3),
+    };
+}
+
+typedef struct
+{
+    uint64_t ns;
+    uint64_t peak_bytes;
+} Cost;
+
+/** The fastest of the runs and the peak memory above what was live. */
+static Cost parse_cost(const char* data, uint32_t length, uint32_t runs)
+{
+    Cost cost = {UINT64_MAX, 0};
+    for (uint32_t run = 0; run < runs; run++) {
+        size_t base = live_bytes;
+        peak_bytes = live_bytes;
+        uint64_t start = now_ns();
+        TSTree* tree = ts_parser_parse_string(parser, NULL, data, length);
+        uint64_t ns = now_ns() - start;
+        cost.peak_bytes = peak_bytes - base;
+        ts_tree_delete(tree);
+        if (ns < cost.ns) {
+            cost.ns = ns;
+        }
+    }
+    return cost;
+}
+
+bool abap_fuzz_check(const uint8_t* data, size_t size,
+                     const AbapFuzzLimits* limits, AbapFuzzReport* report)
+{
+    uint32_t length = size < UINT32_MAX / 2 ? (uint32_t)size : UINT32_MAX / 2;
+    const char* source = (const char*)data;
+    Cost once = parse_cost(source, length, 1);
+
+    *report = (AbapFuzzReport){
+            .parse_ns = once.ns,
+            .peak_bytes = once.peak_bytes,
+            .slow = once.ns > limits->min_ns + limits->ns_per_byte * length,
+            .heavy = once.peak_bytes >
+                     limits->min_bytes + limits->bytes_per_byte * length,
+    };
+    if (report->slow || once.ns < limits->growth_min_ns) {
+        return !report->slow && !report->heavy;
+    }
+
+    char* doubled = malloc(2 * (size_t)length + 1);
+    if (doubled) {
+        memcpy(doubled, source, length);
+        doubled[length] = '\n';
+        memcpy(doubled + length + 1, source, length);
+        // Slow enough to be worth it, the fastest of three against noise.
+        once = parse_cost(source, length, 3);
+        Cost twice = parse_cost(doubled, 2 * length + 1, 3);
+        free(doubled);
+        report->time_growth = once.ns ? (double)twice.ns / once.ns : 0.0;
+        report->memory_growth =
+                once.peak_bytes ? (double)twice.peak_bytes / once.peak_bytes
+                                : 0.0;
+        report->superlinear = report->time_growth > limits->growth ||
+                              report->memory_growth > limits->growth;
+    }
+    return !report->heavy && !report->superlinear;
+}
+
+void abap_fuzz_print(FILE* out, size_t size, const AbapFuzzLimits* limits,
+                     const AbapFuzzReport* report)
+{
+    fprintf(out,
+            "%zu bytes: parse %.3f ms (limit %.3f), peak %.1f KB "
+            "(limit %.1f)",
+            size, report->parse_ns / 1e6,
+            (limits->min_ns + limits->ns_per_byte * size) / 1e6,
+            report->peak_bytes / 1024.0,
+            (limits->min_bytes + limits->bytes_per_byte * size) / 1024.0);
+    if (report->time_growth > 0) {
+        fprintf(out, ", twice over %.2fx time %.2fx memory (limit %.2fx)",
+                report->time_growth, report->memory_growth, limits->growth);
+    }
+    fprintf(out, "%s%s%s\n", report->slow ? " SLOW" : "",
+            report->heavy ? " HEAVY" : "",
+            report->superlinear ? " SUPERLINEAR" : "");
+}
+
+int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+    (void)argc;
+    (void)argv;
+    abap_fuzz_init();
+    limits = abap_fuzz_limits();
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    AbapFuzzReport report;
+    if (!abap_fuzz_check(data, size, &limits, &report)) {
+        fprintf(stderr, "==abap-fuzz== ");
+        abap_fuzz_print(stderr, size, &limits, &report);
+        abort();
+    }
+    return 0;
+}
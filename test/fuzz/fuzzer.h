@@ -0,0 +1,71 @@
+#ifndef TREE_SITTER_ABAP_FUZZER_H_
+#define TREE_SITTER_ABAP_FUZZER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Parse cost checks shared by the libFuzzer target and the regression
+ * runner.
+ *
+ * An input is a finding if parsing it takes longer or needs more memory
+ * than its size allows, or if parsing it twice over, the input, a newline
+ * and the input again, costs more than `growth` times as much as parsing
+ * it once. The last catches superlinear behaviour on inputs that are still
+ * too small to break the per byte limits.
+ *
+ * Memory is what the tree-sitter runtime and the scanner allocate, counted
+ * through `ts_set_allocator`, at its peak during the parse and including
+ * the tree. The scanner only allocates through it when compiled with
+ * TREE_SITTER_REUSE_ALLOCATOR.
+ */
+
+typedef struct
+{
+    /** Parse time allowed per input byte, on top of `min_ns`. */
+    double ns_per_byte;
+    uint64_t min_ns;
+    /** Peak memory allowed per input byte, on top of `min_bytes`. */
+    double bytes_per_byte;
+    uint64_t min_bytes;
+    /** Largest cost ratio of parsing the input twice over to once. */
+    double growth;
+    /** Faster parses are not checked for growth, their timing is noise. */
+    uint64_t growth_min_ns;
+} AbapFuzzLimits;
+
+typedef struct
+{
+    uint64_t parse_ns;
+    uint64_t peak_bytes;
+    /** 0 unless the parse was slow enough to be checked. */
+    double time_growth;
+    double memory_growth;
+    bool slow;
+    bool heavy;
+    bool superlinear;
+} AbapFuzzReport;
+
+/**
+ * Installs the counting allocator, before anything else of the runtime is
+ * used.
+ */
+void abap_fuzz_init(void);
+
+/**
+ * The default limits, each overridden by its environment variable if set:
+ * ABAP_FUZZ_NS_PER_BYTE, ABAP_FUZZ_MIN_MS, ABAP_FUZZ_BYTES_PER_BYTE,
+ * ABAP_FUZZ_MIN_MB, ABAP_FUZZ_GROWTH and ABAP_FUZZ_GROWTH_MIN_US.
+ */
+AbapFuzzLimits abap_fuzz_limits(void);
+
+/** Parses the input and returns false if it is a finding. */
+bool abap_fuzz_check(const uint8_t* data, size_t size,
+                     const AbapFuzzLimits* limits, AbapFuzzReport* report);
+
+void abap_fuzz_print(FILE* out, size_t size, const AbapFuzzLimits* limits,
+                     const AbapFuzzReport* report);
+
+#endif // TREE_SITTER_ABAP_FUZZER_H_
@@ -0,0 +1,204 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "fuzzer.h"
+#include "tree_sitter/array.h"
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * Runs the fuzzer checks over the regression corpus, the inputs the fuzzer
+ * once found, and fails if any of them breaks the limits again or the time
+ * or memory budget listed for it.
+ *
+ * A budgets file has one line per input, `name max_ms [max_kb]`, with the
+ * name relative to the corpus directory. Lines starting with `#` are
+ * comments. Inputs without a line only have the limits of the fuzzer.
+ */
+
+typedef struct
+{
+    char* name;
+    double max_ms;
+    double max_kb;
+} Budget;
+
+typedef Array(Budget) BudgetList;
+
+typedef Array(char*) PathList;
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-fuzz-regress [--budgets FILE] path...\n"
+            "\n"
+            "Parses the given files and every file below the given "
+            "directories\n"
+            "and fails if one is a finding of abap-fuzzer or over its "
+            "budget.\n");
+}
+
+static bool read_budgets(const char* path, BudgetList* budgets)
+{
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), file)) {
+        char name[4096];
+        Budget budget = {0};
+        int fields = sscanf(line, "%4095s %lf %lf", name, &budget.max_ms,
+                            &budget.max_kb);
+        if (fields < 2 || name[0] == '#') {
+            continue;
+        }
+        budget.name = malloc(strlen(name) + 1);
+        strcpy(budget.name, name);
+        array_push(budgets, budget);
+    }
+    fclose(file);
+    return true;
+}
+
+static void collect(PathList* paths, const char* path)
+{
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        return;
+    }
+    if (!S_ISDIR(info.st_mode)) {
+        char* copy = malloc(strlen(path) + 1);
+        strcpy(copy, path);
+        array_push(paths, copy);
+        return;
+    }
+
+    DIR* directory = opendir(path);
+    struct dirent* entry;
+    while (directory && (entry = readdir(directory)) != NULL) {
+        // the budgets and notes live next to the inputs
+        const char* name = entry->d_name;
+        size_t length = strlen(name);
+        if (name[0] == '.' || strcmp(name, "budgets") == 0 ||
+            (length > 3 && strcmp(name + length - 3, ".md") == 0)) {
+            continue;
+        }
+        char* child = malloc(strlen(path) + length + 2);
+        sprintf(child, "%s/%s", path, name);
+        collect(paths, child);
+        free(child);
+    }
+    if (directory) {
+        closedir(directory);
+    }
+}
+
+static int compare_paths(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static const Budget* budget_for(const BudgetList* budgets, const char* path)
+{
+    const char* slash = strrchr(path, '/');
+    const char* name = slash ? slash + 1 : path;
+    for (uint32_t i = 0; i < budgets->size; i++) {
+        if (strcmp(budgets->contents[i].name, name) == 0) {
+            return &budgets->contents[i];
+        }
+    }
+    return NULL;
+}
+
+static bool read_input(const char* path, char** data, size_t* size)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    Array(char) buffer = array_new();
+    char chunk[65536];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        array_extend(&buffer, (uint32_t)read, chunk);
+    }
+    fclose(file);
+    *data = buffer.contents;
+    *size = buffer.size;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BudgetList budgets = array_new();
+    PathList paths = array_new();
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--budgets") == 0 && i + 1 < argc) {
+            if (!read_budgets(argv[++i], &budgets)) {
+                fprintf(stderr, "failed to read %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            collect(&paths, argv[i]);
+        }
+    }
+    if (paths.size == 0) {
+        usage(stderr);
+        return 1;
+    }
+    qsort(paths.contents, paths.size, sizeof(char*), compare_paths);
+
+    abap_fuzz_init();
+    AbapFuzzLimits limits = abap_fuzz_limits();
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < paths.size; i++) {
+        const char* path = paths.contents[i];
+        char* data;
+        size_t size;
+        if (!read_input(path, &data, &size)) {
+            fprintf(stderr, "failed to read %s\n", path);
+            failures++;
+            continue;
+        }
+
+        AbapFuzzReport report;
+        bool ok = abap_fuzz_check((const uint8_t*)data, size, &limits,
+                                  &report);
+        const Budget* budget = budget_for(&budgets, path);
+        bool over_budget =
+                budget && (report.parse_ns > budget->max_ms * 1e6 ||
+                           (budget->max_kb > 0 &&
+                            report.peak_bytes > budget->max_kb * 1024));
+        printf("%s %s: ", ok && !over_budget ? "ok  " : "FAIL", path);
+        abap_fuzz_print(stdout, size, &limits, &report);
+        if (over_budget) {
+            printf("     over the budget of %.3f ms", budget->max_ms);
+            if (budget->max_kb > 0) {
+                printf(", %.1f KB", budget->max_kb);
+            }
+            printf("\n");
+        }
+        failures += !ok || over_budget;
+        free(data);
+    }
+
+    printf("%u of %u inputs failed\n", failures, paths.size);
+    for (uint32_t i = 0; i < paths.size; i++) {
+        free(paths.contents[i]);
+    }
+    for (uint32_t i = 0; i < budgets.size; i++) {
+        free(budgets.contents[i].name);
+    }
+    array_delete(&paths);
+    array_delete(&budgets);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,634 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-abap-bulk.h"
+#include "tree_sitter/array.h"
+#include "tree_sitter/tree-sitter-abap-cache.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <tree_sitter/api.h>
+#include <unistd.h>
+
+/**
+ * Bulk parsing.
+ *
+ * The sorted file list is split into one contiguous range per worker. A
+ * worker takes files from the front of its own range and, once that is
+ * empty, steals the back half of the largest remaining range of another
+ * worker. Files are the unit of work, so the queues are guarded by a mutex
+ * each: a lock per file is nothing against parsing it, and a worker only
+ * touches the locks of others when it runs dry.
+ *
+ * Every worker owns its parser, query cursor and read buffer for the whole
+ * run. The query is compiled once and shared, queries are immutable once
+ * compiled.
+ *
+ * With a cache, every file is still read, its content is the key. A hit
+ * takes the statistics from the cached CST and the capture count from the
+ * cached query results, a miss is parsed and stored.
+ *
+ * The scanner counters are per thread, so a worker resets them before each
+ * parse and sums them up in its own copy, the copies are added up after
+ * the threads are joined.
+ */
+
+typedef Array(char*) PathList;
+
+typedef Array(char) Buffer;
+
+typedef Array(TSAbapCacheCapture) CaptureList;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    uint32_t next;
+    uint32_t end;
+} WorkQueue;
+
+typedef struct Bulk Bulk;
+
+typedef struct
+{
+    Bulk* bulk;
+    WorkQueue queue;
+    pthread_t thread;
+    TSParser* parser;
+    TSQueryCursor* cursor;
+    Buffer buffer;
+    CaptureList captures;
+    uint64_t deadline_ns;
+    TSAbapBulkSummary summary;
+    TSAbapScannerStats* scanner_stats;
+} Worker;
+
+struct Bulk
+{
+    const TSAbapBulkOptions* options;
+    PathList paths;
+    TSQuery* query;
+    TSAbapCache* cache;
+    TSAbapCacheKey query_key;
+    Worker* workers;
+    uint32_t worker_count;
+};
+
+typedef struct
+{
+    const char* data;
+    uint32_t length;
+} StringInput;
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static bool has_suffix(const char* name, const char* suffix)
+{
+    size_t length = strlen(name);
+    size_t suffix_length = strlen(suffix);
+    return length >= suffix_length &&
+           strcmp(name + length - suffix_length, suffix) == 0;
+}
+
+/**
+ * Adds the `.abap` files below `path` to `paths`. Directories that can not
+ * be opened are left out.
+ *
+ * @returns false if out of memory.
+ */
+static bool collect_directory(PathList* paths, const char* path)
+{
+    DIR* directory = opendir(path);
+    if (!directory) {
+        return true;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        size_t length = strlen(path) + strlen(entry->d_name) + 2;
+        char* child = malloc(length);
+        if (!child) {
+            closedir(directory);
+            return false;
+        }
+        snprintf(child, length, "%s/%s", path, entry->d_name);
+
+        // Not following links to directories keeps link cycles from making
+        // the walk endless, links to files are followed.
+        struct stat info;
+        if (lstat(child, &info) != 0) {
+            // removed while walking
+        } else if (S_ISDIR(info.st_mode)) {
+            if (!collect_directory(paths, child)) {
+                free(child);
+                closedir(directory);
+                return false;
+            }
+        } else if (has_suffix(child, ".abap") &&
+                   (S_ISREG(info.st_mode) ||
+                    (S_ISLNK(info.st_mode) && stat(child, &info) == 0 &&
+                     S_ISREG(info.st_mode)))) {
+            array_push(paths, child);
+            continue;
+        }
+        free(child);
+    }
+    closedir(directory);
+    return true;
+}
+
+static int compare_paths(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static bool collect_paths(PathList* paths, const char* const* roots,
+                          uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        struct stat info;
+        if (stat(roots[i], &info) != 0) {
+            fprintf(stderr, "no such file or directory: %s\n", roots[i]);
+            return false;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            if (!collect_directory(paths, roots[i])) {
+                fprintf(stderr, "out of memory collecting %s\n", roots[i]);
+                return false;
+            }
+        } else {
+            char* path = malloc(strlen(roots[i]) + 1);
+            if (!path) {
+                fprintf(stderr, "out of memory collecting %s\n", roots[i]);
+                return false;
+            }
+            strcpy(path, roots[i]);
+            array_push(paths, path);
+        }
+    }
+    // Sorted so that a run is reproducible and neighbouring files of the
+    // same package end up with the same worker.
+    if (paths->size > 1) {
+        qsort(paths->contents, paths->size, sizeof(char*), compare_paths);
+    }
+    return true;
+}
+
+static bool read_file(const char* path, Buffer* buffer)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    array_clear(buffer);
+    char chunk[65536];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        array_extend(buffer, (uint32_t)read, chunk);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+static const char* read_string(void* payload, uint32_t byte_index,
+                               TSPoint position, uint32_t* bytes_read)
+{
+    (void)position;
+    const StringInput* input = payload;
+    if (byte_index >= input->length) {
+        *bytes_read = 0;
+        return "";
+    }
+    *bytes_read = input->length - byte_index;
+    return input->data + byte_index;
+}
+
+static bool past_deadline(TSParseState* state)
+{
+    const Worker* worker = state->payload;
+    return now_ns() >= worker->deadline_ns;
+}
+
+static void tree_stats(const TSTree* tree, TSAbapBulkFileResult* result)
+{
+    TSTreeCursor cursor = ts_tree_cursor_new(ts_tree_root_node(tree));
+    uint32_t depth = 0;
+
+    for (;;) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        result->nodes++;
+        result->errors += ts_node_is_error(node);
+        result->missing += ts_node_is_missing(node);
+        if (depth > result->max_depth) {
+            result->max_depth = depth;
+        }
+
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            depth++;
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return;
+            }
+            depth--;
+        }
+    }
+}
+
+static void keep_captures(CaptureList* captures, const TSQueryMatch* match)
+{
+    for (uint16_t i = 0; i < match->capture_count; i++) {
+        TSNode node = match->captures[i].node;
+        TSAbapCacheCapture capture = {
+                .pattern_index = match->pattern_index,
+                .capture_index = match->captures[i].index,
+                .start_byte = ts_node_start_byte(node),
+                .end_byte = ts_node_end_byte(node),
+        };
+        array_push(captures, capture);
+    }
+}
+
+/** The same statistics as tree_stats, from the columns of a CST. */
+static void cst_stats(const TSAbapCstColumns* columns,
+                      TSAbapBulkFileResult* result)
+{
+    uint32_t depth = 0;
+    uint32_t node = 0;
+    result->nodes = columns->node_count;
+
+    for (;;) {
+        uint16_t flags = columns->flags[node];
+        result->errors += (flags & TREE_SITTER_ABAP_CST_ERROR) != 0;
+        result->missing += (flags & TREE_SITTER_ABAP_CST_MISSING) != 0;
+        if (depth > result->max_depth) {
+            result->max_depth = depth;
+        }
+
+        if (columns->first_child[node] != TREE_SITTER_ABAP_CST_NONE) {
+            node = columns->first_child[node];
+            depth++;
+            continue;
+        }
+        while (columns->next_sibling[node] == TREE_SITTER_ABAP_CST_NONE) {
+            node = columns->parent[node];
+            if (node == TREE_SITTER_ABAP_CST_NONE) {
+                return;
+            }
+            depth--;
+        }
+        node = columns->next_sibling[node];
+    }
+}
+
+/**
+ * Fills in the result from the cache, false on a miss. The key of the file
+ * is kept for storing it after the parse.
+ */
+static bool load_cached(Worker* worker, TSAbapCacheKey* key,
+                        TSAbapBulkFileResult* result)
+{
+    const Bulk* bulk = worker->bulk;
+    *key = tree_sitter_abap_cache_key(bulk->cache, worker->buffer.contents,
+                                      worker->buffer.size);
+    TSAbapCst* cst = tree_sitter_abap_cache_get_tree(
+            bulk->cache, *key, worker->buffer.contents, worker->buffer.size);
+    if (!cst) {
+        return false;
+    }
+    if (bulk->query) {
+        TSAbapCacheCapture* captures;
+        uint32_t count;
+        if (!tree_sitter_abap_cache_get_captures(bulk->cache, *key,
+                                                 bulk->query_key, &captures,
+                                                 &count)) {
+            tree_sitter_abap_cst_close(cst);
+            return false;
+        }
+        result->captures = count;
+        free(captures);
+    }
+    cst_stats(tree_sitter_abap_cst_columns(cst), result);
+    tree_sitter_abap_cst_close(cst);
+    return true;
+}
+
+static void parse_file(Worker* worker, uint32_t index)
+{
+    const Bulk* bulk = worker->bulk;
+    const TSAbapBulkOptions* options = bulk->options;
+    TSAbapBulkFileResult result = {.path = bulk->paths.contents[index]};
+
+    TSAbapCacheKey key = {0};
+    if (!read_file(result.path, &worker->buffer)) {
+        result.unreadable = true;
+        worker->summary.unreadable++;
+    } else if (bulk->cache && load_cached(worker, &key, &result)) {
+        result.bytes = worker->buffer.size;
+        result.cached = true;
+        worker->summary.cache_hits++;
+        worker->summary.bytes += result.bytes;
+        worker->summary.files_with_errors += result.errors + result.missing >
+                                             0;
+    } else {
+        StringInput string = {worker->buffer.contents, worker->buffer.size};
+        TSInput input = {
+                .payload = &string,
+                .read = read_string,
+                .encoding = TSInputEncodingUTF8,
+        };
+        TSParseOptions parse_options = {0};
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+        if (worker->scanner_stats) {
+            tree_sitter_abap_scanner_stats_reset();
+        }
+#endif
+        uint64_t start = now_ns();
+        if (options->timeout_micros > 0) {
+            worker->deadline_ns = start + options->timeout_micros * 1000;
+            parse_options.payload = worker;
+            parse_options.progress_callback = past_deadline;
+        }
+        TSTree* tree = ts_parser_parse_with_options(worker->parser, NULL,
+                                                    input, parse_options);
+        result.parse_ns = now_ns() - start;
+        result.bytes = string.length;
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+        if (worker->scanner_stats) {
+            result.scanner_stats = tree_sitter_abap_scanner_stats();
+            tree_sitter_abap_scanner_stats_add(worker->scanner_stats,
+                                               result.scanner_stats);
+        }
+#endif
+
+        if (tree) {
+            tree_stats(tree, &result);
+            if (bulk->query) {
+                ts_query_cursor_exec(worker->cursor, bulk->query,
+                                     ts_tree_root_node(tree));
+                array_clear(&worker->captures);
+                TSQueryMatch match;
+                while (ts_query_cursor_next_match(worker->cursor, &match)) {
+                    result.captures += match.capture_count;
+                    if (bulk->cache) {
+                        keep_captures(&worker->captures, &match);
+                    }
+                }
+            }
+            if (bulk->cache) {
+                tree_sitter_abap_cache_put_tree(bulk->cache, key, tree,
+                                                string.data, string.length);
+                if (bulk->query) {
+                    tree_sitter_abap_cache_put_captures(
+                            bulk->cache, key, bulk->query_key,
+                            worker->captures.contents, worker->captures.size);
+                }
+            }
+            ts_tree_delete(tree);
+        } else {
+            // A cancelled parse is resumed by the next call unless reset.
+            ts_parser_reset(worker->parser);
+            result.timed_out = true;
+            worker->summary.timed_out++;
+        }
+
+        worker->summary.bytes += result.bytes;
+        worker->summary.parse_ns += result.parse_ns;
+        worker->summary.files_with_errors += result.errors + result.missing >
+                                             0;
+    }
+
+    worker->summary.files++;
+    if (options->callback) {
+        options->callback(options->payload, index, &result);
+    }
+}
+
+static bool take_own(Worker* worker, uint32_t* index)
+{
+    bool found = false;
+    pthread_mutex_lock(&worker->queue.lock);
+    if (worker->queue.next < worker->queue.end) {
+        *index = worker->queue.next++;
+        found = true;
+    }
+    pthread_mutex_unlock(&worker->queue.lock);
+    return found;
+}
+
+/**
+ * Moves the back half of the largest remaining range of another worker to
+ * the thief and returns its first file. False once every queue is empty.
+ */
+static bool steal(Worker* thief, uint32_t* index)
+{
+    Bulk* bulk = thief->bulk;
+    for (;;) {
+        Worker* victim = NULL;
+        uint32_t largest = 0;
+        for (uint32_t i = 0; i < bulk->worker_count; i++) {
+            Worker* other = &bulk->workers[i];
+            if (other == thief) {
+                continue;
+            }
+            pthread_mutex_lock(&other->queue.lock);
+            uint32_t remaining = other->queue.end - other->queue.next;
+            pthread_mutex_unlock(&other->queue.lock);
+            if (remaining > largest) {
+                largest = remaining;
+                victim = other;
+            }
+        }
+        if (!victim) {
+            return false;
+        }
+
+        pthread_mutex_lock(&victim->queue.lock);
+        uint32_t remaining = victim->queue.end - victim->queue.next;
+        uint32_t count = (remaining + 1) / 2;
+        uint32_t start = victim->queue.end - count;
+        victim->queue.end = start;
+        pthread_mutex_unlock(&victim->queue.lock);
+        if (count == 0) {
+            // Emptied by its owner or another thief in the meantime.
+            continue;
+        }
+
+        pthread_mutex_lock(&thief->queue.lock);
+        thief->queue.next = start + 1;
+        thief->queue.end = start + count;
+        pthread_mutex_unlock(&thief->queue.lock);
+        thief->summary.stolen += count;
+        *index = start;
+        return true;
+    }
+}
+
+static void* run_worker(void* payload)
+{
+    Worker* worker = payload;
+    uint32_t index;
+    while (take_own(worker, &index) || steal(worker, &index)) {
+        parse_file(worker, index);
+    }
+    return NULL;
+}
+
+static uint32_t thread_count(const TSAbapBulkOptions* options, uint32_t files)
+{
+    uint32_t threads = options->threads;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (threads > files) {
+        threads = files;
+    }
+    return threads > 0 ? threads : 1;
+}
+
+bool tree_sitter_abap_bulk_parse(const char* const* paths, uint32_t count,
+                                 const TSAbapBulkOptions* options,
+                                 TSAbapBulkSummary* summary)
+{
+    Bulk bulk = {.options = options};
+    *summary = (TSAbapBulkSummary){0};
+    bool ok = collect_paths(&bulk.paths, paths, count);
+
+    if (ok && options->query) {
+        uint32_t error_offset;
+        TSQueryError error_type;
+        bulk.query = ts_query_new(tree_sitter_abap(), options->query,
+                                  options->query_length, &error_offset,
+                                  &error_type);
+        if (!bulk.query) {
+            fprintf(stderr, "query error %d at offset %u\n", (int)error_type,
+                    error_offset);
+            ok = false;
+        }
+    }
+
+    if (ok && options->cache_directory) {
+        bulk.cache = tree_sitter_abap_cache_open(options->cache_directory,
+                                                 options->cache_max_bytes);
+        ok = bulk.cache != NULL;
+        if (ok && options->query) {
+            bulk.query_key = tree_sitter_abap_cache_key(
+                    bulk.cache, options->query, options->query_length);
+        }
+    }
+
+    if (ok) {
+        bulk.worker_count = thread_count(options, bulk.paths.size);
+        bulk.workers = calloc(bulk.worker_count, sizeof(Worker));
+        if (!bulk.workers) {
+            fprintf(stderr, "out of memory starting %u workers\n",
+                    bulk.worker_count);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        uint32_t files = bulk.paths.size;
+        for (uint32_t i = 0; i < bulk.worker_count; i++) {
+            Worker* worker = &bulk.workers[i];
+            worker->bulk = &bulk;
+            pthread_mutex_init(&worker->queue.lock, NULL);
+            worker->queue.next =
+                    (uint32_t)((uint64_t)files * i / bulk.worker_count);
+            worker->queue.end =
+                    (uint32_t)((uint64_t)files * (i + 1) / bulk.worker_count);
+            worker->parser = ts_parser_new();
+            ts_parser_set_language(worker->parser, tree_sitter_abap());
+            worker->cursor = ts_query_cursor_new();
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+            if (options->scanner_stats) {
+                worker->scanner_stats = calloc(1, sizeof(TSAbapScannerStats));
+            }
+#endif
+        }
+
+        // The calling thread is the first worker. The ranges of the
+        // threads that could not be started are left to be stolen, down to
+        // the calling thread parsing all of them.
+        uint64_t start = now_ns();
+        uint32_t started = 1;
+        while (started < bulk.worker_count &&
+               pthread_create(&bulk.workers[started].thread, NULL, run_worker,
+                              &bulk.workers[started]) == 0) {
+            started++;
+        }
+        run_worker(&bulk.workers[0]);
+        for (uint32_t i = 1; i < started; i++) {
+            pthread_join(bulk.workers[i].thread, NULL);
+        }
+        summary->wall_ns = now_ns() - start;
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+        if (options->scanner_stats) {
+            memset(options->scanner_stats, 0, sizeof(TSAbapScannerStats));
+        }
+#endif
+
+        for (uint32_t i = 0; i < bulk.worker_count; i++) {
+            Worker* worker = &bulk.workers[i];
+            summary->files += worker->summary.files;
+            summary->bytes += worker->summary.bytes;
+            summary->parse_ns += worker->summary.parse_ns;
+            summary->files_with_errors += worker->summary.files_with_errors;
+            summary->timed_out += worker->summary.timed_out;
+            summary->unreadable += worker->summary.unreadable;
+            summary->stolen += worker->summary.stolen;
+            summary->cache_hits += worker->summary.cache_hits;
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+            if (worker->scanner_stats) {
+                tree_sitter_abap_scanner_stats_add(options->scanner_stats,
+                                                   worker->scanner_stats);
+                free(worker->scanner_stats);
+            }
+#endif
+
+            ts_query_cursor_delete(worker->cursor);
+            ts_parser_delete(worker->parser);
+            array_delete(&worker->buffer);
+            array_delete(&worker->captures);
+            pthread_mutex_destroy(&worker->queue.lock);
+        }
+        free(bulk.workers);
+    }
+
+    if (bulk.cache) {
+        // Trimmed here rather than on close, so that the evictions are
+        // part of the summary.
+        if (options->cache_max_bytes > 0) {
+            tree_sitter_abap_cache_trim(bulk.cache);
+        }
+        TSAbapCacheStats stats;
+        tree_sitter_abap_cache_stats(bulk.cache, &stats);
+        summary->cache_lookup_ns = stats.lookup_ns;
+        summary->cache_stores = (uint32_t)stats.stores;
+        summary->cache_evictions = (uint32_t)stats.evictions;
+        tree_sitter_abap_cache_close(bulk.cache);
+    }
+    if (bulk.query) {
+        ts_query_delete(bulk.query);
+    }
+    for (uint32_t i = 0; i < bulk.paths.size; i++) {
+        free(bulk.paths.contents[i]);
+    }
+    array_delete(&bulk.paths);
+    return ok;
+}
@@ -0,0 +1,539 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-abap-cache.h"
+#include "tree_sitter/array.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * The parse result cache, see tree-sitter-abap-cache.h.
+ *
+ * The layout of the directory is
+ *
+ *   lock                               taken by the process trimming
+ *   <abi>-<grammar hash>/<hh>/<key>.cst
+ *   <abi>-<grammar hash>/<hh>/<key>-<query key>.captures
+ *
+ * with <hh> the first byte of the key, so that no directory grows beyond a
+ * few thousand entries. Entries are never changed in place: a store writes
+ * a temporary file next to the entry and renames it over, and eviction
+ * unlinks. A reader that already has an entry open or mapped keeps it.
+ */
+
+#define CAPTURES_MAGIC "ABAPCAP"
+#define CAPTURES_VERSION 1
+#define TEMPORARY_PREFIX ".tmp-"
+// Temporary files this old were left behind by a process that died.
+#define STALE_TEMPORARY_SECONDS 3600
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t key[2];
+    uint64_t query[2];
+} CapturesHeader;
+
+_Static_assert(sizeof(CapturesHeader) == 48, "the header is 48 bytes");
+
+struct TSAbapCache
+{
+    char* directory;
+    char* grammar_directory;
+    uint64_t max_bytes;
+    atomic_uint_fast64_t written_since_trim;
+    atomic_uint_fast64_t lookups;
+    atomic_uint_fast64_t hits;
+    atomic_uint_fast64_t lookup_ns;
+    atomic_uint_fast64_t stores;
+    atomic_uint_fast64_t stored_bytes;
+    atomic_uint_fast64_t evictions;
+    atomic_uint_fast64_t evicted_bytes;
+};
+
+typedef struct
+{
+    char* path;
+    uint64_t size;
+    struct timespec modified;
+} Entry;
+
+typedef Array(Entry) EntryList;
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t rotl64(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t fmix64(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+/**
+ * MurmurHash3 x64 128. Runs at several GB/s, far beyond the parser, and
+ * 128 bits keep the chance of two sources of a corpus sharing a key out of
+ * the picture. Tree entries are compared with the source regardless.
+ */
+static TSAbapCacheKey murmur3_128(const char* data, size_t length)
+{
+    const uint64_t c1 = 0x87c37b91114253d5ull;
+    const uint64_t c2 = 0x4cf5ad432745937full;
+    const unsigned char* bytes = (const unsigned char*)data;
+    size_t blocks = length / 16;
+    uint64_t h1 = 0;
+    uint64_t h2 = 0;
+
+    for (size_t i = 0; i < blocks; i++) {
+        uint64_t k1;
+        uint64_t k2;
+        memcpy(&k1, bytes + 16 * i, 8);
+        memcpy(&k2, bytes + 16 * i + 8, 8);
+
+        k1 *= c1;
+        k1 = rotl64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = rotl64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = rotl64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = rotl64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const unsigned char* tail = bytes + 16 * blocks;
+    size_t rest = length & 15;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = rest; i > 8; i--) {
+        k2 |= (uint64_t)tail[i - 1] << (8 * (i - 9));
+    }
+    for (size_t i = rest < 8 ? rest : 8; i > 0; i--) {
+        k1 |= (uint64_t)tail[i - 1] << (8 * (i - 1));
+    }
+    if (rest > 8) {
+        k2 *= c2;
+        k2 = rotl64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+    if (rest > 0) {
+        k1 *= c1;
+        k1 = rotl64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+
+    h1 ^= length;
+    h2 ^= length;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    return (TSAbapCacheKey){h1, h2};
+}
+
+static char* join(const char* directory, const char* name)
+{
+    size_t length = strlen(directory) + strlen(name) + 2;
+    char* path = malloc(length);
+    if (path) {
+        snprintf(path, length, "%s/%s", directory, name);
+    }
+    return path;
+}
+
+static bool make_directory(const char* path)
+{
+    return mkdir(path, 0777) == 0 || errno == EEXIST;
+}
+
+/** The path of an entry, with its <hh> directory created. */
+static char* entry_path(const TSAbapCache* self, TSAbapCacheKey key,
+                        const TSAbapCacheKey* query)
+{
+    char name[128];
+    snprintf(name, sizeof(name), "%02x", (unsigned)(key.high >> 56));
+    char* directory = join(self->grammar_directory, name);
+    if (!directory || !make_directory(directory)) {
+        free(directory);
+        return NULL;
+    }
+    if (query) {
+        snprintf(name, sizeof(name), "%016llx%016llx-%016llx%016llx.captures",
+                 (unsigned long long)key.high, (unsigned long long)key.low,
+                 (unsigned long long)query->high,
+                 (unsigned long long)query->low);
+    } else {
+        snprintf(name, sizeof(name), "%016llx%016llx.cst",
+                 (unsigned long long)key.high, (unsigned long long)key.low);
+    }
+    char* path = join(directory, name);
+    free(directory);
+    return path;
+}
+
+TSAbapCache* tree_sitter_abap_cache_open(const char* directory,
+                                         uint64_t max_bytes)
+{
+    const TSLanguage* language = tree_sitter_abap();
+    char name[64];
+    snprintf(name, sizeof(name), "%u-%016llx",
+             ts_language_abi_version(language),
+             (unsigned long long)tree_sitter_abap_cst_grammar_hash(language));
+
+    TSAbapCache* self = calloc(1, sizeof(TSAbapCache));
+    if (self) {
+        self->directory = strdup(directory);
+        self->grammar_directory = join(directory, name);
+        self->max_bytes = max_bytes;
+    }
+    if (!self || !self->directory || !self->grammar_directory ||
+        !make_directory(directory) ||
+        !make_directory(self->grammar_directory)) {
+        fprintf(stderr, "failed to create the cache directory %s\n",
+                directory);
+        if (self) {
+            free(self->directory);
+            free(self->grammar_directory);
+            free(self);
+        }
+        return NULL;
+    }
+    return self;
+}
+
+void tree_sitter_abap_cache_close(TSAbapCache* self)
+{
+    if (!self) {
+        return;
+    }
+    if (self->max_bytes > 0 && atomic_load(&self->written_since_trim) > 0) {
+        tree_sitter_abap_cache_trim(self);
+    }
+    free(self->directory);
+    free(self->grammar_directory);
+    free(self);
+}
+
+TSAbapCacheKey tree_sitter_abap_cache_key(TSAbapCache* self, const char* data,
+                                          uint32_t length)
+{
+    uint64_t start = now_ns();
+    TSAbapCacheKey key = murmur3_128(data, length);
+    atomic_fetch_add(&self->lookup_ns, now_ns() - start);
+    return key;
+}
+
+/** Marks the entry as used for eviction, see trim. */
+static void touch(const char* path)
+{
+    utimensat(AT_FDCWD, path, NULL, 0);
+}
+
+static void count_lookup(TSAbapCache* self, uint64_t start, bool hit)
+{
+    atomic_fetch_add(&self->lookups, 1);
+    atomic_fetch_add(&self->hits, hit);
+    atomic_fetch_add(&self->lookup_ns, now_ns() - start);
+}
+
+TSAbapCst* tree_sitter_abap_cache_get_tree(TSAbapCache* self,
+                                           TSAbapCacheKey key,
+                                           const char* source,
+                                           uint32_t length)
+{
+    uint64_t start = now_ns();
+    char* path = entry_path(self, key, NULL);
+    TSAbapCstStatus status = TREE_SITTER_ABAP_CST_IO_ERROR;
+    TSAbapCst* cst = path ? tree_sitter_abap_cst_open(path, &status) : NULL;
+    if (cst) {
+        const TSAbapCstColumns* columns = tree_sitter_abap_cst_columns(cst);
+        if (!columns->source || columns->source_length != length ||
+            memcmp(columns->source, source, length) != 0) {
+            tree_sitter_abap_cst_close(cst);
+            cst = NULL;
+        } else {
+            touch(path);
+        }
+    } else if (path && status != TREE_SITTER_ABAP_CST_IO_ERROR) {
+        // Cut short by a crash or written by another format version, it is
+        // replaced by the next store anyway.
+        unlink(path);
+    }
+    free(path);
+    count_lookup(self, start, cst != NULL);
+    return cst;
+}
+
+/** Writes the entry to a temporary file and renames it into place. */
+static bool store(TSAbapCache* self, const char* path, const void* header,
+                  size_t header_size, const void* data, size_t size)
+{
+    const char* slash = strrchr(path, '/');
+    size_t directory_length = (size_t)(slash - path);
+    size_t length = directory_length + sizeof("/" TEMPORARY_PREFIX "XXXXXX");
+    char* temporary = malloc(length);
+    if (!temporary) {
+        return false;
+    }
+    snprintf(temporary, length, "%.*s/" TEMPORARY_PREFIX "XXXXXX",
+             (int)directory_length, path);
+
+    int file = mkstemp(temporary);
+    bool ok = file >= 0;
+    if (ok) {
+        FILE* out = fdopen(file, "wb");
+        ok = out && fwrite(header, 1, header_size, out) == header_size &&
+             (size == 0 || fwrite(data, 1, size, out) == size);
+        if (out) {
+            ok &= fclose(out) == 0;
+        } else {
+            close(file);
+        }
+        ok = ok && chmod(temporary, 0644) == 0 && rename(temporary, path) == 0;
+        if (!ok) {
+            unlink(temporary);
+        }
+    }
+    free(temporary);
+
+    if (ok) {
+        uint64_t bytes = header_size + size;
+        atomic_fetch_add(&self->stores, 1);
+        atomic_fetch_add(&self->stored_bytes, bytes);
+        uint64_t written =
+                atomic_fetch_add(&self->written_since_trim, bytes) + bytes;
+        if (self->max_bytes > 0 && written >= self->max_bytes / 8) {
+            atomic_store(&self->written_since_trim, 0);
+            tree_sitter_abap_cache_trim(self);
+        }
+    }
+    return ok;
+}
+
+bool tree_sitter_abap_cache_put_tree(TSAbapCache* self, TSAbapCacheKey key,
+                                     const TSTree* tree, const char* source,
+                                     uint32_t length)
+{
+    char* path = entry_path(self, key, NULL);
+    size_t size;
+    void* data = path ? tree_sitter_abap_cst_serialize(tree, source, length,
+                                                       &size)
+                      : NULL;
+    // A CST file is its own header.
+    bool ok = data && store(self, path, data, size, NULL, 0);
+    free(data);
+    free(path);
+    return ok;
+}
+
+bool tree_sitter_abap_cache_get_captures(TSAbapCache* self,
+                                         TSAbapCacheKey key,
+                                         TSAbapCacheKey query,
+                                         TSAbapCacheCapture** captures,
+                                         uint32_t* count)
+{
+    uint64_t start = now_ns();
+    char* path = entry_path(self, key, &query);
+    FILE* file = path ? fopen(path, "rb") : NULL;
+    CapturesHeader header;
+    struct stat info;
+    bool ok = file && fread(&header, sizeof(header), 1, file) == 1 &&
+              fstat(fileno(file), &info) == 0 &&
+              memcmp(header.magic, CAPTURES_MAGIC, sizeof(header.magic)) == 0 &&
+              header.version == CAPTURES_VERSION &&
+              header.key[0] == key.low && header.key[1] == key.high &&
+              header.query[0] == query.low && header.query[1] == query.high &&
+              (uint64_t)info.st_size ==
+                      sizeof(header) +
+                              (uint64_t)header.count * sizeof(**captures);
+
+    *captures = NULL;
+    *count = 0;
+    if (ok && header.count > 0) {
+        *captures = malloc(header.count * sizeof(**captures));
+        ok = *captures && fread(*captures, sizeof(**captures), header.count,
+                                file) == header.count;
+        if (!ok) {
+            free(*captures);
+            *captures = NULL;
+        }
+    }
+    if (file) {
+        fclose(file);
+        if (ok) {
+            *count = header.count;
+            touch(path);
+        } else {
+            unlink(path);
+        }
+    }
+    free(path);
+    count_lookup(self, start, ok);
+    return ok;
+}
+
+bool tree_sitter_abap_cache_put_captures(TSAbapCache* self,
+                                         TSAbapCacheKey key,
+                                         TSAbapCacheKey query,
+                                         const TSAbapCacheCapture* captures,
+                                         uint32_t count)
+{
+    char* path = entry_path(self, key, &query);
+    CapturesHeader header = {
+            .magic = CAPTURES_MAGIC,
+            .version = CAPTURES_VERSION,
+            .count = count,
+            .key = {key.low, key.high},
+            .query = {query.low, query.high},
+    };
+    bool ok = path && store(self, path, &header, sizeof(header), captures,
+                            count * sizeof(*captures));
+    free(path);
+    return ok;
+}
+
+static void collect_entries(EntryList* entries, const char* path,
+                            time_t stale_before)
+{
+    DIR* directory = opendir(path);
+    if (!directory) {
+        return;
+    }
+
+    struct dirent* dirent;
+    while ((dirent = readdir(directory)) != NULL) {
+        const char* name = dirent->d_name;
+        bool temporary = strncmp(name, TEMPORARY_PREFIX,
+                                 strlen(TEMPORARY_PREFIX)) == 0;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0 ||
+            strcmp(name, "lock") == 0) {
+            continue;
+        }
+        char* child = join(path, name);
+        struct stat info;
+        if (!child || lstat(child, &info) != 0) {
+            // removed by another process while walking
+        } else if (S_ISDIR(info.st_mode)) {
+            collect_entries(entries, child, stale_before);
+        } else if (temporary) {
+            if (info.st_mtime < stale_before) {
+                unlink(child);
+            }
+        } else if (S_ISREG(info.st_mode)) {
+            Entry entry = {child, (uint64_t)info.st_size, info.st_mtim};
+            array_push(entries, entry);
+            continue;
+        }
+        free(child);
+    }
+    closedir(directory);
+}
+
+static int compare_entries(const void* a, const void* b)
+{
+    const struct timespec* left = &((const Entry*)a)->modified;
+    const struct timespec* right = &((const Entry*)b)->modified;
+    if (left->tv_sec != right->tv_sec) {
+        return left->tv_sec < right->tv_sec ? -1 : 1;
+    }
+    if (left->tv_nsec != right->tv_nsec) {
+        return left->tv_nsec < right->tv_nsec ? -1 : 1;
+    }
+    return 0;
+}
+
+bool tree_sitter_abap_cache_trim(TSAbapCache* self)
+{
+    char* lock_path = join(self->directory, "lock");
+    int lock = lock_path ? open(lock_path, O_RDWR | O_CREAT, 0666) : -1;
+    free(lock_path);
+    // A lock per open file, so that threads of this process exclude each
+    // other as well.
+    if (lock < 0 || flock(lock, LOCK_EX | LOCK_NB) != 0) {
+        if (lock >= 0) {
+            close(lock);
+        }
+        return false;
+    }
+
+    atomic_store(&self->written_since_trim, 0);
+    EntryList entries = array_new();
+    collect_entries(&entries, self->directory,
+                    time(NULL) - STALE_TEMPORARY_SECONDS);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < entries.size; i++) {
+        total += entries.contents[i].size;
+    }
+
+    if (self->max_bytes > 0 && total > self->max_bytes) {
+        if (entries.size > 1) {
+            qsort(entries.contents, entries.size, sizeof(Entry),
+                  compare_entries);
+        }
+        // Down to a low-water mark, or every store would trim again.
+        uint64_t target = self->max_bytes - self->max_bytes / 8;
+        for (uint32_t i = 0; i < entries.size && total > target; i++) {
+            const Entry* entry = &entries.contents[i];
+            if (unlink(entry->path) == 0) {
+                atomic_fetch_add(&self->evictions, 1);
+                atomic_fetch_add(&self->evicted_bytes, entry->size);
+            }
+            total -= entry->size;
+        }
+    }
+
+    for (uint32_t i = 0; i < entries.size; i++) {
+        free(entries.contents[i].path);
+    }
+    array_delete(&entries);
+    flock(lock, LOCK_UN);
+    close(lock);
+    return true;
+}
+
+void tree_sitter_abap_cache_stats(const TSAbapCache* self,
+                                  TSAbapCacheStats* stats)
+{
+    *stats = (TSAbapCacheStats){
+            .lookups = atomic_load(&self->lookups),
+            .hits = atomic_load(&self->hits),
+            .lookup_ns = atomic_load(&self->lookup_ns),
+            .stores = atomic_load(&self->stores),
+            .stored_bytes = atomic_load(&self->stored_bytes),
+            .evictions = atomic_load(&self->evictions),
+            .evicted_bytes = atomic_load(&self->evicted_bytes),
+    };
+}
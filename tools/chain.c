@@ -0,0 +1,449 @@
+#include "tree_sitter/tree-sitter-abap-chain.h"
+#include "source_scanner.h"
+#include "tree_sitter/array.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Chain expansion.
+ *
+ * One pass over the source finds the statement ends the way chunked parsing
+ * does, see source_scanner.h, and records the colon of each statement and
+ * the commas after it that are not inside parentheses. A chained statement
+ * `prefix: part, part, part.` is written out as `prefix part.` once per
+ * part, everything else is copied as it is.
+ *
+ * Comments in front of a part stay in front of the statement made from it,
+ * so full-line comments keep their column. The prefix is copied without its
+ * comments, a `"` comment would swallow the part after it. A part that
+ * follows its comma without a blank gets one, so that the period in place
+ * of the comma does not run into the next prefix.
+ *
+ * The offset map is a list of segments ordered by their expanded offset.
+ * A segment that continues the previous one in the original as well is
+ * merged into it, so the text between two chains is a single segment and a
+ * chain of n parts takes about 3n of them.
+ */
+
+#define MAX_WORD_LENGTH 24
+#define NONE UINT32_MAX
+
+typedef struct
+{
+    uint32_t expanded;
+    uint32_t original;
+    uint32_t length;
+} Segment;
+
+typedef Array(Segment) SegmentList;
+
+typedef Array(uint32_t) OffsetList;
+
+struct TSAbapChainExpansion
+{
+    const char* source;
+    uint32_t length;
+    Array(char) expanded;
+    SegmentList segments;
+    uint32_t chains;
+};
+
+typedef enum
+{
+    WORD_OTHER,
+    WORD_METHOD,
+    WORD_ENDMETHOD,
+    WORD_EXEC,
+    WORD_ENDEXEC,
+    WORD_DEFINE,
+    WORD_END_OF_DEFINITION,
+} WordKind;
+
+typedef struct
+{
+    const char* word;
+    WordKind kind;
+} Keyword;
+
+static const Keyword KEYWORDS[] = {
+        {"METHOD", WORD_METHOD},
+        {"ENDMETHOD", WORD_ENDMETHOD},
+        {"EXEC", WORD_EXEC},
+        {"ENDEXEC", WORD_ENDEXEC},
+        {"DEFINE", WORD_DEFINE},
+        {"END-OF-DEFINITION", WORD_END_OF_DEFINITION},
+};
+
+/** What the current statement held so far. */
+typedef struct
+{
+    /** The first character that is neither blank nor comment. */
+    uint32_t start;
+    uint32_t words;
+    WordKind kind;
+    /**
+     * The last word, only kept while skipping. The statement ends of native
+     * SQL and SQLScript are not periods, so what ends the region is found
+     * as the word in front of a period.
+     */
+    WordKind last;
+    /** A `METHOD` implemented `BY DATABASE PROCEDURE|FUNCTION`. */
+    bool database;
+    uint32_t colon;
+    uint32_t colons;
+    uint32_t parentheses;
+    /** The commas after the colon outside of parentheses. */
+    OffsetList commas;
+} Statement;
+
+typedef struct
+{
+    TSAbapChainExpansion* result;
+    /** The source is copied up to here. */
+    uint32_t copied;
+    /**
+     * The statement that ends a region left as it is: a macro definition,
+     * native SQL or an AMDP method body. WORD_OTHER outside of one.
+     */
+    WordKind skip_until;
+} Expander;
+
+static inline bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static void add_segment(TSAbapChainExpansion* self, uint32_t original,
+                        uint32_t length)
+{
+    if (length == 0) {
+        return;
+    }
+    // the expanded text is contiguous, only the original can jump
+    if (self->segments.size > 0) {
+        Segment* last = array_back(&self->segments);
+        if (last->original + last->length == original) {
+            last->length += length;
+            return;
+        }
+    }
+    array_push(&self->segments, ((Segment){
+                                        .expanded = self->expanded.size,
+                                        .original = original,
+                                        .length = length,
+                                }));
+}
+
+/** Appends original text. */
+static void copy(TSAbapChainExpansion* self, uint32_t original,
+                 uint32_t length)
+{
+    add_segment(self, original, length);
+    array_extend(&self->expanded, length, self->source + original);
+}
+
+/** Appends a character that replaces or stands in for an original one. */
+static void put(TSAbapChainExpansion* self, char c, uint32_t original)
+{
+    add_segment(self, original, 1);
+    array_push(&self->expanded, c);
+}
+
+static void copy_without_comments(TSAbapChainExpansion* self, uint32_t start,
+                                  uint32_t end)
+{
+    Scanner scanner = {.data = self->source, .length = end, .position = start};
+    uint32_t run = start;
+    while (scanner.position < end) {
+        char c = scanner.data[scanner.position];
+        if (c == '"' || (c == '*' && at_line_start(&scanner))) {
+            copy(self, run, scanner.position - run);
+            skip_line(&scanner);
+            run = scanner.position;
+        } else if (c == '\'' || c == '`') {
+            skip_literal(&scanner);
+        } else if (c == '|') {
+            skip_template(&scanner, 0);
+        } else {
+            scanner.position++;
+        }
+    }
+    copy(self, run, end - run);
+}
+
+static uint32_t skip_blanks_and_comments(const char* source, uint32_t start,
+                                         uint32_t end)
+{
+    Scanner scanner = {.data = source, .length = end, .position = start};
+    while (scanner.position < end) {
+        char c = scanner.data[scanner.position];
+        if (c == '"' || (c == '*' && at_line_start(&scanner))) {
+            skip_line(&scanner);
+        } else if (is_blank(c)) {
+            scanner.position++;
+        } else {
+            break;
+        }
+    }
+    return scanner.position;
+}
+
+/** Writes out the chained statement that ends with the period at `end`. */
+static void expand(Expander* expander, const Statement* statement,
+                   uint32_t end)
+{
+    TSAbapChainExpansion* self = expander->result;
+    copy(self, expander->copied, statement->start - expander->copied);
+
+    uint32_t part_start = statement->colon + 1;
+    for (uint32_t i = 0; i <= statement->commas.size; i++) {
+        bool last = i == statement->commas.size;
+        uint32_t part_end = last ? end : statement->commas.contents[i];
+        uint32_t content = part_start;
+        if (i > 0) {
+            content = skip_blanks_and_comments(self->source, part_start,
+                                               part_end);
+            if (content == part_start) {
+                put(self, ' ', part_start - 1);
+            }
+            copy(self, part_start, content - part_start);
+        }
+
+        // empty parts, e.g. of two commas in a row, are dropped
+        if (i == 0 || content < part_end) {
+            copy_without_comments(self, statement->start, statement->colon);
+            put(self, ' ', statement->colon);
+            copy(self, content, part_end - content);
+            if (!last) {
+                put(self, '.', part_end);
+            }
+        }
+        part_start = part_end + 1;
+    }
+
+    // the period is copied along with what follows it
+    expander->copied = end;
+    self->chains++;
+}
+
+static WordKind classify(const char* word)
+{
+    for (size_t i = 0; i < sizeof(KEYWORDS) / sizeof(KEYWORDS[0]); i++) {
+        if (strcmp(KEYWORDS[i].word, word) == 0) {
+            return KEYWORDS[i].kind;
+        }
+    }
+    return WORD_OTHER;
+}
+
+static void read_word(Scanner* scanner, Statement* statement, bool skipping)
+{
+    if (!skipping && statement->words > 0 &&
+        statement->kind != WORD_METHOD) {
+        while (scanner->position < scanner->length &&
+               is_word_char(scanner->data[scanner->position])) {
+            scanner->position++;
+        }
+        statement->words++;
+        return;
+    }
+
+    char word[MAX_WORD_LENGTH + 1];
+    uint32_t length = 0;
+    while (scanner->position < scanner->length &&
+           is_word_char(scanner->data[scanner->position])) {
+        unsigned char c = (unsigned char)scanner->data[scanner->position];
+        if (length < MAX_WORD_LENGTH) {
+            word[length++] = (char)toupper(c);
+        }
+        scanner->position++;
+    }
+    word[length] = '\0';
+
+    statement->last = classify(word);
+    if (statement->words++ == 0) {
+        statement->kind = statement->last;
+    } else if (statement->kind == WORD_METHOD) {
+        statement->database |= strcmp(word, "DATABASE") == 0;
+    }
+}
+
+static void end_statement(Expander* expander, const Statement* statement,
+                          uint32_t end)
+{
+    if (expander->skip_until != WORD_OTHER) {
+        if (statement->last == expander->skip_until) {
+            expander->skip_until = WORD_OTHER;
+        }
+        return;
+    }
+
+    if (statement->colons == 1 && statement->start < statement->colon) {
+        expand(expander, statement, end);
+    }
+
+    switch (statement->kind) {
+    case WORD_METHOD:
+        if (statement->database) {
+            expander->skip_until = WORD_ENDMETHOD;
+        }
+        break;
+    case WORD_EXEC:
+        expander->skip_until = WORD_ENDEXEC;
+        break;
+    case WORD_DEFINE:
+        expander->skip_until = WORD_END_OF_DEFINITION;
+        break;
+    default:
+        break;
+    }
+}
+
+static void reset_statement(Statement* statement)
+{
+    OffsetList commas = statement->commas;
+    array_clear(&commas);
+    *statement = (Statement){.start = NONE, .colon = NONE, .commas = commas};
+}
+
+static void expand_all(Expander* expander)
+{
+    TSAbapChainExpansion* self = expander->result;
+    Scanner scanner = {.data = self->source, .length = self->length};
+    Statement statement = {0};
+    reset_statement(&statement);
+
+    while (scanner.position < scanner.length) {
+        char c = scanner.data[scanner.position];
+        if (c == '"' || (c == '*' && at_line_start(&scanner))) {
+            skip_line(&scanner);
+            continue;
+        }
+        if (statement.start == NONE && !is_blank(c)) {
+            statement.start = scanner.position;
+        }
+
+        if (c == '\'' || c == '`') {
+            skip_literal(&scanner);
+        } else if (c == '|') {
+            skip_template(&scanner, 0);
+        } else if (is_word_char(c)) {
+            read_word(&scanner, &statement,
+                      expander->skip_until != WORD_OTHER);
+        } else if (c == '.') {
+            end_statement(expander, &statement, scanner.position);
+            reset_statement(&statement);
+            scanner.position++;
+        } else {
+            if (c == ':' && statement.colons++ == 0) {
+                statement.colon = scanner.position;
+            } else if (c == '(') {
+                statement.parentheses++;
+            } else if (c == ')') {
+                statement.parentheses -= statement.parentheses > 0;
+            } else if (c == ',' && statement.colons > 0 &&
+                       statement.parentheses == 0) {
+                array_push(&statement.commas, scanner.position);
+            }
+            scanner.position++;
+        }
+    }
+    array_delete(&statement.commas);
+}
+
+TSAbapChainExpansion* tree_sitter_abap_expand_chains(const char* source,
+                                                     uint32_t length)
+{
+    TSAbapChainExpansion* self = calloc(1, sizeof(TSAbapChainExpansion));
+    if (!self) {
+        return NULL;
+    }
+    self->source = source;
+    self->length = length;
+
+    Expander expander = {.result = self};
+    expand_all(&expander);
+    if (self->chains == 0) {
+        array_delete(&self->expanded);
+        array_delete(&self->segments);
+        return self;
+    }
+    copy(self, expander.copied, length - expander.copied);
+    return self;
+}
+
+void tree_sitter_abap_chain_expansion_delete(TSAbapChainExpansion* self)
+{
+    if (!self) {
+        return;
+    }
+    array_delete(&self->expanded);
+    array_delete(&self->segments);
+    free(self);
+}
+
+const char* tree_sitter_abap_chain_expansion_source(
+        const TSAbapChainExpansion* self, uint32_t* length)
+{
+    if (self->chains == 0) {
+        *length = self->length;
+        return self->source;
+    }
+    *length = self->expanded.size;
+    return self->expanded.contents;
+}
+
+uint32_t tree_sitter_abap_chain_expansion_chain_count(
+        const TSAbapChainExpansion* self)
+{
+    return self->chains;
+}
+
+uint32_t tree_sitter_abap_chain_expansion_segment_count(
+        const TSAbapChainExpansion* self)
+{
+    return self->segments.size;
+}
+
+uint32_t tree_sitter_abap_chain_expansion_original_byte(
+        const TSAbapChainExpansion* self, uint32_t byte)
+{
+    if (self->chains == 0) {
+        return byte < self->length ? byte : self->length;
+    }
+    if (byte >= self->expanded.size) {
+        return self->length;
+    }
+
+    // the last segment that starts at or before the byte
+    uint32_t low = 0;
+    uint32_t high = self->segments.size;
+    while (high - low > 1) {
+        uint32_t middle = low + (high - low) / 2;
+        if (self->segments.contents[middle].expanded <= byte) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    const Segment* segment = &self->segments.contents[low];
+    return segment->original + (byte - segment->expanded);
+}
+
+void tree_sitter_abap_chain_expansion_original_range(
+        const TSAbapChainExpansion* self, TSNode node, uint32_t* start_byte,
+        uint32_t* end_byte)
+{
+    uint32_t start = ts_node_start_byte(node);
+    uint32_t end = ts_node_end_byte(node);
+    *start_byte = tree_sitter_abap_chain_expansion_original_byte(self, start);
+    *end_byte = *start_byte;
+    if (end > start) {
+        uint32_t last =
+                tree_sitter_abap_chain_expansion_original_byte(self, end - 1);
+        if (last >= *start_byte) {
+            *end_byte = last + 1;
+        }
+    }
+}
@@ -0,0 +1,529 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-abap-chunked.h"
+#include "source_scanner.h"
+#include "tree_sitter/array.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Chunked parsing.
+ *
+ * Splitting happens in one pass over the source that only knows enough of
+ * ABAP to find statement ends: comments, text and string literals and
+ * string templates with their embedded expressions are skipped, every other
+ * period ends a statement. The first word of each statement tracks the
+ * nesting of the blocks ended by ENDCLASS, ENDINTERFACE, ENDFORM,
+ * ENDFUNCTION, ENDMODULE and ENDMETHOD, and of macro definitions, whose
+ * bodies are skipped as a whole. Only the starts of reserved statements at
+ * nesting 0 are boundaries, the grammar never nests those in one another,
+ * so a chunk ending right before one parses to the same top-level nodes as
+ * the whole source does.
+ *
+ * A method implementation is not a boundary even though it is a reserved
+ * statement: it is nested in its class implementation, which would be torn
+ * apart. A single huge class therefore stays a single chunk.
+ *
+ * The chunks are handed to the workers in order from a shared counter,
+ * there are about four per thread so that a slow chunk does not hold up the
+ * others. Every chunk is parsed over the whole source with its range as the
+ * only included range, tree-sitter reads the source in place through a
+ * `TSInput`, nothing is copied.
+ */
+
+#define DEFAULT_MIN_CHUNK_BYTES (1024u * 1024u)
+#define CHUNKS_PER_THREAD 4
+#define MAX_WORD_LENGTH 24
+
+struct TSAbapChunkedTree
+{
+    const char* source;
+    uint32_t length;
+    void* mapping;
+    size_t mapping_length;
+    TSRange* ranges;
+    TSTree** trees;
+    uint32_t count;
+};
+
+typedef Array(TSRange) RangeList;
+
+typedef enum
+{
+    WORD_OTHER,
+    WORD_CLASS,
+    WORD_INTERFACE,
+    WORD_BLOCK,
+    WORD_METHOD,
+    WORD_BLOCK_END,
+    WORD_EVENT,
+    WORD_AT,
+    WORD_DEFINE,
+    WORD_END_OF_DEFINITION,
+} WordKind;
+
+typedef struct
+{
+    const char* word;
+    WordKind kind;
+} Keyword;
+
+static const Keyword KEYWORDS[] = {
+        {"CLASS", WORD_CLASS},
+        {"INTERFACE", WORD_INTERFACE},
+        {"FORM", WORD_BLOCK},
+        {"FUNCTION", WORD_BLOCK},
+        {"MODULE", WORD_BLOCK},
+        {"METHOD", WORD_METHOD},
+        {"ENDCLASS", WORD_BLOCK_END},
+        {"ENDINTERFACE", WORD_BLOCK_END},
+        {"ENDFORM", WORD_BLOCK_END},
+        {"ENDFUNCTION", WORD_BLOCK_END},
+        {"ENDMODULE", WORD_BLOCK_END},
+        {"ENDMETHOD", WORD_BLOCK_END},
+        {"INITIALIZATION", WORD_EVENT},
+        {"START-OF-SELECTION", WORD_EVENT},
+        {"LOAD-OF-PROGRAM", WORD_EVENT},
+        {"AT", WORD_AT},
+        {"DEFINE", WORD_DEFINE},
+        {"END-OF-DEFINITION", WORD_END_OF_DEFINITION},
+};
+
+/** What the words of the current statement told so far. */
+typedef struct
+{
+    uint32_t start;
+    uint32_t words;
+    WordKind kind;
+    /** `CLASS` or `INTERFACE` with DEFERRED, LOAD or LOCAL FRIENDS. */
+    bool declaration_only;
+    /** `AT SELECTION-SCREEN`. */
+    bool selection_screen;
+    /** A colon right after the first word. */
+    bool chained;
+} Statement;
+
+typedef struct
+{
+    const char* source;
+    uint32_t length;
+    uint32_t target;
+    uint32_t min_chunk;
+    uint32_t depth;
+    bool in_macro;
+    RangeList ranges;
+    /** Newlines are counted up to here, see `point_at`. */
+    uint32_t counted;
+    uint32_t row;
+    uint32_t line_start;
+} Splitter;
+
+typedef struct
+{
+    TSAbapChunkedTree* tree;
+    pthread_mutex_t lock;
+    uint32_t next;
+} ChunkQueue;
+
+static WordKind classify(const char* word)
+{
+    for (size_t i = 0; i < sizeof(KEYWORDS) / sizeof(KEYWORDS[0]); i++) {
+        if (strcmp(KEYWORDS[i].word, word) == 0) {
+            return KEYWORDS[i].kind;
+        }
+    }
+    return WORD_OTHER;
+}
+
+/** Whether the words after the first one of the statement matter. */
+static inline bool wants_word(const Statement* statement)
+{
+    return statement->words == 0 || statement->kind == WORD_CLASS ||
+           statement->kind == WORD_INTERFACE ||
+           (statement->kind == WORD_AT && statement->words == 1);
+}
+
+static void read_word(Scanner* scanner, Statement* statement)
+{
+    if (!wants_word(statement)) {
+        while (scanner->position < scanner->length &&
+               is_word_char(scanner->data[scanner->position])) {
+            scanner->position++;
+        }
+        statement->words++;
+        return;
+    }
+
+    char word[MAX_WORD_LENGTH + 1];
+    uint32_t length = 0;
+    while (scanner->position < scanner->length &&
+           is_word_char(scanner->data[scanner->position])) {
+        unsigned char c = (unsigned char)scanner->data[scanner->position];
+        if (length < MAX_WORD_LENGTH) {
+            word[length++] = (char)toupper(c);
+        }
+        scanner->position++;
+    }
+    word[length] = '\0';
+
+    if (statement->words++ == 0) {
+        statement->kind = classify(word);
+    } else if (statement->kind == WORD_AT) {
+        statement->selection_screen = strcmp(word, "SELECTION-SCREEN") == 0;
+    } else {
+        statement->declaration_only |= strcmp(word, "DEFERRED") == 0 ||
+                                        strcmp(word, "LOAD") == 0 ||
+                                        strcmp(word, "FRIENDS") == 0;
+    }
+}
+
+static bool is_boundary(const Statement* statement)
+{
+    switch (statement->kind) {
+    case WORD_CLASS:
+    case WORD_INTERFACE:
+    case WORD_BLOCK:
+    case WORD_EVENT:
+        return true;
+    case WORD_AT:
+        return statement->selection_screen;
+    default:
+        return false;
+    }
+}
+
+/**
+ * The point of a byte offset. Offsets are asked for in increasing order, so
+ * the newlines are counted once and only up to where chunks end.
+ */
+static TSPoint point_at(Splitter* splitter, uint32_t offset)
+{
+    const char* source = splitter->source;
+    const char* newline;
+    while ((newline = memchr(source + splitter->counted, '\n',
+                             offset - splitter->counted))) {
+        splitter->row++;
+        splitter->line_start = (uint32_t)(newline - source) + 1;
+        splitter->counted = splitter->line_start;
+    }
+    splitter->counted = offset;
+    return (TSPoint){splitter->row, offset - splitter->line_start};
+}
+
+static void end_statement(Splitter* splitter, const Statement* statement)
+{
+    if (splitter->in_macro) {
+        splitter->in_macro = statement->kind != WORD_END_OF_DEFINITION;
+        return;
+    }
+    if (statement->chained) {
+        return;
+    }
+
+    if (splitter->depth == 0 && is_boundary(statement)) {
+        TSRange* last = array_back(&splitter->ranges);
+        if (statement->start - last->start_byte >= splitter->target &&
+            splitter->length - statement->start >= splitter->min_chunk) {
+            TSPoint start_point = point_at(splitter, statement->start);
+            last->end_byte = statement->start;
+            last->end_point = start_point;
+            TSRange next = {
+                    .start_byte = statement->start,
+                    .start_point = start_point,
+            };
+            array_push(&splitter->ranges, next);
+        }
+    }
+
+    switch (statement->kind) {
+    case WORD_CLASS:
+    case WORD_INTERFACE:
+        splitter->depth += !statement->declaration_only;
+        break;
+    case WORD_BLOCK:
+    case WORD_METHOD:
+        splitter->depth++;
+        break;
+    case WORD_BLOCK_END:
+        splitter->depth -= splitter->depth > 0;
+        break;
+    case WORD_DEFINE:
+        splitter->in_macro = true;
+        break;
+    default:
+        break;
+    }
+}
+
+static void split(Splitter* splitter)
+{
+    Scanner scanner = {.data = splitter->source, .length = splitter->length};
+    Statement statement = {0};
+
+    while (scanner.position < scanner.length) {
+        char c = scanner.data[scanner.position];
+        if (c == '"' || (c == '*' && at_line_start(&scanner))) {
+            skip_line(&scanner);
+        } else if (c == '\'' || c == '`') {
+            skip_literal(&scanner);
+        } else if (c == '|') {
+            skip_template(&scanner, 0);
+        } else if (is_word_char(c)) {
+            read_word(&scanner, &statement);
+        } else if (c == '.') {
+            scanner.position++;
+            end_statement(splitter, &statement);
+            // The next chunk starts right after the period, comments and
+            // ABAP Doc in front of the statement belong to it.
+            statement = (Statement){.start = scanner.position};
+        } else {
+            statement.chained |= c == ':' && statement.words == 1;
+            scanner.position++;
+        }
+    }
+}
+
+static uint32_t thread_count(const TSAbapChunkedOptions* options)
+{
+    uint32_t threads = options ? options->threads : 0;
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    return threads;
+}
+
+TSRange* tree_sitter_abap_chunk_ranges(const char* source, uint32_t length,
+                                       const TSAbapChunkedOptions* options,
+                                       uint32_t* count)
+{
+    Splitter splitter = {0};
+    splitter.min_chunk = options && options->min_chunk_bytes
+                                 ? options->min_chunk_bytes
+                                 : DEFAULT_MIN_CHUNK_BYTES;
+    uint32_t chunks = thread_count(options) * CHUNKS_PER_THREAD;
+    splitter.target = length / chunks;
+    if (splitter.target < splitter.min_chunk) {
+        splitter.target = splitter.min_chunk;
+    }
+
+    splitter.source = source;
+    splitter.length = length;
+    array_push(&splitter.ranges, ((TSRange){0}));
+    if (length >= 2 * (uint64_t)splitter.min_chunk) {
+        split(&splitter);
+    }
+    TSRange* last = array_back(&splitter.ranges);
+    last->end_byte = length;
+    last->end_point = point_at(&splitter, length);
+
+    *count = splitter.ranges.size;
+    return splitter.ranges.contents;
+}
+
+static const char* read_source(void* payload, uint32_t byte_index,
+                               TSPoint position, uint32_t* bytes_read)
+{
+    (void)position;
+    const TSAbapChunkedTree* tree = payload;
+    if (byte_index >= tree->length) {
+        *bytes_read = 0;
+        return "";
+    }
+    *bytes_read = tree->length - byte_index;
+    return tree->source + byte_index;
+}
+
+static void* run_worker(void* payload)
+{
+    ChunkQueue* queue = payload;
+    TSAbapChunkedTree* tree = queue->tree;
+    TSParser* parser = ts_parser_new();
+    ts_parser_set_language(parser, tree_sitter_abap());
+    TSInput input = {
+            .payload = tree,
+            .read = read_source,
+            .encoding = TSInputEncodingUTF8,
+    };
+
+    for (;;) {
+        pthread_mutex_lock(&queue->lock);
+        uint32_t index = queue->next++;
+        pthread_mutex_unlock(&queue->lock);
+        if (index >= tree->count) {
+            break;
+        }
+        ts_parser_set_included_ranges(parser, &tree->ranges[index], 1);
+        tree->trees[index] = ts_parser_parse(parser, NULL, input);
+    }
+
+    ts_parser_delete(parser);
+    return NULL;
+}
+
+/** Returns false, with nothing parsed, if the trees can not be allocated. */
+static bool parse_chunks(TSAbapChunkedTree* tree,
+                         const TSAbapChunkedOptions* options)
+{
+    tree->ranges = tree_sitter_abap_chunk_ranges(tree->source, tree->length,
+                                                 options, &tree->count);
+    tree->trees = calloc(tree->count, sizeof(TSTree*));
+    if (!tree->trees) {
+        tree->count = 0;
+        return false;
+    }
+
+    ChunkQueue queue = {.tree = tree};
+    pthread_mutex_init(&queue.lock, NULL);
+    uint32_t threads = thread_count(options);
+    if (threads > tree->count) {
+        threads = tree->count;
+    }
+
+    // The calling thread is one of the workers. It takes over the chunks of
+    // the threads that could not be started, down to parsing all of them.
+    pthread_t* workers = threads > 1 ? calloc(threads, sizeof(pthread_t))
+                                     : NULL;
+    uint32_t started = 1;
+    while (workers && started < threads &&
+           pthread_create(&workers[started], NULL, run_worker, &queue) == 0) {
+        started++;
+    }
+    run_worker(&queue);
+    for (uint32_t i = 1; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    pthread_mutex_destroy(&queue.lock);
+    return true;
+}
+
+TSAbapChunkedTree* tree_sitter_abap_parse_chunked(
+        const char* source, uint32_t length,
+        const TSAbapChunkedOptions* options)
+{
+    TSAbapChunkedTree* tree = calloc(1, sizeof(TSAbapChunkedTree));
+    if (!tree) {
+        return NULL;
+    }
+    tree->source = source;
+    tree->length = length;
+    if (!parse_chunks(tree, options)) {
+        tree_sitter_abap_chunked_tree_delete(tree);
+        return NULL;
+    }
+    return tree;
+}
+
+TSAbapChunkedTree* tree_sitter_abap_parse_chunked_file(
+        const char* path, const TSAbapChunkedOptions* options)
+{
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        fprintf(stderr, "failed to open %s\n", path);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size >= UINT32_MAX) {
+        fprintf(stderr, "cannot parse %s, unreadable or 4 GiB or larger\n",
+                path);
+        close(file);
+        return NULL;
+    }
+
+    TSAbapChunkedTree* tree = calloc(1, sizeof(TSAbapChunkedTree));
+    if (!tree) {
+        close(file);
+        return NULL;
+    }
+    tree->source = "";
+    if (info.st_size > 0) {
+        tree->mapping_length = (size_t)info.st_size;
+        tree->mapping = mmap(NULL, tree->mapping_length, PROT_READ,
+                             MAP_PRIVATE, file, 0);
+        if (tree->mapping == MAP_FAILED) {
+            fprintf(stderr, "failed to map %s\n", path);
+            close(file);
+            free(tree);
+            return NULL;
+        }
+        // The splitter reads it front to back right away, then the chunks
+        // are read at once from all threads.
+        posix_madvise(tree->mapping, tree->mapping_length,
+                      POSIX_MADV_WILLNEED);
+        tree->source = tree->mapping;
+        tree->length = (uint32_t)info.st_size;
+    }
+    close(file);
+
+    if (!parse_chunks(tree, options)) {
+        fprintf(stderr, "out of memory parsing %s\n", path);
+        tree_sitter_abap_chunked_tree_delete(tree);
+        return NULL;
+    }
+    return tree;
+}
+
+void tree_sitter_abap_chunked_tree_delete(TSAbapChunkedTree* self)
+{
+    if (!self) {
+        return;
+    }
+    for (uint32_t i = 0; i < self->count; i++) {
+        ts_tree_delete(self->trees[i]);
+    }
+    if (self->mapping) {
+        munmap(self->mapping, self->mapping_length);
+    }
+    free(self->trees);
+    free(self->ranges);
+    free(self);
+}
+
+const char* tree_sitter_abap_chunked_tree_source(const TSAbapChunkedTree* self,
+                                                 uint32_t* length)
+{
+    *length = self->length;
+    return self->source;
+}
+
+uint32_t tree_sitter_abap_chunked_tree_chunk_count(
+        const TSAbapChunkedTree* self)
+{
+    return self->count;
+}
+
+const TSTree* tree_sitter_abap_chunked_tree_chunk(
+        const TSAbapChunkedTree* self, uint32_t index)
+{
+    return index < self->count ? self->trees[index] : NULL;
+}
+
+TSNode tree_sitter_abap_chunked_tree_descendant_for_byte_range(
+        const TSAbapChunkedTree* self, uint32_t start, uint32_t end)
+{
+    // The last chunk starting at or before `start`.
+    uint32_t low = 0;
+    uint32_t high = self->count;
+    while (high - low > 1) {
+        uint32_t middle = low + (high - low) / 2;
+        if (self->ranges[middle].start_byte <= start) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    TSNode root = ts_tree_root_node(self->trees[low]);
+    if (end > self->ranges[low].end_byte) {
+        return root;
+    }
+    return ts_node_descendant_for_byte_range(root, start, end);
+}
@@ -0,0 +1,234 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-abap-bulk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Parses whole directories, e.g. an abapGit export, on all cores. Prints one
+ * JSON line per file as it completes and a JSON summary on stderr.
+ */
+
+static void usage(FILE* out)
+{
+    fprintf(out,
+            "usage: abap-bulk [options] path...\n"
+            "\n"
+            "Parses every *.abap file below the given directories and the\n"
+            "given files, prints one JSON line per file and a summary.\n"
+            "\n"
+            "  --threads N         worker threads (default: one per cpu)\n"
+            "  --timeout-ms N      cancel parses taking longer than N ms\n"
+            "  --query FILE        run the query over every tree and count\n"
+            "                      its captures, e.g. queries/highlights.scm\n"
+            "  --cache DIR         take unchanged files from the parse result\n"
+            "                      cache in DIR and store the others\n"
+            "  --cache-size SIZE   size limit of the cache, e.g. 512m or 4g\n"
+            "                      (default: none)\n"
+            "  --output FILE       write the file lines to FILE instead of\n"
+            "                      stdout\n"
+            "  --summary-only      only print the summary\n"
+            "  --scanner-stats     add the scanner counters to every line\n"
+            "                      and the summary, needs a build with\n"
+            "                      SCANNER_STATS=1\n");
+}
+
+static char* read_query(const char* path, uint32_t* length)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (data && fread(data, 1, (size_t)size, file) == (size_t)size) {
+        data[size] = '\0';
+        *length = (uint32_t)size;
+    } else {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+/** A byte count with an optional k, m or g suffix. */
+static uint64_t parse_size(const char* text)
+{
+    char* suffix = NULL;
+    uint64_t value = strtoull(text, &suffix, 10);
+    if (*suffix == 'k' || *suffix == 'K') {
+        value *= 1024;
+    } else if (*suffix == 'm' || *suffix == 'M') {
+        value *= 1024 * 1024;
+    } else if (*suffix == 'g' || *suffix == 'G') {
+        value *= 1024 * 1024 * 1024;
+    }
+    return value;
+}
+
+static void json_string(FILE* out, const char* value)
+{
+    putc_unlocked('"', out);
+    for (const char* c = value; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            putc_unlocked('\\', out);
+            putc_unlocked(*c, out);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(out, "\\u%04x", *c);
+        } else {
+            putc_unlocked(*c, out);
+        }
+    }
+    putc_unlocked('"', out);
+}
+
+/** Called concurrently from the workers, the stream lock keeps lines whole. */
+static void print_file(void* payload, uint32_t index,
+                       const TSAbapBulkFileResult* result)
+{
+    (void)index;
+    FILE* out = payload;
+    flockfile(out);
+    fprintf(out, "{\"path\": ");
+    json_string(out, result->path);
+    fprintf(out,
+            ", \"bytes\": %llu, \"parse_ns\": %llu, \"nodes\": %u, "
+            "\"errors\": %u, \"missing\": %u, \"max_depth\": %u, "
+            "\"captures\": %llu, \"timed_out\": %s, \"unreadable\": %s, "
+            "\"cached\": %s",
+            (unsigned long long)result->bytes,
+            (unsigned long long)result->parse_ns, result->nodes,
+            result->errors, result->missing, result->max_depth,
+            (unsigned long long)result->captures,
+            result->timed_out ? "true" : "false",
+            result->unreadable ? "true" : "false",
+            result->cached ? "true" : "false");
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+    if (result->scanner_stats) {
+        fprintf(out, ", \"scanner\": ");
+        tree_sitter_abap_scanner_stats_write_json(result->scanner_stats, out);
+    }
+#endif
+    fprintf(out, "}\n");
+    funlockfile(out);
+}
+
+int main(int argc, char** argv)
+{
+    TSAbapBulkOptions options = {0};
+    const char* query_path = NULL;
+    const char* output_path = NULL;
+    bool summary_only = false;
+    TSAbapScannerStats* scanner_stats = NULL;
+    const char** paths = calloc((size_t)argc, sizeof(char*));
+    uint32_t path_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--timeout-ms") == 0 && i + 1 < argc) {
+            options.timeout_micros = strtoull(argv[++i], NULL, 10) * 1000;
+        } else if (strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            query_path = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            options.cache_directory = argv[++i];
+        } else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            options.cache_max_bytes = parse_size(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--summary-only") == 0) {
+            summary_only = true;
+        } else if (strcmp(argv[i], "--scanner-stats") == 0) {
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+            scanner_stats = calloc(1, sizeof(TSAbapScannerStats));
+            options.scanner_stats = scanner_stats;
+#else
+            fprintf(stderr, "built without TREE_SITTER_ABAP_SCANNER_STATS, "
+                            "rebuild with SCANNER_STATS=1\n");
+            return 1;
+#endif
+        } else if (strcmp(argv[i], "--help") == 0) {
+            usage(stdout);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage(stderr);
+            return 1;
+        } else {
+            paths[path_count++] = argv[i];
+        }
+    }
+    if (path_count == 0) {
+        usage(stderr);
+        return 1;
+    }
+
+    char* query = NULL;
+    if (query_path) {
+        query = read_query(query_path, &options.query_length);
+        if (!query) {
+            fprintf(stderr, "failed to read %s\n", query_path);
+            return 1;
+        }
+        options.query = query;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "failed to open %s\n", output_path);
+        return 1;
+    }
+    if (!summary_only) {
+        options.callback = print_file;
+        options.payload = out;
+    }
+
+    TSAbapBulkSummary summary;
+    bool ok = tree_sitter_abap_bulk_parse(paths, path_count, &options,
+                                          &summary);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    if (ok) {
+        double seconds = summary.wall_ns / 1e9;
+        fprintf(stderr,
+                "{\"files\": %u, \"bytes\": %llu, \"wall_ns\": %llu, "
+                "\"parse_ns\": %llu, \"mb_per_s\": %.3f, "
+                "\"files_with_errors\": %u, \"timed_out\": %u, "
+                "\"unreadable\": %u, \"stolen\": %u",
+                summary.files, (unsigned long long)summary.bytes,
+                (unsigned long long)summary.wall_ns,
+                (unsigned long long)summary.parse_ns,
+                seconds > 0 ? summary.bytes / (1024.0 * 1024.0) / seconds
+                            : 0.0,
+                summary.files_with_errors, summary.timed_out,
+                summary.unreadable, summary.stolen);
+        if (options.cache_directory) {
+            uint32_t read = summary.files - summary.unreadable;
+            fprintf(stderr,
+                    ", \"cache_hits\": %u, \"cache_hit_rate\": %.4f, "
+                    "\"cache_lookup_ns\": %llu, \"cache_stores\": %u, "
+                    "\"cache_evictions\": %u",
+                    summary.cache_hits,
+                    read ? (double)summary.cache_hits / read : 0.0,
+                    (unsigned long long)summary.cache_lookup_ns,
+                    summary.cache_stores, summary.cache_evictions);
+        }
+#ifdef TREE_SITTER_ABAP_SCANNER_STATS
+        if (scanner_stats) {
+            fprintf(stderr, ", \"scanner\": ");
+            tree_sitter_abap_scanner_stats_write_json(scanner_stats, stderr);
+        }
+#endif
+        fprintf(stderr, "}\n");
+    }
+
+    free(scanner_stats);
+    free(query);
+    free(paths);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,455 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tree_sitter/tree-sitter-abap-cst.h"
+#include "tree_sitter/tree-sitter-abap.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The CST format, see tree-sitter-abap-cst.h.
+ *
+ * The columns are read and written as native arrays, which is why only
+ * little-endian hosts are supported. Opening a file checks the header and
+ * that every parent, child and sibling index points the way pre-order
+ * requires, so that traversals cannot leave the node table. Nothing else is
+ * read up front.
+ */
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the CST format is little-endian, big-endian hosts are not supported"
+#endif
+
+#define MAGIC "ABAPCST"
+#define FLAG_SOURCE 1u
+#define NONE TREE_SITTER_ABAP_CST_NONE
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t grammar_hash;
+    uint32_t node_count;
+    uint32_t source_length;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t file_size;
+    uint64_t reserved_end[2];
+} Header;
+
+_Static_assert(sizeof(Header) == 64, "the header is 64 bytes");
+
+typedef enum
+{
+    COLUMN_SYMBOL,
+    COLUMN_FIELD,
+    COLUMN_FLAGS,
+    COLUMN_START_BYTE,
+    COLUMN_END_BYTE,
+    COLUMN_START_ROW,
+    COLUMN_START_COLUMN,
+    COLUMN_END_ROW,
+    COLUMN_END_COLUMN,
+    COLUMN_PARENT,
+    COLUMN_FIRST_CHILD,
+    COLUMN_NEXT_SIBLING,
+    COLUMN_COUNT,
+} Column;
+
+#define FIRST_WIDE_COLUMN COLUMN_START_BYTE
+
+typedef struct
+{
+    size_t columns[COLUMN_COUNT];
+    size_t source;
+    size_t size;
+} Layout;
+
+struct TSAbapCst
+{
+    TSAbapCstColumns columns;
+    void* mapping;
+    size_t mapping_length;
+};
+
+static size_t align8(size_t offset)
+{
+    return (offset + 7) & ~(size_t)7;
+}
+
+static Layout layout_for(uint32_t node_count, uint32_t source_length,
+                         bool embed_source)
+{
+    Layout layout;
+    size_t offset = sizeof(Header);
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+        size_t width = column < FIRST_WIDE_COLUMN ? sizeof(uint16_t)
+                                                  : sizeof(uint32_t);
+        layout.columns[column] = offset;
+        offset = align8(offset + width * node_count);
+    }
+    layout.source = embed_source ? offset : 0;
+    layout.size = embed_source ? offset + source_length : offset;
+    return layout;
+}
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t length)
+{
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t tree_sitter_abap_cst_grammar_hash(const TSLanguage* language)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    uint32_t symbol_count = ts_language_symbol_count(language);
+    for (uint32_t i = 0; i < symbol_count; i++) {
+        const char* name = ts_language_symbol_name(language, (TSSymbol)i);
+        TSSymbolType type = ts_language_symbol_type(language, (TSSymbol)i);
+        unsigned char flags = (type == TSSymbolTypeRegular) |
+                              (type <= TSSymbolTypeAnonymous) << 1;
+        hash = fnv1a(hash, name ? name : "", name ? strlen(name) + 1 : 1);
+        hash = fnv1a(hash, &flags, 1);
+    }
+    hash = fnv1a(hash, "\xff", 1);
+    uint32_t field_count = ts_language_field_count(language);
+    for (uint32_t i = 1; i <= field_count; i++) {
+        const char* name =
+                ts_language_field_name_for_id(language, (TSFieldId)i);
+        hash = fnv1a(hash, name ? name : "", name ? strlen(name) + 1 : 1);
+    }
+    return hash;
+}
+
+void* tree_sitter_abap_cst_serialize(const TSTree* tree, const char* source,
+                                     uint32_t length, size_t* size)
+{
+    TSNode root = ts_tree_root_node(tree);
+    uint32_t node_count = ts_node_descendant_count(root);
+    Layout layout = layout_for(node_count, length, source != NULL);
+    char* buffer = calloc(1, layout.size);
+    // The node at each depth of the cursor and its last child so far.
+    uint32_t* path = malloc(2 * 64 * sizeof(uint32_t));
+    if (!buffer || !path) {
+        free(buffer);
+        free(path);
+        return NULL;
+    }
+
+    Header header = {
+            .magic = MAGIC,
+            .version = TREE_SITTER_ABAP_CST_VERSION,
+            .header_size = sizeof(Header),
+            .grammar_hash = tree_sitter_abap_cst_grammar_hash(
+                    ts_tree_language(tree)),
+            .node_count = node_count,
+            .source_length = length,
+            .flags = source ? FLAG_SOURCE : 0,
+            .file_size = layout.size,
+    };
+    memcpy(buffer, &header, sizeof(header));
+    if (source) {
+        memcpy(buffer + layout.source, source, length);
+    }
+
+    uint16_t* narrow[FIRST_WIDE_COLUMN];
+    uint32_t* wide[COLUMN_COUNT];
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+        if (column < FIRST_WIDE_COLUMN) {
+            narrow[column] = (uint16_t*)(buffer + layout.columns[column]);
+        } else {
+            wide[column] = (uint32_t*)(buffer + layout.columns[column]);
+        }
+    }
+
+    uint32_t capacity = 64;
+    uint32_t depth = 0;
+    uint32_t index = 0;
+    TSTreeCursor cursor = ts_tree_cursor_new(root);
+    for (;; index++) {
+        TSNode node = ts_tree_cursor_current_node(&cursor);
+        TSPoint start = ts_node_start_point(node);
+        TSPoint end = ts_node_end_point(node);
+        uint32_t parent = depth ? path[2 * (depth - 1)] : NONE;
+        uint32_t previous = depth ? path[2 * (depth - 1) + 1] : NONE;
+
+        narrow[COLUMN_SYMBOL][index] = ts_node_symbol(node);
+        narrow[COLUMN_FIELD][index] = ts_tree_cursor_current_field_id(&cursor);
+        narrow[COLUMN_FLAGS][index] =
+                (ts_node_is_named(node) ? TREE_SITTER_ABAP_CST_NAMED : 0) |
+                (ts_node_is_error(node) ? TREE_SITTER_ABAP_CST_ERROR : 0) |
+                (ts_node_is_missing(node) ? TREE_SITTER_ABAP_CST_MISSING
+                                          : 0) |
+                (ts_node_is_extra(node) ? TREE_SITTER_ABAP_CST_EXTRA : 0) |
+                (ts_node_has_error(node) ? TREE_SITTER_ABAP_CST_HAS_ERROR
+                                         : 0);
+        wide[COLUMN_START_BYTE][index] = ts_node_start_byte(node);
+        wide[COLUMN_END_BYTE][index] = ts_node_end_byte(node);
+        wide[COLUMN_START_ROW][index] = start.row;
+        wide[COLUMN_START_COLUMN][index] = start.column;
+        wide[COLUMN_END_ROW][index] = end.row;
+        wide[COLUMN_END_COLUMN][index] = end.column;
+        wide[COLUMN_PARENT][index] = parent;
+        wide[COLUMN_FIRST_CHILD][index] = NONE;
+        wide[COLUMN_NEXT_SIBLING][index] = NONE;
+        if (previous != NONE) {
+            wide[COLUMN_NEXT_SIBLING][previous] = index;
+        } else if (parent != NONE) {
+            wide[COLUMN_FIRST_CHILD][parent] = index;
+        }
+        if (depth) {
+            path[2 * (depth - 1) + 1] = index;
+        }
+
+        if (depth == capacity) {
+            capacity *= 2;
+            uint32_t* grown = realloc(path, 2 * capacity * sizeof(uint32_t));
+            if (!grown) {
+                ts_tree_cursor_delete(&cursor);
+                free(path);
+                free(buffer);
+                return NULL;
+            }
+            path = grown;
+        }
+        path[2 * depth] = index;
+        path[2 * depth + 1] = NONE;
+
+        if (ts_tree_cursor_goto_first_child(&cursor)) {
+            depth++;
+            continue;
+        }
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                free(path);
+                *size = layout.size;
+                return buffer;
+            }
+            depth--;
+        }
+    }
+}
+
+bool tree_sitter_abap_cst_write_file(const char* path, const TSTree* tree,
+                                     const char* source, uint32_t length)
+{
+    size_t size;
+    void* buffer = tree_sitter_abap_cst_serialize(tree, source, length, &size);
+    if (!buffer) {
+        fprintf(stderr, "out of memory serializing %s\n", path);
+        return false;
+    }
+    FILE* out = fopen(path, "wb");
+    bool ok = out && fwrite(buffer, 1, size, out) == size;
+    if (out) {
+        ok &= fclose(out) == 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "failed to write %s\n", path);
+    }
+    free(buffer);
+    return ok;
+}
+
+/**
+ * Whether the links stay within the nodes and the symbol and field ids are
+ * ids of the language, so that readers can index tables with them. A
+ * matching grammar hash does not rule out a corrupted or crafted file.
+ */
+static bool check_columns(const TSAbapCstColumns* columns,
+                          const TSLanguage* language)
+{
+    uint32_t count = columns->node_count;
+    uint32_t symbol_count = ts_language_symbol_count(language);
+    uint32_t field_count = ts_language_field_count(language);
+    if (columns->parent[0] != NONE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t parent = columns->parent[i];
+        uint32_t child = columns->first_child[i];
+        uint32_t sibling = columns->next_sibling[i];
+        TSSymbol symbol = columns->symbol[i];
+        if ((i > 0 && parent >= i) ||
+            (child != NONE && child != i + 1) ||
+            (sibling != NONE && (sibling <= i || sibling >= count)) ||
+            // ERROR nodes have the symbol (TSSymbol)-1
+            (symbol >= symbol_count && symbol != (TSSymbol)-1) ||
+            columns->field[i] > field_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TSAbapCst* tree_sitter_abap_cst_from_buffer(const void* data, size_t size,
+                                            TSAbapCstStatus* status)
+{
+    const char* bytes = data;
+    Header header;
+    if (size < sizeof(Header) || (uintptr_t)data % sizeof(uint32_t)) {
+        *status = TREE_SITTER_ABAP_CST_BAD_FORMAT;
+        return NULL;
+    }
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+        *status = TREE_SITTER_ABAP_CST_BAD_FORMAT;
+        return NULL;
+    }
+    if (header.version != TREE_SITTER_ABAP_CST_VERSION) {
+        *status = TREE_SITTER_ABAP_CST_BAD_VERSION;
+        return NULL;
+    }
+    if (header.grammar_hash !=
+        tree_sitter_abap_cst_grammar_hash(tree_sitter_abap())) {
+        *status = TREE_SITTER_ABAP_CST_STALE;
+        return NULL;
+    }
+    Layout layout = layout_for(header.node_count, header.source_length,
+                               header.flags & FLAG_SOURCE);
+    if (header.header_size != sizeof(Header) || header.node_count == 0 ||
+        header.file_size != size || layout.size != size) {
+        *status = TREE_SITTER_ABAP_CST_BAD_FORMAT;
+        return NULL;
+    }
+
+    TSAbapCst* self = calloc(1, sizeof(TSAbapCst));
+    if (!self) {
+        *status = TREE_SITTER_ABAP_CST_IO_ERROR;
+        return NULL;
+    }
+    const size_t* at = layout.columns;
+    self->columns = (TSAbapCstColumns){
+            .node_count = header.node_count,
+            .symbol = (const uint16_t*)(bytes + at[COLUMN_SYMBOL]),
+            .field = (const uint16_t*)(bytes + at[COLUMN_FIELD]),
+            .flags = (const uint16_t*)(bytes + at[COLUMN_FLAGS]),
+            .start_byte = (const uint32_t*)(bytes + at[COLUMN_START_BYTE]),
+            .end_byte = (const uint32_t*)(bytes + at[COLUMN_END_BYTE]),
+            .start_row = (const uint32_t*)(bytes + at[COLUMN_START_ROW]),
+            .start_column = (const uint32_t*)(bytes + at[COLUMN_START_COLUMN]),
+            .end_row = (const uint32_t*)(bytes + at[COLUMN_END_ROW]),
+            .end_column = (const uint32_t*)(bytes + at[COLUMN_END_COLUMN]),
+            .parent = (const uint32_t*)(bytes + at[COLUMN_PARENT]),
+            .first_child = (const uint32_t*)(bytes + at[COLUMN_FIRST_CHILD]),
+            .next_sibling = (const uint32_t*)(bytes + at[COLUMN_NEXT_SIBLING]),
+            .source = layout.source ? bytes + layout.source : NULL,
+            .source_length = header.source_length,
+    };
+    if (!check_columns(&self->columns, tree_sitter_abap())) {
+        free(self);
+        *status = TREE_SITTER_ABAP_CST_BAD_FORMAT;
+        return NULL;
+    }
+    *status = TREE_SITTER_ABAP_CST_OK;
+    return self;
+}
+
+TSAbapCst* tree_sitter_abap_cst_open(const char* path,
+                                     TSAbapCstStatus* status)
+{
+    int file = open(path, O_RDONLY);
+    struct stat info;
+    if (file < 0 || fstat(file, &info) != 0) {
+        if (file >= 0) {
+            close(file);
+        }
+        *status = TREE_SITTER_ABAP_CST_IO_ERROR;
+        return NULL;
+    }
+    if ((size_t)info.st_size < sizeof(Header)) {
+        close(file);
+        *status = TREE_SITTER_ABAP_CST_BAD_FORMAT;
+        return NULL;
+    }
+    size_t length = (size_t)info.st_size;
+    void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED) {
+        *status = TREE_SITTER_ABAP_CST_IO_ERROR;
+        return NULL;
+    }
+
+    TSAbapCst* self = tree_sitter_abap_cst_from_buffer(mapping, length, status);
+    if (!self) {
+        munmap(mapping, length);
+        return NULL;
+    }
+    self->mapping = mapping;
+    self->mapping_length = length;
+    return self;
+}
+
+void tree_sitter_abap_cst_close(TSAbapCst* self)
+{
+    if (!self) {
+        return;
+    }
+    if (self->mapping) {
+        munmap(self->mapping, self->mapping_length);
+    }
+    free(self);
+}
+
+const TSAbapCstColumns* tree_sitter_abap_cst_columns(const TSAbapCst* self)
+{
+    return &self->columns;
+}
+
+uint32_t tree_sitter_abap_cst_subtree_end(const TSAbapCst* self,
+                                          uint32_t node)
+{
+    const TSAbapCstColumns* columns = &self->columns;
+    for (uint32_t i = node; i != NONE; i = columns->parent[i]) {
+        if (columns->next_sibling[i] != NONE) {
+            return columns->next_sibling[i];
+        }
+    }
+    return columns->node_count;
+}
+
+uint32_t tree_sitter_abap_cst_find_symbol(const TSAbapCst* self,
+                                          TSSymbol symbol, uint32_t from,
+                                          uint32_t end)
+{
+    const uint16_t* symbols = self->columns.symbol;
+    if (end > self->columns.node_count) {
+        end = self->columns.node_count;
+    }
+    for (uint32_t i = from; i < end; i++) {
+        if (symbols[i] == symbol) {
+            return i;
+        }
+    }
+    return NONE;
+}
+
+uint32_t tree_sitter_abap_cst_descendant_for_byte_range(const TSAbapCst* self,
+                                                        uint32_t start,
+                                                        uint32_t end)
+{
+    const TSAbapCstColumns* columns = &self->columns;
+    uint32_t node = 0;
+    for (;;) {
+        uint32_t child = columns->first_child[node];
+        while (child != NONE &&
+               !(columns->start_byte[child] <= start &&
+                 end <= columns->end_byte[child] &&
+                 columns->end_byte[child] > columns->start_byte[child])) {
+            child = columns->next_sibling[child];
+        }
+        if (child == NONE) {
+            return node;
+        }
+        node = child;
+    }
+}
@@ -0,0 +1,116 @@
+#include "tree_sitter/tree-sitter-abap-doc.h"
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * ABAP Doc text, see tree-sitter-abap-doc.h.
+ *
+ * Writing never overtakes reading, every escape and line break is at least
+ * as long as what it is replaced with, so the text can be decoded in place.
+ */
+
+typedef struct
+{
+    const char* name;
+    char value;
+} Entity;
+
+static const Entity entities[] = {
+        {"quot", '"'},
+        {"apos", '\''},
+        {"lt", '<'},
+        {"gt", '>'},
+        {"amp", '&'},
+};
+
+static bool is_blank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * Decodes the escape at `text[*i]`, an `&`, and moves past it. Returns 0 if
+ * there is none, the `&` is then copied as it is.
+ */
+static char decode_entity(const char* text, uint32_t length, uint32_t* i)
+{
+    uint32_t start = *i + 1;
+    uint32_t end = start;
+    while (end < length && end - start < 8 && text[end] != ';') {
+        end++;
+    }
+    if (end >= length || text[end] != ';' || end == start) {
+        return 0;
+    }
+
+    uint32_t name_length = end - start;
+    if (text[start] == '#') {
+        uint32_t value = 0;
+        if (name_length == 1) {
+            return 0;
+        }
+        for (uint32_t j = start + 1; j < end; j++) {
+            if (text[j] < '0' || text[j] > '9') {
+                return 0;
+            }
+            value = value * 10 + (uint32_t)(text[j] - '0');
+        }
+        if (value == 0 || value >= 128) {
+            return 0;
+        }
+        *i = end + 1;
+        return (char)value;
+    }
+
+    for (size_t e = 0; e < sizeof(entities) / sizeof(Entity); e++) {
+        if (strlen(entities[e].name) == name_length &&
+            memcmp(entities[e].name, text + start, name_length) == 0) {
+            *i = end + 1;
+            return entities[e].value;
+        }
+    }
+    return 0;
+}
+
+uint32_t tree_sitter_abap_doc_text(const char* text, uint32_t length,
+                                   char* out)
+{
+    uint32_t written = 0;
+    uint32_t i = 0;
+
+    while (i < length) {
+        char c = text[i];
+        if (c == '\n' || c == '\r') {
+            while (written > 0 && is_blank(out[written - 1])) {
+                written--;
+            }
+            while (i < length && (text[i] == '\n' || text[i] == '\r' ||
+                                  is_blank(text[i]))) {
+                i++;
+            }
+            if (i + 1 < length && text[i] == '"' && text[i + 1] == '!') {
+                i += 2;
+            }
+            while (i < length && is_blank(text[i])) {
+                i++;
+            }
+            out[written++] = ' ';
+            continue;
+        }
+
+        if (c == '&') {
+            char decoded = decode_entity(text, length, &i);
+            if (decoded) {
+                out[written++] = decoded;
+                continue;
+            }
+        } else if (c == '\\' && i + 1 < length &&
+                   (text[i + 1] == '{' || text[i + 1] == '}')) {
+            i++;
+            c = text[i];
+        }
+        out[written++] = c;
+        i++;
+    }
+    return written;
+}
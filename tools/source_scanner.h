@@ -0,0 +1,116 @@
+#ifndef TREE_SITTER_ABAP_TOOLS_SOURCE_SCANNER_H_
+#define TREE_SITTER_ABAP_TOOLS_SOURCE_SCANNER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Just enough of ABAP to find statement ends in a source without parsing
+ * it, shared by the tools that split or rewrite sources: comments, text and
+ * string literals and string templates with their embedded expressions are
+ * skipped as a whole.
+ */
+
+#define MAX_TEMPLATE_NESTING 32
+
+typedef struct
+{
+    const char* data;
+    uint32_t length;
+    uint32_t position;
+} Scanner;
+
+static inline bool at_line_start(const Scanner* scanner)
+{
+    return scanner->position == 0 ||
+           scanner->data[scanner->position - 1] == '\n';
+}
+
+static inline bool is_word_char(char c)
+{
+    char lower = (char)(c | 0x20);
+    return (lower >= 'a' && lower <= 'z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == '/';
+}
+
+static inline void skip_line(Scanner* scanner)
+{
+    const char* end = memchr(scanner->data + scanner->position, '\n',
+                             scanner->length - scanner->position);
+    scanner->position = end ? (uint32_t)(end - scanner->data)
+                            : scanner->length;
+}
+
+/** Text literals and backquoted strings, a doubled delimiter escapes. */
+static inline void skip_literal(Scanner* scanner)
+{
+    char delimiter = scanner->data[scanner->position];
+    scanner->position++;
+    while (scanner->position < scanner->length) {
+        char c = scanner->data[scanner->position];
+        if (c == '\n') {
+            return;
+        }
+        scanner->position++;
+        if (c == delimiter) {
+            if (scanner->position < scanner->length &&
+                scanner->data[scanner->position] == delimiter) {
+                scanner->position++;
+                continue;
+            }
+            return;
+        }
+    }
+}
+
+static inline void skip_template(Scanner* scanner, uint32_t nesting);
+
+static inline void skip_embedded_expression(Scanner* scanner,
+                                            uint32_t nesting)
+{
+    while (scanner->position < scanner->length) {
+        char c = scanner->data[scanner->position];
+        if (c == '}') {
+            scanner->position++;
+            return;
+        }
+        if (c == '"' ||
+            (c == '*' && at_line_start(scanner))) {
+            skip_line(scanner);
+        } else if (c == '\'' || c == '`') {
+            skip_literal(scanner);
+        } else if (c == '|' && nesting < MAX_TEMPLATE_NESTING) {
+            skip_template(scanner, nesting + 1);
+        } else {
+            scanner->position++;
+        }
+    }
+}
+
+/**
+ * String templates, the literal text ends at the line end while embedded
+ * expressions may span lines and contain templates themselves.
+ */
+static inline void skip_template(Scanner* scanner, uint32_t nesting)
+{
+    scanner->position++;
+    while (scanner->position < scanner->length) {
+        char c = scanner->data[scanner->position];
+        if (c == '\n') {
+            return;
+        }
+        scanner->position++;
+        if (c == '|') {
+            return;
+        }
+        if (c == '\\' && scanner->position < scanner->length &&
+            scanner->data[scanner->position] != '\n') {
+            scanner->position++;
+        } else if (c == '{') {
+            skip_embedded_expression(scanner, nesting);
+        }
+    }
+}
+
+#endif // TREE_SITTER_ABAP_TOOLS_SOURCE_SCANNER_H_